@@ -8,6 +8,9 @@
 */
 
 #include "IMU.h"
+#include "logger.h"
+#include "scope_profiler.h"
+#include "trace_recorder.h"
 
 
 
@@ -51,11 +54,11 @@ int16_t sum = 0;              ///< Keeps track of sum of all values during calib
 
         if(Wire.available() == 0)
         {
-            //Serial << "No Data Available" << endl;
+            LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
         }
         else
         {
-            //Serial << "Data Available from x-axis Accelerometer: " << Wire.available() << " Bytes" << endl;
+            LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
         }
 
         AcX_raw = Wire.read() << 8 | Wire.read() / 16384; ///< AcX_raw is the x-axis accelerometer reading adjusted for sensitivity, but without an offset applied
@@ -71,7 +74,7 @@ int16_t sum = 0;              ///< Keeps track of sum of all values during calib
     }
     
      pitch_offset_acc = sum/count; ///< Offset for pitch angle from accelerometer
-     Serial << "Acc Pitch Offset is: " << pitch_offset_acc << endl;
+     LOG_INFO(MOD_IMU, FMT_ACC_PITCH_OFFSET, pitch_offset_acc);
     return pitch_offset_acc;
 
 }
@@ -79,8 +82,7 @@ int16_t sum = 0;              ///< Keeps track of sum of all values during calib
 
 /** @brief  Function that will return the corrected pitch axis position from the accelerometer
  *  @details This function reads the necessary values from the register, computes the pitch angle, and applies
- *           the calibration offset found in the previous function. It then places the pitch angle value in a share
- *           that is used in the main file.
+ *           the calibration offset found in the previous function.
  *  @param MPU_ADDR Address of IMU peripheral          
 */
 
@@ -96,12 +98,12 @@ Wire.requestFrom(MPU_ADDR, 6);
 
 if(Wire.available() == 0)
 {
-    //Serial << "No Data Available" << endl;
+    LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
 
 }
 else
 {
-    //Serial << "Data Available from x-axis Accelerometer" << endl;
+    LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
 }
 
 AcX_raw = Wire.read() << 8 | Wire.read() / 16384; 
@@ -110,13 +112,12 @@ AcZ_raw = Wire.read() << 8 | Wire.read() / 16384;
 
 Wire.endTransmission(true);
 
-//Serial << AcX << endl;
+LOG_TRACE(MOD_IMU, FMT_IMU_RAW_ACC, AcX_raw, AcY_raw, AcZ_raw);
 
 int16_t pitch_acc = (atan(-1 * AcX_raw / sqrt(pow(AcY_raw, 2) + pow(AcZ_raw, 2))) * 180 / PI) - pitch_offset_acc; ///< pitch_acc is the pitch angle reading from the accelerometer with the offset applied
 
-//Serial << "Pitch angle from Accelerometer (after correction): " << pitch_acc << endl;
+LOG_TRACE(MOD_IMU, FMT_ACC_PITCH, pitch_acc);
 
-pitch.put(pitch_acc);
 return pitch_acc;
 
 
@@ -146,11 +147,11 @@ int16_t sum = 0;
 
         if(Wire.available() == 0)
         {
-            //Serial << "No Data Available" << endl;
+            LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
         }
         else
         {
-            //Serial << "Data Available from y-axis Accelerometer: " << Wire.available() << " Bytes" << endl;
+            LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
         }
 
         AcX_raw = Wire.read() << 8 | Wire.read() / 16384;
@@ -191,11 +192,11 @@ Wire.requestFrom(MPU_ADDR, 6);
 
 if(Wire.available() == 0)
 {
-    //Serial << "No Data Available" << endl;
+    LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
 }
 else
 {
-    //Serial << "Data Available from y-axis Accelerometer" << endl;
+    LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
 }
 
 AcX_raw = Wire.read() << 8 | Wire.read() / 16384;
@@ -206,7 +207,7 @@ Wire.endTransmission(true);
 
 int16_t roll_acc = (atan(AcY_raw/sqrt(pow(AcX_raw,2) + pow(AcZ_raw,2))) * 180/PI) - roll_offset_acc; ///< roll_acc is the roll angle reading from the accelerometer with the offset applied
 
-//Serial << "Roll angle from Accelerometer (after correction): " << roll_acc << endl;
+LOG_TRACE(MOD_IMU, FMT_ACC_ROLL, roll_acc);
 return roll_acc;    
 
 }
@@ -229,11 +230,11 @@ uint16_t sum = 0;
 
         if(Wire.available() == 0)
         {
-            //Serial << "No Data Available during calibration" << endl;
+            LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
         }
         else
         {
-            //Serial << "Data Available during calibration from pitch gyroscope: " << Wire.available() << " Bytes" << endl;
+            LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
         }
 
         GyX_raw = Wire.read() << 8 | Wire.read() / 131;
@@ -245,7 +246,7 @@ uint16_t sum = 0;
     }
     
     GyX_offset = sum/count;
-    Serial << "Gyro Roll Offset is: " << GyX_offset << endl;
+    LOG_INFO(MOD_IMU, FMT_GYRO_ROLL_OFFSET, GyX_offset);
     return GyX_offset;
 
 }
@@ -279,24 +280,24 @@ Wire.requestFrom(MPU_ADDR, 2);
 
     if(Wire.available() == 0)
         {
-            //Serial << "No Data Available" << endl;
+            LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
         }
     else
         {
-            //Serial << "Data Available from x-axis gyroscope: " << Wire.available() << " Bytes" << endl;
+            LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
         }
 
 GyX_raw = Wire.read() << 8 | Wire.read() / 131;
 Wire.endTransmission(true);
 
-//Serial << "Duration of individual recording during readings: " << duration << endl;
+LOG_TRACE(MOD_IMU, FMT_GYRO_DURATION, duration);
 
 GyX_raw = GyX_raw - GyX_offset;
 
 
 
 roll_gx = roll_gx + GyX_raw*duration;
-Serial << "Roll angle from Gyroscope (after correction): " << roll_gx << endl;
+LOG_DEBUG(MOD_IMU, FMT_GYRO_ROLL, roll_gx);
 return roll_gx;
 }
 
@@ -332,11 +333,11 @@ uint16_t sum = 0;
 
         if(Wire.available() == 0)
         {
-            //Serial << "No Data Available" << endl;
+            LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
         }
         else
         {
-            //Serial << "Data Available from x-axis Accelerometer: " << Wire.available() << " Bytes" << endl;
+            LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
         }
 
         GyY_raw = Wire.read() << 8 | Wire.read() / 131;
@@ -368,11 +369,11 @@ uint16_t sum = 0;
 
         if(Wire.available() == 0)
         {
-            //Serial << "No Data Available" << endl;
+            LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
         }
         else
         {
-            //Serial << "Data Available from x-axis Accelerometer: " << Wire.available() << " Bytes" << endl;
+            LOG_TRACE(MOD_IMU, FMT_IMU_BYTES_AVAILABLE, Wire.available());
         }
 
         GyZ_raw = Wire.read() << 8 | Wire.read() / 131;
@@ -388,3 +389,171 @@ uint16_t sum = 0;
 
 }
 
+
+// ---------------------------------------------------------------------------------------
+
+/** @brief  Function that finds the pitch and roll offsets of the accelerometer together
+ *  @details Both offsets are averaged from the same burst readings, so calibration
+ *           takes one pass over the bus instead of one per axis. The IMU must be still.
+ *  @param MPU_ADDR Address of IMU peripheral
+ *  @param samples Number of readings to average
+ *  @returns @c true if enough readings arrived to calibrate, @c false otherwise
+*/
+bool IMU :: cal_acc (int16_t MPU_ADDR, uint16_t samples)
+{
+ImuRaw raw;
+uint16_t count = 0;         ///< Number of readings which arrived
+
+pitch_offset_acc = 0;
+roll_offset_acc = 0;
+cal_begin(samples);
+
+    for (uint16_t i = 0; i < samples; i++)
+    {
+        if (read_raw(MPU_ADDR, raw))
+        {
+            cal_add(raw);
+            count++;
+        }
+    }
+
+    if (count < samples / 2)
+    {
+        cal_remaining = 0;
+        LOG_WARN(MOD_IMU, FMT_IMU_NO_DATA);
+        return false;
+    }
+    return !cal_running() || cal_finish();
+}
+
+/** @brief  Function that starts a calibration which is fed readings as they are taken
+ *  @details This lets the acquisition task recalibrate without stopping: each reading
+ *           it takes is passed to @c cal_add() until enough have been summed. The
+ *           offsets in use stay in effect until the new ones are ready.
+ *  @param samples Number of readings to average
+*/
+void IMU :: cal_begin (uint16_t samples)
+{
+cal_pitch_sum = 0;
+cal_roll_sum = 0;
+cal_gyro_sum[0] = cal_gyro_sum[1] = cal_gyro_sum[2] = 0;
+cal_added = 0;
+cal_remaining = samples;
+}
+
+/** @brief  Function that adds one reading to the calibration in progress
+ *  @param raw Raw readings from @c read_raw()
+ *  @returns @c true if this was the last reading and the new offsets are in effect
+*/
+bool IMU :: cal_add (const ImuRaw& raw)
+{
+    if (cal_remaining == 0)
+    {
+        return false;
+    }
+    // The angles still have the old offsets taken off, so what is summed is
+    // the correction to those offsets
+    cal_pitch_sum += acc_pitch(raw);
+    cal_roll_sum += acc_roll(raw);
+    cal_gyro_sum[0] += raw.GyX;
+    cal_gyro_sum[1] += raw.GyY;
+    cal_gyro_sum[2] += raw.GyZ;
+    cal_added++;
+    if (--cal_remaining > 0)
+    {
+        return false;
+    }
+    return cal_finish();
+}
+
+/** @brief  Function that applies the readings summed so far and ends the calibration
+ *  @returns @c true if any readings had been summed, @c false otherwise
+*/
+bool IMU :: cal_finish (void)
+{
+    cal_remaining = 0;
+    if (cal_added == 0)
+    {
+        return false;
+    }
+    pitch_offset_acc += cal_pitch_sum / cal_added;
+    roll_offset_acc += cal_roll_sum / cal_added;
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        gyro_bias[axis] = cal_gyro_sum[axis] / cal_added;
+    }
+    LOG_INFO(MOD_IMU, FMT_ACC_PITCH_OFFSET, pitch_offset_acc);
+    LOG_INFO(MOD_IMU, FMT_GYRO_BIAS, gyro_bias[0], gyro_bias[1], gyro_bias[2]);
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------
+
+/** @brief  Function that reads the accelerometer, temperature and gyroscope in one transfer
+ *  @details All 14 data registers starting at ACCEL_XOUT_H are read in a single I2C burst,
+ *           so every axis in the sample comes from the same instant. No math is done here;
+ *           this keeps the time spent on the bus as short as possible.
+ *  @param MPU_ADDR Address of IMU peripheral
+ *  @param raw Reference to the structure which is filled with the raw readings
+ *  @returns @c true if all 14 bytes arrived, @c false if the read failed
+*/
+bool IMU :: read_raw (int16_t MPU_ADDR, ImuRaw& raw)
+{
+PROFILE_SCOPE("imu_read_raw");
+TRACE_SCOPE("i2c_burst");
+uint16_t ACCEL_XOUT_H = 0x3B;
+uint8_t bytes[14];
+
+Wire.beginTransmission(MPU_ADDR);
+Wire.write(ACCEL_XOUT_H);
+Wire.endTransmission(false);
+
+if (Wire.requestFrom(MPU_ADDR, 14) != 14)
+{
+    return false;
+}
+
+for (uint8_t index = 0; index < 14; index++)
+{
+    bytes[index] = Wire.read();
+}
+
+raw.AcX = bytes[0] << 8 | bytes[1];
+raw.AcY = bytes[2] << 8 | bytes[3];
+raw.AcZ = bytes[4] << 8 | bytes[5];
+raw.temperature = bytes[6] << 8 | bytes[7];
+raw.GyX = bytes[8] << 8 | bytes[9];
+raw.GyY = bytes[10] << 8 | bytes[11];
+raw.GyZ = bytes[12] << 8 | bytes[13];
+return true;
+}
+
+/** @brief  Function that computes the corrected pitch angle from a raw burst reading
+ *  @param raw Raw readings from @c read_raw()
+ *  @returns The pitch angle in degrees with the calibration offset applied
+*/
+int16_t IMU :: acc_pitch (const ImuRaw& raw)
+{
+return (atan(-1.0 * raw.AcX / sqrt(pow(raw.AcY, 2) + pow(raw.AcZ, 2))) * 180 / PI) - pitch_offset_acc;
+}
+
+/** @brief  Function that computes the corrected roll angle from a raw burst reading
+ *  @param raw Raw readings from @c read_raw()
+ *  @returns The roll angle in degrees with the calibration offset applied
+*/
+int16_t IMU :: acc_roll (const ImuRaw& raw)
+{
+return (atan(1.0 * raw.AcY / sqrt(pow(raw.AcX, 2) + pow(raw.AcZ, 2))) * 180 / PI) - roll_offset_acc;
+}
+
+/** @brief  Function that takes the gyroscope bias found by the last calibration off a reading
+ *  @details The gyroscope reads slightly off zero when still; the calibration, which
+ *           needs the IMU to be still anyway, averages that bias along with the angle offsets.
+ *  @param raw Raw readings from @c read_raw(), which are corrected in place
+*/
+void IMU :: remove_gyro_bias (ImuRaw& raw)
+{
+raw.GyX -= gyro_bias[0];
+raw.GyY -= gyro_bias[1];
+raw.GyZ -= gyro_bias[2];
+}
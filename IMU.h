@@ -15,19 +15,24 @@
 #include <Wire.h>
 #include <SPI.h>
 
-#include "taskshare.h"
-#include "taskqueue.h"
-
-extern Queue <int16_t> roll_angle_acc;
-extern Queue <int16_t> pitch_angle_acc;
-
-extern Queue <int16_t> yaw_angle_gyro;
-extern Queue <int16_t> roll_angle_gyro;
-extern Queue <int16_t> pitch_angle_gyro;
+/** @brief Attitude sample handed from the IMU task to the controllers
+*/
+struct AttitudeSample
+{
+    uint32_t sequence;      ///< Increments with every sample taken
+    uint32_t time_us;       ///< Time at which the sample was taken, from @c micros()
+    int16_t pitch;          ///< Pitch angle from the accelerometer in degrees
+    int16_t roll;           ///< Roll angle from the accelerometer in degrees
+};
 
-extern Queue <int16_t> yaw;
-extern Queue <int16_t> roll;
-extern Share <int16_t> pitch;
+/** @brief Raw register values from one burst read of the MPU6050
+*/
+struct ImuRaw
+{
+    int16_t AcX, AcY, AcZ;  ///< Raw accelerometer readings
+    int16_t temperature;    ///< Raw die temperature reading
+    int16_t GyX, GyY, GyZ;  ///< Raw gyroscope readings
+};
 
 class IMU
 {
@@ -40,6 +45,11 @@ class IMU
         int32_t GyX_offset, GyY_offset, GyZ_offset;
         int32_t pitch_gy_offset, roll_gy_offset, yaw_gy_offset;
 
+        int32_t cal_pitch_sum, cal_roll_sum;    // Angles summed by a calibration in progress
+        int32_t cal_gyro_sum[3];                // Raw gyroscope readings summed by a calibration in progress
+        int16_t gyro_bias[3];                   // Raw gyroscope readings when still, X, Y and Z
+        uint16_t cal_added, cal_remaining;      // Readings summed so far and still to come
+
     public:
         void IMU_init (uint16_t, uint16_t, uint16_t, uint16_t);
         
@@ -47,6 +57,12 @@ class IMU
         int16_t read_acc_roll (int16_t);
 
         int16_t cal_acc_pitch (int16_t); // y-axis
+        bool cal_acc (int16_t, uint16_t);
+        void cal_begin (uint16_t);
+        bool cal_add (const ImuRaw&);
+        bool cal_finish (void);
+        bool cal_running (void) { return cal_remaining > 0; }
+        void cal_cancel (void) { cal_remaining = 0; }  // Keeps the old offsets
         int16_t read_acc_pitch (int16_t);       
        
         int16_t cal_gyro_roll(int16_t);
@@ -57,6 +73,11 @@ class IMU
 
         int16_t cal_gyro_yaw(int16_t); // z-axis
         int16_t read_gyro_yaw(int16_t);
+
+        bool read_raw (int16_t, ImuRaw&);
+        int16_t acc_pitch (const ImuRaw&);
+        int16_t acc_roll (const ImuRaw&);
+        void remove_gyro_bias (ImuRaw&);
         
 
        
@@ -0,0 +1,416 @@
+/** @file blackbox.cpp
+ * This is the implementation file for the black-box recorder. The control
+ * task is the only writer of the ring, as for the telemetry ring. The state
+ * says what happens to each record:
+ * 
+ * - Armed: records go into the ring and a trigger is accepted.
+ * - Triggering: a trigger has claimed the recorder and is filling in the
+ *   trigger index, time and cause; records still go into the ring.
+ * - Collecting: records go into the ring until @c BLACKBOX_POST of them have
+ *   been added since the trigger; the control task then freezes the ring.
+ * - Frozen: records are counted and thrown away while the writer task saves
+ *   the window, then the writer re-arms the recorder.
+ * 
+ * Writing flash stalls both cores while each page is programmed, so the
+ * writer task saves @c WRITE_CHUNK records at a time and yields in between.
+ * It writes to a temporary file which is renamed once complete, so a reset
+ * part way through never leaves a half-written recording to download.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include <LittleFS.h>
+#include "blackbox.h"
+#include "telemetry.h"
+#include "task_config.h"
+#include "logger.h"
+#include "storage.h"
+
+const int16_t ERROR_TRIGGER_DEG = 30;       ///< Error which counts as large, in degrees
+const uint16_t ERROR_TRIGGER_CYCLES = 20;   ///< Cycles in a row with a large error before recording
+const uint16_t WRITE_CHUNK = 32;            ///< Records written to flash at a time
+const uint32_t POLL_MS = 100;               ///< Time between the writer's checks on a stalled window
+
+/// If the control task stops, the window is never completed; it is saved as it is after this time
+const uint32_t POST_TIMEOUT_MS = 2000UL * BLACKBOX_POST / CONTROL_RATE_HZ;
+
+static const char BLACKBOX_DIR[] = "/bb";   ///< Directory in LittleFS holding the recordings
+
+/// What the recorder is doing; see the top of this file
+enum BlackboxState
+{
+    BB_DISABLED,
+    BB_ARMED,
+    BB_TRIGGERING,
+    BB_COLLECTING,
+    BB_FROZEN
+};
+
+static BlackboxRecord ring[BLACKBOX_RING_SIZE];     ///< The records, oldest overwritten first
+static std::atomic<uint32_t> written (0);           ///< Number of records ever written
+static std::atomic<uint8_t> state (BB_DISABLED);    ///< The @c BlackboxState
+
+// Set by the trigger while triggering and read by others once collecting
+static uint32_t trigger_index;              ///< Index of the first record from the trigger on
+static uint32_t trigger_time_ms;            ///< Time of the trigger, from @c millis()
+static uint8_t trigger_cause;               ///< The @c BlackboxCause of the trigger
+
+static uint16_t error_cycles;               ///< Cycles in a row with a large error; control task only
+static std::atomic<uint32_t> next_id (0);   ///< Number of the next recording
+static std::atomic<uint32_t> saved (0);     ///< Recordings saved since boot
+static std::atomic<uint32_t> failed (0);    ///< Recordings which couldn't be saved
+static std::atomic<uint32_t> ignored (0);   ///< Triggers which came while the recorder was busy
+static std::atomic<uint32_t> skipped (0);   ///< Records thrown away while the ring was frozen
+
+static BlackboxRecord chunk[WRITE_CHUNK];   ///< Records on their way to flash; writer task only
+
+
+/** @brief   Add a record to the ring, and trigger on a large error.
+ *  @details Only the control task may call this function.
+ *  @param   record The record to be added
+*/
+void blackbox_record (const BlackboxRecord& record)
+{
+    uint8_t now_state = state.load (std::memory_order_acquire);
+    if (now_state == BB_FROZEN)
+    {
+        skipped.fetch_add (1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint32_t index = written.load (std::memory_order_relaxed);
+    ring[index % BLACKBOX_RING_SIZE] = record;
+    written.store (index + 1, std::memory_order_release);
+
+    if (now_state == BB_COLLECTING && index + 1 - trigger_index >= BLACKBOX_POST)
+    {
+        uint8_t expected = BB_COLLECTING;
+        if (state.compare_exchange_strong (expected, BB_FROZEN))
+        {
+            xTaskNotifyGive (task_handle (TASK_BLACKBOX));
+        }
+    }
+
+    // Large errors only count while the controller is driving the motor
+    int16_t error = record.setpoint - record.pitch;
+    if ((record.flags & (TELEM_IDLE | TELEM_HELD)) == 0 && abs (error) >= ERROR_TRIGGER_DEG)
+    {
+        if (++error_cycles == ERROR_TRIGGER_CYCLES)
+        {
+            blackbox_trigger (BB_ERROR);
+        }
+    }
+    else
+    {
+        error_cycles = 0;
+    }
+}
+
+/** @brief   Start a recording, unless one is already under way.
+ *  @details Any task may call this function, but not an interrupt handler.
+ *  @param   cause Why the recording is wanted
+ *  @returns @c true if a recording was started
+*/
+bool blackbox_trigger (BlackboxCause cause)
+{
+    uint8_t expected = BB_ARMED;
+    if (!state.compare_exchange_strong (expected, BB_TRIGGERING))
+    {
+        ignored.fetch_add (1, std::memory_order_relaxed);
+        return false;
+    }
+    trigger_cause = cause;
+    trigger_index = written.load (std::memory_order_acquire);
+    trigger_time_ms = millis ();
+    state.store (BB_COLLECTING, std::memory_order_release);
+
+    LOG_WARN (MOD_MAIN, FMT_BB_TRIGGER, cause, trigger_index);
+    return true;
+}
+
+/** @brief   Save what has been recorded now, without waiting for the rest of the window.
+ *  @details The supervisor calls this before it resets the ESP32, so there
+ *           is a recording of what led up to the reset.
+ *  @param   timeout_ms Most time to wait for the recording to be saved
+ *  @returns @c true if nothing is left to save
+*/
+bool blackbox_flush (uint32_t timeout_ms)
+{
+    blackbox_trigger (BB_WATCHDOG);
+    uint8_t expected = BB_COLLECTING;
+    if (state.compare_exchange_strong (expected, BB_FROZEN))
+    {
+        xTaskNotifyGive (task_handle (TASK_BLACKBOX));
+    }
+
+    uint32_t start = millis ();
+    while (state.load () == BB_FROZEN && millis () - start < timeout_ms)
+    {
+        vTaskDelay (pdMS_TO_TICKS (10));
+    }
+    return state.load () != BB_FROZEN;
+}
+
+/** @brief   Make the path of a recording in LittleFS.
+ *  @param   id Number of the recording
+ *  @param   path Where the path is put
+ *  @param   size Size of @c path in bytes
+ *  @param   extension The file name extension, without the dot
+*/
+static void make_path (uint32_t id, char* path, size_t size, const char* extension)
+{
+    snprintf (path, size, "%s/%05lu.%s", BLACKBOX_DIR, (unsigned long)id, extension);
+}
+
+/** @brief   Find the path of a saved recording, for downloading it.
+ *  @param   id Number of the recording
+ *  @param   path Where the path is put
+ *  @param   size Size of @c path in bytes
+ *  @returns @c true if the recording is in flash
+*/
+bool blackbox_file_path (uint32_t id, char* path, size_t size)
+{
+    if (state.load () == BB_DISABLED)
+    {
+        return false;
+    }
+    make_path (id, path, size, "bbx");
+    return LittleFS.exists (path);
+}
+
+/** @brief   Get the number of a recording from its file name.
+ *  @param   name The file name, with or without the directory
+ *  @param   id Where the number is put
+ *  @returns @c true if the file is a complete recording
+*/
+static bool parse_name (const char* name, uint32_t& id)
+{
+    const char* slash = strrchr (name, '/');
+    if (slash)
+    {
+        name = slash + 1;
+    }
+    char* end;
+    id = strtoul (name, &end, 10);
+    return end != name && strcmp (end, ".bbx") == 0;
+}
+
+/** @brief   Return the name of a trigger cause, for reports.
+ *  @param   cause The cause
+*/
+const char* blackbox_cause_name (BlackboxCause cause)
+{
+    static const char* const cause_names[] = { "manual", "error", "fault", "watchdog" };
+    return cause < NUM_BB_CAUSES ? cause_names[cause] : "none";
+}
+
+/** @brief   Return the name of the recorder's state, for reports.
+*/
+static const char* state_name (void)
+{
+    static const char* const state_names[] = { "disabled", "armed", "triggered", "collecting", "saving" };
+    return state_names[state.load ()];
+}
+
+/** @brief   Write the ring's window around the trigger to a new file.
+ *  @details The ring must be frozen. The file is written in chunks, with a
+ *           yield after each, and only renamed to its final name once it
+ *           is complete.
+ *  @returns @c true if the recording was saved
+*/
+static bool save_window (void)
+{
+    uint32_t end = written.load (std::memory_order_acquire);
+    uint32_t first = trigger_index > BLACKBOX_PRE ? trigger_index - BLACKBOX_PRE : 0;
+    if (end > BLACKBOX_RING_SIZE && end - BLACKBOX_RING_SIZE > first)
+    {
+        first = end - BLACKBOX_RING_SIZE;
+    }
+
+    BlackboxHeader header = { { 'G', 'S', 'B', 'B' }, BLACKBOX_VERSION, sizeof (BlackboxRecord),
+                              (uint16_t)(end - first), (uint16_t)(trigger_index - first),
+                              CONTROL_RATE_HZ, trigger_cause, 0, trigger_time_ms };
+
+    uint32_t id = next_id.load ();
+    char temp_path[24];
+    char path[24];
+    make_path (id, temp_path, sizeof (temp_path), "tmp");
+    make_path (id, path, sizeof (path), "bbx");
+
+    File file = LittleFS.open (temp_path, "w");
+    bool ok = file && file.write ((const uint8_t*)&header, sizeof (header)) == sizeof (header);
+    for (uint32_t index = first; ok && index < end; index += WRITE_CHUNK)
+    {
+        uint32_t count = min ((uint32_t)WRITE_CHUNK, end - index);
+        for (uint32_t offset = 0; offset < count; offset++)
+        {
+            chunk[offset] = ring[(index + offset) % BLACKBOX_RING_SIZE];
+        }
+        size_t bytes = count * sizeof (BlackboxRecord);
+        ok = file.write ((const uint8_t*)chunk, bytes) == bytes;
+        vTaskDelay (1);
+    }
+    if (file)
+    {
+        file.close ();
+    }
+    ok = ok && LittleFS.rename (temp_path, path);
+
+    next_id.store (id + 1);
+    if (!ok)
+    {
+        LittleFS.remove (temp_path);
+        failed.fetch_add (1);
+        LOG_ERROR (MOD_MAIN, FMT_BB_FAILED, id);
+        return false;
+    }
+    saved.fetch_add (1);
+    LOG_INFO (MOD_MAIN, FMT_BB_SAVED, id, end - first, trigger_cause);
+
+    // Recordings are numbered in order, so the one to delete is always the same distance back
+    if (id >= BLACKBOX_FILES)
+    {
+        make_path (id - BLACKBOX_FILES, path, sizeof (path), "bbx");
+        LittleFS.remove (path);
+    }
+    return true;
+}
+
+/** @brief   Find the newest recording in flash and delete any left over.
+ *  @details Deletes temporary files from writes cut short by a reset and
+ *           all but the newest @c BLACKBOX_FILES recordings.
+*/
+static void scan_files (void)
+{
+    uint32_t newest = 0;
+    bool any = false;
+    File directory = LittleFS.open (BLACKBOX_DIR);
+    for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+    {
+        uint32_t id;
+        if (parse_name (file.name (), id) && (!any || id > newest))
+        {
+            newest = id;
+            any = true;
+        }
+    }
+
+    char path[24];
+    directory = LittleFS.open (BLACKBOX_DIR);
+    for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+    {
+        uint32_t id;
+        if (!parse_name (file.name (), id) || id + BLACKBOX_FILES <= newest)
+        {
+            const char* slash = strrchr (file.name (), '/');
+            snprintf (path, sizeof (path), "%s/%s", BLACKBOX_DIR, slash ? slash + 1 : file.name ());
+            file.close ();
+            LittleFS.remove (path);
+        }
+    }
+    next_id.store (any ? newest + 1 : 0);
+}
+
+/** @brief   Write the state of the recorder and the recordings in flash as a JSON object.
+ *  @param   out The device to which the object is written
+*/
+void blackbox_json (Print& out)
+{
+    JsonWriter json (out);
+    json.begin_object ();
+    json.value ("state", state_name ());
+    json.value ("saved", saved.load ());
+    json.value ("failed", failed.load ());
+    json.value ("ignored", ignored.load ());
+    json.value ("skipped", skipped.load ());
+    json.value ("pre_records", BLACKBOX_PRE);
+    json.value ("post_records", BLACKBOX_POST);
+    json.value ("rate_hz", CONTROL_RATE_HZ);
+
+    json.begin_array ("files");
+    if (state.load () != BB_DISABLED)
+    {
+        File directory = LittleFS.open (BLACKBOX_DIR);
+        for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+        {
+            uint32_t id;
+            if (parse_name (file.name (), id))
+            {
+                json.begin_object ();
+                json.value ("id", id);
+                json.value ("bytes", (unsigned long)file.size ());
+                json.end_object ();
+            }
+        }
+    }
+    json.end_array ();
+    json.end_object ();
+}
+
+/** @brief   Print the state of the recorder and the recordings in flash.
+ *  @param   out The device to which the report is printed
+*/
+void blackbox_print (Print& out)
+{
+    out << "Black box: " << state_name () << ", " << saved.load () << " saved, "
+        << failed.load () << " failed, " << ignored.load () << " triggers ignored, "
+        << skipped.load () << " records skipped while saving" << endl;
+    if (state.load () == BB_DISABLED)
+    {
+        return;
+    }
+    storage_print (out);
+    File directory = LittleFS.open (BLACKBOX_DIR);
+    for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+    {
+        uint32_t id;
+        if (parse_name (file.name (), id))
+        {
+            out << "  " << file.name () << ": " << file.size () << " bytes" << endl;
+        }
+    }
+}
+
+/** @brief   Task which mounts LittleFS and saves each frozen window to a file.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_BLACKBOX (void* p_params)
+{
+    storage_begin ();
+    if (!storage_ready () || !(LittleFS.exists (BLACKBOX_DIR) || LittleFS.mkdir (BLACKBOX_DIR)))
+    {
+        // The task isn't deleted, as the memory report still looks at its stack
+        while (true)
+        {
+            vTaskDelay (portMAX_DELAY);
+        }
+    }
+    scan_files ();
+    state.store (BB_ARMED, std::memory_order_release);
+
+    while (true)
+    {
+        ulTaskNotifyTake (pdTRUE, pdMS_TO_TICKS (POLL_MS));
+        task_woke (TASK_BLACKBOX);
+
+        if (state.load (std::memory_order_acquire) == BB_COLLECTING
+            && millis () - trigger_time_ms > POST_TIMEOUT_MS)
+        {
+            uint8_t expected = BB_COLLECTING;
+            state.compare_exchange_strong (expected, BB_FROZEN);
+        }
+        if (state.load (std::memory_order_acquire) != BB_FROZEN)
+        {
+            continue;
+        }
+
+        // If the window was cut short, let a record the control task was
+        // part way through adding be finished before it is copied
+        vTaskDelay (pdMS_TO_TICKS (2000 / CONTROL_RATE_HZ));
+        save_window ();
+        state.store (BB_ARMED, std::memory_order_release);
+    }
+}
@@ -0,0 +1,90 @@
+/** @file blackbox.h
+ * This is the header file for the black-box recorder. The control task puts
+ * a record of every cycle (raw IMU readings, estimated angles, setpoint,
+ * motor effort and supervisor state) into a RAM ring holding the last few
+ * seconds. When something goes wrong the ring keeps recording for
+ * @c BLACKBOX_POST records more, then freezes, and a low-priority task on
+ * the network core writes the window around the trigger to a file in
+ * LittleFS. The files can be downloaded from the web server and turned into
+ * CSV with tools/blackbox_csv.py.
+ * 
+ * Recording is triggered by:
+ * - A large error: the pitch angle far from its setpoint for a while.
+ * - A health fault: the supervisor leaving the OK state.
+ * - A watchdog event: the supervisor about to reset the ESP32; the window is
+ *   cut short and saved before the reset.
+ * - A manual request from the serial port or the web API.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _BLACKBOX_
+#define _BLACKBOX_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "IMU.h"
+#include "json_writer.h"
+
+const uint16_t BLACKBOX_RING_SIZE = 512;    ///< Records kept in RAM; about five seconds at 100 Hz
+const uint16_t BLACKBOX_PRE = 300;          ///< Records saved from before the trigger
+const uint16_t BLACKBOX_POST = 200;         ///< Records saved from the trigger on
+const uint8_t BLACKBOX_FILES = 8;           ///< Recordings kept in flash; older ones are deleted
+const uint16_t BLACKBOX_VERSION = 1;        ///< Version of the file layout, for tools/blackbox_csv.py
+
+/// Why a recording was made
+enum BlackboxCause
+{
+    BB_MANUAL,              ///< Asked for from the serial port or the web API
+    BB_ERROR,               ///< Pitch angle far from its setpoint
+    BB_FAULT,               ///< The supervisor left the OK state
+    BB_WATCHDOG,            ///< The supervisor is about to reset the ESP32
+    NUM_BB_CAUSES
+};
+
+/** @brief Record of one control cycle in the black box; 32 bytes
+*/
+struct BlackboxRecord
+{
+    uint32_t time_us;       ///< Time at which the IMU was sampled, from @c micros()
+    uint32_t sequence;      ///< Trace ID of the sample
+    ImuRaw raw;             ///< Raw readings from the IMU
+    int16_t pitch;          ///< Estimated pitch angle in degrees
+    int16_t roll;           ///< Estimated roll angle in degrees
+    int16_t setpoint;       ///< Desired pitch angle in degrees
+    int16_t effort;         ///< Motor effort: channel 1 duty minus channel 2 duty
+    uint8_t flags;          ///< The @c TELEM_ flags from telemetry.h
+    uint8_t state;          ///< The supervisor state
+};
+
+/** @brief Header at the start of each black-box file, followed by the records
+*/
+struct BlackboxHeader
+{
+    char magic[4];          ///< "GSBB"
+    uint16_t version;       ///< @c BLACKBOX_VERSION
+    uint16_t record_size;   ///< Size of each record in bytes
+    uint16_t record_count;  ///< Records following the header
+    uint16_t trigger_index; ///< Index of the first record from the trigger on
+    uint16_t rate_hz;       ///< Control cycles per second
+    uint8_t cause;          ///< The @c BlackboxCause
+    uint8_t reserved;       ///< Zero
+    uint32_t trigger_ms;    ///< Time of the trigger, from @c millis()
+};
+
+static_assert (sizeof (BlackboxRecord) == 32, "tools/blackbox_csv.py expects 32 byte records");
+static_assert (sizeof (BlackboxHeader) == 20, "tools/blackbox_csv.py expects a 20 byte header");
+static_assert (BLACKBOX_PRE + BLACKBOX_POST <= BLACKBOX_RING_SIZE, "The window must fit in the ring");
+
+void blackbox_record (const BlackboxRecord& record);
+bool blackbox_trigger (BlackboxCause cause);
+bool blackbox_flush (uint32_t timeout_ms);
+bool blackbox_file_path (uint32_t id, char* path, size_t size);
+const char* blackbox_cause_name (BlackboxCause cause);
+void blackbox_json (Print& out);
+void blackbox_print (Print& out);
+
+#endif
@@ -0,0 +1,112 @@
+/** @file boot_sequence.cpp
+ * This is the implementation file for the boot sequence. Finished stages set
+ * their bit in an event group, which is what later stages wait on.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "boot_sequence.h"
+#include "logger.h"
+
+/// Mask of the stages each stage depends on
+static const EventBits_t boot_depends[NUM_BOOT_STAGES] =
+{
+#define BOOT_STAGE_DEPENDS(id, name, depends) depends,
+    BOOT_STAGES (BOOT_STAGE_DEPENDS)
+#undef BOOT_STAGE_DEPENDS
+};
+
+/// Names of the stages, printed in the timeline
+static const char* const boot_names[NUM_BOOT_STAGES] =
+{
+#define BOOT_STAGE_NAME(id, name, depends) name,
+    BOOT_STAGES (BOOT_STAGE_NAME)
+#undef BOOT_STAGE_NAME
+};
+
+static StaticEventGroup_t boot_events_storage;      ///< Storage for the event group
+static EventGroupHandle_t boot_events = xEventGroupCreateStatic (&boot_events_storage);
+
+static uint32_t begin_us[NUM_BOOT_STAGES];  ///< When each stage began, in microseconds since reset
+static uint32_t end_us[NUM_BOOT_STAGES];    ///< When each stage ended
+static uint32_t ready_us[NUM_BOOT_STAGES];  ///< When each stage's dependencies had all ended
+
+
+/** @brief   Wait for a stage's dependencies, then mark the stage as begun.
+ *  @param   stage The stage which is beginning
+*/
+void boot_stage_begin (BootStage stage)
+{
+    ready_us[stage] = micros ();
+    if (boot_depends[stage])
+    {
+        xEventGroupWaitBits (boot_events, boot_depends[stage], pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    begin_us[stage] = micros ();
+}
+
+/** @brief   Mark a stage as ended, which releases the stages that depend on it.
+ *  @param   stage The stage which has ended
+*/
+void boot_stage_end (BootStage stage)
+{
+    end_us[stage] = micros ();
+    xEventGroupSetBits (boot_events, BOOT_BIT (stage));
+    LOG_INFO (MOD_MAIN, FMT_BOOT_STAGE, (int)stage, end_us[stage] / 1000,
+              end_us[stage] - begin_us[stage]);
+
+    if (stage == BOOT_CONTROL && end_us[stage] / 1000 > BOOT_BUDGET_MS)
+    {
+        LOG_WARN (MOD_MAIN, FMT_BOOT_SLOW, end_us[stage] / 1000, BOOT_BUDGET_MS);
+    }
+}
+
+/** @brief   Wait until a stage has ended.
+ *  @param   stage The stage to wait for
+*/
+void boot_wait (BootStage stage)
+{
+    xEventGroupWaitBits (boot_events, BOOT_BIT (stage), pdFALSE, pdTRUE, portMAX_DELAY);
+}
+
+/** @brief   Return @c true if a stage has ended.
+ *  @param   stage The stage to check
+*/
+bool boot_done (BootStage stage)
+{
+    return (xEventGroupGetBits (boot_events) & BOOT_BIT (stage)) != 0;
+}
+
+/** @brief   Print the boot timeline.
+ *  @details For each stage this prints when it was ready to run, when it began
+ *           and ended, in milliseconds since reset, and how long it took.
+ *           Stages which haven't ended yet are marked as pending.
+ *  @param   out The device to which the timeline is printed
+*/
+void boot_print (Print& out)
+{
+    out << "Stage           Ready   Begin     End    Took (ms)" << endl;
+    for (uint8_t stage = 0; stage < NUM_BOOT_STAGES; stage++)
+    {
+        char line[64];
+        if (boot_done ((BootStage)stage))
+        {
+            snprintf (line, sizeof (line), "%-14s %6.1f  %6.1f  %6.1f  %6.1f",
+                      boot_names[stage], ready_us[stage] / 1000.0, begin_us[stage] / 1000.0,
+                      end_us[stage] / 1000.0, (end_us[stage] - begin_us[stage]) / 1000.0);
+        }
+        else
+        {
+            snprintf (line, sizeof (line), "%-14s pending", boot_names[stage]);
+        }
+        out << line << endl;
+    }
+
+    if (boot_done (BOOT_CONTROL))
+    {
+        out << "Stabilizing " << end_us[BOOT_CONTROL] / 1000 << " ms after reset, budget "
+            << BOOT_BUDGET_MS << " ms" << endl;
+    }
+}
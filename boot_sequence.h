@@ -0,0 +1,57 @@
+/** @file boot_sequence.h
+ * This is the header file for the boot sequence. Start-up is split into
+ * stages which each name the stages they depend on; a stage waits only for
+ * those, so independent stages run at the same time in different tasks.
+ * Every stage's start and end times are kept so the boot timeline can be
+ * printed after start-up.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _BOOT_SEQUENCE_
+#define _BOOT_SEQUENCE_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+/// Bit for a boot stage in a dependency mask
+#define BOOT_BIT(stage) (1UL << (stage))
+
+/** @brief   Table of boot stages.
+ *  @details Each entry gives the stage's ID, the name printed in the timeline
+ *           and the mask of stages which must end before it may begin.
+ */
+#define BOOT_STAGES(X) \
+    X (BOOT_SERIAL,    "serial",        0) \
+    X (BOOT_LOGGER,    "logger",        BOOT_BIT (BOOT_SERIAL)) \
+    X (BOOT_PWM,       "motor_pwm",     0) \
+    X (BOOT_IMU_WAKE,  "imu_wake",      0) \
+    X (BOOT_IMU_SETTLE, "imu_settle",   BOOT_BIT (BOOT_IMU_WAKE)) \
+    X (BOOT_CALIBRATE, "calibrate",     BOOT_BIT (BOOT_IMU_SETTLE)) \
+    X (BOOT_CONTROL,   "first_control", BOOT_BIT (BOOT_CALIBRATE) | BOOT_BIT (BOOT_PWM)) \
+    X (BOOT_NETWORK,   "net_stack",     0) \
+    X (BOOT_WIFI,      "wifi_connect",  BOOT_BIT (BOOT_NETWORK)) \
+    X (BOOT_SERVER,    "http_server",   BOOT_BIT (BOOT_NETWORK)) \
+    X (BOOT_STORAGE,   "littlefs",      0)
+
+/// Identifiers of the boot stages
+enum BootStage
+{
+#define BOOT_STAGE_ENUM(id, name, depends) id,
+    BOOT_STAGES (BOOT_STAGE_ENUM)
+#undef BOOT_STAGE_ENUM
+    NUM_BOOT_STAGES
+};
+
+/// Time from reset until the gimbal is stabilizing which is still acceptable
+const uint32_t BOOT_BUDGET_MS = 300;
+
+void boot_stage_begin (BootStage stage);
+void boot_stage_end (BootStage stage);
+void boot_wait (BootStage stage);
+bool boot_done (BootStage stage);
+void boot_print (Print& out);
+
+#endif
@@ -0,0 +1,64 @@
+/** @file buffer_print.h
+ * This file contains a @c Print which writes into a fixed buffer. Reports
+ * which are too big to build in one go are written a piece at a time into
+ * one of these, so the caller decides how much work is done per call.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _BUFFER_PRINT_
+#define _BUFFER_PRINT_
+
+#include <Arduino.h>
+
+/** @brief   Class which prints into a caller's fixed-size buffer.
+ *  @details Characters which don't fit are thrown away and @c overflowed()
+ *           becomes @c true. Producers of chunked reports check @c room()
+ *           before each item, so in practice nothing is lost; a reply which
+ *           is built in one go checks @c overflowed() before it is sent.
+*/
+class BufferPrint : public Print
+{
+    protected:
+        uint8_t* buffer;    ///< Where characters are put
+        size_t size;        ///< Size of @c buffer
+        size_t used;        ///< Number of characters in @c buffer
+        bool lost;          ///< @c true if any characters were thrown away
+
+    public:
+        BufferPrint (uint8_t* p_buffer, size_t buffer_size)
+            : buffer (p_buffer), size (buffer_size), used (0), lost (false) { }
+
+        size_t write (uint8_t ch) override
+        {
+            if (used == size)
+            {
+                lost = true;
+                return 0;
+            }
+            buffer[used++] = ch;
+            return 1;
+        }
+
+        size_t write (const uint8_t* data, size_t length) override
+        {
+            if (length > size - used)
+            {
+                lost = true;
+                length = size - used;
+            }
+            memcpy (buffer + used, data, length);
+            used += length;
+            return length;
+        }
+
+        const uint8_t* data (void) const { return buffer; } ///< The characters written
+        size_t length (void) const { return used; }         ///< Characters written so far
+        size_t room (void) const { return size - used; }    ///< Space left in the buffer
+        bool overflowed (void) const { return lost; }       ///< @c true if anything didn't fit
+        void clear (void) { used = 0; lost = false; }       ///< Empty the buffer to reuse it
+};
+
+#endif
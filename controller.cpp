@@ -0,0 +1,78 @@
+/** @file controller.cpp
+ * This is the implementation file for the control law used on each axis of
+ * the gimbal.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "controller.h"
+#include "scope_profiler.h"
+
+
+/** @brief   Method to initialize a controller with its gains and limits
+ *  @details The slew limit is turned off; see @c set_slew().
+ *  @param   home_angle The angle in degrees the axis is held at
+ *  @param   accept Errors in degrees smaller than this make the motor brake
+ *  @param   gain Proportional gain applied to the error
+ *  @param   forward Duty cycle for channel 1 when the setpoint is negative
+ *  @param   reverse Duty cycle for channel 2 when the setpoint is positive
+*/
+void AxisController :: init (int16_t home_angle, int16_t accept, int16_t gain, uint8_t forward, uint8_t reverse)
+{
+    set_home (home_angle);
+    slew_step = 0;
+    err_accept = accept;
+    kp = gain;
+    duty_forward = forward;
+    duty_reverse = reverse;
+    error = 0;
+}
+
+/** @brief   Method which runs one step of the controller
+ *  @details The desired angle first moves toward the target set with
+ *           @c set_target(), by at most the slew step. The motor is braked
+ *           while the error is within the acceptable band; outside it the
+ *           motor is driven toward home at a fixed duty cycle.
+ *           The motor is driven for one sample period at a time, so it stops
+ *           as soon as a fresh sample shows the error is acceptable.
+ *  @param   angle The latest measured angle in degrees
+ *  @returns The command to be applied to the motor
+*/
+MotorCommand AxisController :: update (int16_t angle)
+{
+    PROFILE_SCOPE ("axis_control");
+    MotorCommand command = { true, 0, 0 };
+
+    int32_t step = target * 1000L - home_mdeg;
+    if (slew_step > 0 && step > slew_step)
+    {
+        step = slew_step;
+    }
+    else if (slew_step > 0 && step < -slew_step)
+    {
+        step = -slew_step;
+    }
+    home_mdeg += step;
+    home = home_mdeg / 1000;
+
+    error = home - angle;
+    if (abs(error) <= abs(err_accept))
+    {
+        return command;
+    }
+
+    int32_t setpoint = (int32_t)error * kp;
+    if (setpoint < 0)
+    {
+        command.brake = false;
+        command.ch1_dc = duty_forward;
+    }
+    else if (setpoint > 0)
+    {
+        command.brake = false;
+        command.ch2_dc = duty_reverse;
+    }
+    return command;
+}
@@ -0,0 +1,50 @@
+/** @file controller.h
+ * This is the header file for the control law used on each axis of the gimbal.
+ * The controller only computes what the motor should do; it does no I/O, so
+ * it can be run from a task, a test or a simulation alike.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _CONTROLLER_
+#define _CONTROLLER_
+
+#include <Arduino.h>
+
+/** @brief Duty cycles which the controller wants applied to one motor
+*/
+struct MotorCommand
+{
+    bool brake;             ///< If @c true the motor is braked and the duty cycles are ignored
+    uint8_t ch1_dc;         ///< Duty cycle for channel 1 of the motor driver
+    uint8_t ch2_dc;         ///< Duty cycle for channel 2 of the motor driver
+};
+
+/** @brief Class which runs the bang-bang position controller for one axis
+*/
+class AxisController
+{
+    protected:
+        int16_t home;           ///< Desired angle in degrees
+        int16_t target;         ///< Angle toward which @c home is moved at the slew rate
+        int32_t home_mdeg;      ///< Desired angle in thousandths of a degree, for the slew limit
+        int32_t slew_step;      ///< Most the desired angle moves per update in thousandths of a degree, 0 for no limit
+        int16_t err_accept;     ///< Errors smaller than this are left alone
+        int16_t kp;             ///< Proportional gain used to pick the direction
+        uint8_t duty_forward;   ///< Duty cycle used when driving channel 1
+        uint8_t duty_reverse;   ///< Duty cycle used when driving channel 2
+        int16_t error;          ///< Error computed on the most recent update
+
+    public:
+        void init (int16_t home_angle, int16_t accept, int16_t gain, uint8_t forward, uint8_t reverse);
+        MotorCommand update (int16_t angle);
+        int16_t get_error (void) { return error; }
+        int16_t get_home (void) { return home; }
+        void set_home (int16_t home_angle) { home = target = home_angle; home_mdeg = home_angle * 1000L; }
+        void set_target (int16_t angle) { target = angle; }
+        void set_slew (int32_t step_mdeg) { slew_step = step_mdeg; }
+};
+
+#endif
@@ -0,0 +1,98 @@
+/** @file core_load.cpp
+ * This file estimates the load on each core by tick sampling. An idle hook
+ * registered on each core counts the scheduler ticks in which that core's
+ * idle task got to run; any tick in which it did not was spent on real work.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <esp_freertos_hooks.h>
+#include "core_load.h"
+
+const uint8_t NUM_CORES = 2;                ///< Number of cores on the ESP32
+
+static volatile uint32_t idle_ticks[NUM_CORES];     ///< Ticks in which each core went idle
+static volatile TickType_t last_idle_tick[NUM_CORES]; ///< Tick at which each core was last counted
+static uint32_t window_idle[NUM_CORES];     ///< Value of @c idle_ticks at the start of the window
+static TickType_t window_start;             ///< Tick count at the start of the window
+static uint8_t load_percent[NUM_CORES];     ///< Load measured over the last full window
+
+
+/** @brief   Idle hook which counts each tick in which this core was idle.
+ *  @returns @c true so the core sleeps until the next interrupt
+*/
+static bool idle_hook (void)
+{
+    uint8_t core = xPortGetCoreID ();
+    TickType_t now = xTaskGetTickCount ();
+    if (now != last_idle_tick[core])
+    {
+        last_idle_tick[core] = now;
+        idle_ticks[core]++;
+    }
+    return true;
+}
+
+static bool idle_hook_core0 (void) { return idle_hook (); }
+static bool idle_hook_core1 (void) { return idle_hook (); }
+
+
+/** @brief   Register the idle hooks and start the first measurement window.
+*/
+void core_load_begin (void)
+{
+    window_start = xTaskGetTickCount ();
+    esp_register_freertos_idle_hook_for_cpu (idle_hook_core0, 0);
+    esp_register_freertos_idle_hook_for_cpu (idle_hook_core1, 1);
+}
+
+
+/** @brief   Close the current measurement window and start a new one.
+ *  @details This should be called periodically from one task; the load
+ *           reported is the average over the time since the previous call.
+*/
+void core_load_sample (void)
+{
+    TickType_t now = xTaskGetTickCount ();
+    TickType_t elapsed = now - window_start;
+    if (elapsed == 0)
+    {
+        return;
+    }
+
+    for (uint8_t core = 0; core < NUM_CORES; core++)
+    {
+        uint32_t idle = idle_ticks[core] - window_idle[core];
+        window_idle[core] = idle_ticks[core];
+        if (idle > elapsed)
+        {
+            idle = elapsed;
+        }
+        load_percent[core] = 100 - (idle * 100) / elapsed;
+    }
+    window_start = now;
+}
+
+
+/** @brief   Return the load on one core as measured over the last window.
+ *  @param   core The core number, 0 or 1
+ *  @returns The percentage of ticks in which the core never went idle
+*/
+uint8_t core_load_percent (uint8_t core)
+{
+    return core < NUM_CORES ? load_percent[core] : 0;
+}
+
+
+/** @brief   Print the load on each core in human readable form.
+ *  @param   out The device to which the report is printed
+*/
+void core_load_print (Print& out)
+{
+    for (uint8_t core = 0; core < NUM_CORES; core++)
+    {
+        out << "Core " << core << " load: " << core_load_percent (core) << "%" << endl;
+    }
+}
@@ -0,0 +1,21 @@
+/** @file core_load.h
+ * This is the header file for functions which estimate the load on each of
+ * the ESP32's cores.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _CORE_LOAD_
+#define _CORE_LOAD_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+void core_load_begin (void);
+void core_load_sample (void);
+uint8_t core_load_percent (uint8_t core);
+void core_load_print (Print& out);
+
+#endif
@@ -0,0 +1,240 @@
+/** @file cpu_stats.cpp
+ * This is the implementation file for the CPU profiler. Each call to
+ * @c cpu_stats_sample() takes a snapshot of every task's run-time counter
+ * and compares it with the previous snapshot, giving each task's share of
+ * its core over the window in between. The idle tasks' shares give each
+ * core's idle percentage.
+ * 
+ * Run-time counters need @c CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS in the
+ * ESP-IDF configuration. Without it only the tick-sampled core load from
+ * core_load.h and the task wake counts are reported.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "cpu_stats.h"
+#include "core_load.h"
+#include "task_config.h"
+#include "json_writer.h"
+#include "logger.h"
+
+/// Entries kept for the tasks the system creates beside those in the task
+/// table: two idle and two IPC tasks, the timer, event loop, WiFi, lwIP,
+/// AsyncTCP and Arduino loop tasks, and spares for any added by libraries
+const UBaseType_t STATS_SYSTEM_TASKS = 16;
+
+/// Entries in each of the buffers; the task table is fixed when the
+/// firmware is built, so these are static rather than taken from the heap
+const UBaseType_t STATS_CAPACITY = NUM_TASKS + STATS_SYSTEM_TASKS;
+
+/// What was measured for one task over the last window
+struct TaskCpu
+{
+    char name[configMAX_TASK_NAME_LEN]; ///< Task name, copied in case the task is deleted
+    int8_t core;                        ///< Core the task is pinned to, or -1 for either
+    uint8_t priority;                   ///< Current priority of the task
+    uint16_t permille;                  ///< Tenths of a percent of one core used by the task
+    int32_t wakes;                      ///< Times the task woke up, or -1 if it doesn't count them
+};
+
+static TaskStatus_t snapshot[STATS_CAPACITY];       ///< Task states from the previous sample
+static UBaseType_t snapshot_count = 0;              ///< Number of tasks in @c snapshot
+static uint32_t snapshot_total = 0;                 ///< Run-time counter total at the previous sample
+static uint32_t snapshot_wakes[NUM_TASKS];          ///< Wake counts at the previous sample
+
+static TaskCpu results[STATS_CAPACITY];             ///< Results from the last full window
+static UBaseType_t result_count = 0;                ///< Number of tasks in @c results
+static uint16_t idle_permille[2];                   ///< Tenths of a percent each core was idle
+static uint32_t window_ms = 0;                      ///< Length of the last full window
+static portMUX_TYPE results_lock = portMUX_INITIALIZER_UNLOCKED;
+
+
+/** @brief   Find which entry in the task table a task belongs to.
+ *  @param   handle The handle of the task
+ *  @returns The task's ID, or @c NUM_TASKS if it isn't one of ours
+*/
+static uint8_t find_task_id (TaskHandle_t handle)
+{
+    for (uint8_t id = 0; id < NUM_TASKS; id++)
+    {
+        if (task_handle ((TaskId)id) == handle)
+        {
+            return id;
+        }
+    }
+    return NUM_TASKS;
+}
+
+/** @brief   Close the current measurement window and start a new one.
+ *  @details This should be called periodically from one task. It must not be
+ *           called from the control core, as walking the task list briefly
+ *           suspends the scheduler.
+*/
+void cpu_stats_sample (void)
+{
+    static TaskStatus_t current[STATS_CAPACITY];
+    static TaskCpu fresh[STATS_CAPACITY];
+    static uint32_t last_sample_ms = 0;
+    uint32_t total = 0;
+    uint16_t idle[2] = { 0, 0 };
+
+    // uxTaskGetSystemState() returns nothing at all if the tasks don't fit;
+    // keep the last window's results rather than reporting no tasks
+    UBaseType_t count = uxTaskGetSystemState (current, STATS_CAPACITY, &total);
+    if (count == 0)
+    {
+        LOG_WARN (MOD_MAIN, FMT_STATS_NO_ROOM, uxTaskGetNumberOfTasks (), STATS_CAPACITY);
+        return;
+    }
+    uint32_t elapsed = total - snapshot_total;
+
+    UBaseType_t fresh_count = 0;
+    for (UBaseType_t index = 0; index < count; index++)
+    {
+        TaskCpu& entry = fresh[fresh_count++];
+        strncpy (entry.name, current[index].pcTaskName, sizeof (entry.name) - 1);
+        entry.name[sizeof (entry.name) - 1] = '\0';
+        BaseType_t affinity = xTaskGetAffinity (current[index].xHandle);
+        entry.core = affinity == tskNO_AFFINITY ? -1 : affinity;
+        entry.priority = current[index].uxCurrentPriority;
+        entry.permille = 0;
+        entry.wakes = -1;
+
+        // Match against the previous snapshot by task number, as handles can be reused
+        for (UBaseType_t old = 0; old < snapshot_count; old++)
+        {
+            if (snapshot[old].xTaskNumber == current[index].xTaskNumber && elapsed > 0)
+            {
+                uint32_t used = current[index].ulRunTimeCounter - snapshot[old].ulRunTimeCounter;
+                entry.permille = ((uint64_t)used * 1000) / elapsed;
+                break;
+            }
+        }
+
+        uint8_t id = find_task_id (current[index].xHandle);
+        if (id < NUM_TASKS)
+        {
+            uint32_t wakes = task_wake_count ((TaskId)id);
+            entry.wakes = wakes - snapshot_wakes[id];
+            snapshot_wakes[id] = wakes;
+        }
+
+        for (uint8_t core = 0; core < 2; core++)
+        {
+            if (current[index].xHandle == xTaskGetIdleTaskHandleForCPU (core))
+            {
+                idle[core] = entry.permille;
+            }
+        }
+    }
+
+    memcpy (snapshot, current, sizeof (TaskStatus_t) * count);
+    snapshot_count = count;
+    snapshot_total = total;
+
+    uint32_t now = millis ();
+    portENTER_CRITICAL (&results_lock);
+    memcpy (results, fresh, sizeof (TaskCpu) * fresh_count);
+    result_count = fresh_count;
+    idle_permille[0] = idle[0];
+    idle_permille[1] = idle[1];
+    window_ms = now - last_sample_ms;
+    portEXIT_CRITICAL (&results_lock);
+    last_sample_ms = now;
+}
+
+/** @brief   Print tenths of a percent as a decimal number.
+ *  @param   out The device to which the number is printed
+ *  @param   permille The number in tenths of a percent
+*/
+static void print_percent (Print& out, uint16_t permille)
+{
+    out << (permille / 10) << "." << (permille % 10);
+}
+
+/** @brief   Take a consistent copy of the results of the last window.
+ *  @param   copy An array of @c STATS_CAPACITY entries to receive the results
+ *  @param   idle Array of two entries to receive the idle time of each core
+ *  @param   p_window Where to store the length of the window in milliseconds
+ *  @returns The number of tasks copied
+*/
+static UBaseType_t copy_results (TaskCpu* copy, uint16_t* idle, uint32_t* p_window)
+{
+    portENTER_CRITICAL (&results_lock);
+    UBaseType_t count = result_count;
+    memcpy (copy, results, sizeof (TaskCpu) * count);
+    idle[0] = idle_permille[0];
+    idle[1] = idle_permille[1];
+    *p_window = window_ms;
+    portEXIT_CRITICAL (&results_lock);
+    return count;
+}
+
+/** @brief   Print the CPU use of each task and core in human readable form.
+ *  @param   out The device to which the report is printed
+*/
+void cpu_stats_print (Print& out)
+{
+    static TaskCpu copy[STATS_CAPACITY];
+    uint16_t idle[2];
+    uint32_t window;
+    UBaseType_t count = copy_results (copy, idle, &window);
+
+    out << "Window: " << window << " ms" << endl;
+#if configGENERATE_RUN_TIME_STATS
+    for (uint8_t core = 0; core < 2; core++)
+    {
+        out << "Core " << core << " idle: ";
+        print_percent (out, idle[core]);
+        out << "%" << endl;
+    }
+#else
+    core_load_print (out);
+#endif
+    for (UBaseType_t index = 0; index < count; index++)
+    {
+        out << copy[index].name << " (core " << (int)copy[index].core << ", prio "
+            << (int)copy[index].priority << "): ";
+        print_percent (out, copy[index].permille);
+        out << "%";
+        if (copy[index].wakes >= 0)
+        {
+            out << ", " << copy[index].wakes << " wakes";
+        }
+        out << endl;
+    }
+}
+
+/** @brief   Write the CPU use of each task and core as a JSON object.
+ *  @param   out The device to which the JSON is written
+*/
+void cpu_stats_json (Print& out)
+{
+    static TaskCpu copy[STATS_CAPACITY];
+    uint16_t idle[2];
+    uint32_t window;
+    UBaseType_t count = copy_results (copy, idle, &window);
+
+#if !configGENERATE_RUN_TIME_STATS
+    idle[0] = 1000 - 10 * core_load_percent (0);
+    idle[1] = 1000 - 10 * core_load_percent (1);
+#endif
+
+    JsonWriter json (out);
+    json.begin_object ().value ("window_ms", window);
+    json.begin_array ("idle").fixed (NULL, idle[0], 1).fixed (NULL, idle[1], 1).end_array ();
+    json.begin_array ("tasks");
+    for (UBaseType_t index = 0; index < count; index++)
+    {
+        json.begin_object ()
+            .value ("name", copy[index].name)
+            .value ("core", (int)copy[index].core)
+            .value ("priority", (int)copy[index].priority)
+            .fixed ("cpu", copy[index].permille, 1)
+            .value ("wakes", copy[index].wakes)
+            .end_object ();
+    }
+    json.end_array ().end_object ();
+}
@@ -0,0 +1,20 @@
+/** @file cpu_stats.h
+ * This is the header file for the CPU profiler, which uses FreeRTOS run-time
+ * statistics to measure how much CPU time each task takes over a window.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _CPU_STATS_
+#define _CPU_STATS_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+void cpu_stats_sample (void);
+void cpu_stats_print (Print& out);
+void cpu_stats_json (Print& out);
+
+#endif
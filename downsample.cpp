@@ -0,0 +1,277 @@
+/** @file downsample.cpp
+ * This is the implementation file for the telemetry downsampler. Buckets
+ * are cut by record count, which is the same as by time since records are
+ * taken at a fixed rate. Records which are overwritten while a window is
+ * being worked through are left out.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <math.h>
+#include "downsample.h"
+#include "telemetry.h"
+
+/// Names of the fields, as used in web requests
+static const char* const field_names[NUM_FIELDS] = { "angle", "rate", "setpoint", "error", "effort" };
+
+
+/** @brief   Look up a field by name.
+ *  @param   name The name, such as @c "angle"
+ *  @param   field Set to the field if the name is known
+ *  @returns @c true if the name is known
+ */
+bool downsample_field (const char* name, TelemetryField& field)
+{
+    for (uint8_t index = 0; index < NUM_FIELDS; index++)
+    {
+        if (strcmp (name, field_names[index]) == 0)
+        {
+            field = (TelemetryField)index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief   Get the value of one field of a record.
+ *  @param   record The record
+ *  @param   field A @c TelemetryField
+ *  @returns The value, with the rate in degrees per second
+ */
+static float field_value (const TelemetryRecord& record, uint8_t field)
+{
+    switch (field)
+    {
+        case FIELD_RATE:        return record.rate / 131.0f;
+        case FIELD_SETPOINT:    return record.setpoint;
+        case FIELD_ERROR:       return record.error;
+        case FIELD_EFFORT:      return record.effort;
+        default:                return record.angle;
+    }
+}
+
+/** @brief   Return the index of the first record in a bucket.
+ *  @details For LTTB the first and last records of the window are kept as
+ *           they are, so the buckets share out the records between them.
+ *  @param   cursor The cursor
+ *  @param   bucket The bucket; @c buckets gives the end of the last bucket
+ */
+static uint32_t bucket_start (const DownsampleCursor& cursor, uint32_t bucket)
+{
+    if (cursor.method == DS_LTTB)
+    {
+        return cursor.first + 1 + (uint64_t)bucket * (cursor.count - 2) / cursor.buckets;
+    }
+    return cursor.first + (uint64_t)bucket * cursor.count / cursor.buckets;
+}
+
+/** @brief   Start working through a window of the ring.
+ *  @details If the window holds no more records than points asked for, every
+ *           record is kept.
+ *  @param   cursor The cursor which keeps track of the work
+ *  @param   first Index of the first record in the window
+ *  @param   end One past the index of the last record in the window
+ *  @param   points Most records to keep; the envelope keeps two per bucket
+ *  @param   method How the records are chosen
+ *  @param   field The value which is looked at to choose records
+ */
+void downsample_begin (DownsampleCursor& cursor, uint32_t first, uint32_t end, uint16_t points,
+                       DownsampleMethod method, TelemetryField field)
+{
+    cursor.first = first;
+    cursor.count = (end > first) ? end - first : 0;
+    cursor.bucket = 0;
+    cursor.next = first;
+    cursor.has_pending = false;
+    cursor.field = field;
+    cursor.kept_time = 0.0f;
+    cursor.kept_value = 0.0f;
+    cursor.start_us = 0;
+
+    if (method == DS_LTTB && points >= 3 && cursor.count > points)
+    {
+        cursor.buckets = points - 2;
+    }
+    else if (method == DS_MINMAX && points >= 2 && cursor.count > points)
+    {
+        cursor.buckets = points / 2;
+    }
+    else
+    {
+        method = DS_ALL;
+        cursor.buckets = 0;
+    }
+    cursor.method = method;
+
+    TelemetryRecord record;
+    if (telemetry_get (first, record))
+    {
+        cursor.start_us = record.time_us;
+        cursor.kept_value = field_value (record, field);
+    }
+}
+
+/** @brief   Find the records with the smallest and largest values in the next bucket.
+ *  @param   cursor The cursor
+ *  @param   index Set to the earlier of the two records
+ *  @returns @c true if a record was found, @c false once every bucket is done
+ */
+static bool next_minmax (DownsampleCursor& cursor, uint32_t& index)
+{
+    TelemetryRecord record;
+    while (cursor.bucket < cursor.buckets)
+    {
+        uint32_t start = bucket_start (cursor, cursor.bucket);
+        uint32_t stop = bucket_start (cursor, ++cursor.bucket);
+        uint32_t low_index = 0;
+        uint32_t high_index = 0;
+        float low = INFINITY;
+        float high = -INFINITY;
+        for (uint32_t at = start; at < stop; at++)
+        {
+            if (!telemetry_get (at, record))
+            {
+                continue;
+            }
+            float value = field_value (record, cursor.field);
+            if (value < low)
+            {
+                low = value;
+                low_index = at;
+            }
+            if (value > high)
+            {
+                high = value;
+                high_index = at;
+            }
+        }
+        if (low > high)
+        {
+            continue;                   // Nothing readable in this bucket
+        }
+        index = (low_index < high_index) ? low_index : high_index;
+        cursor.pending = (low_index < high_index) ? high_index : low_index;
+        cursor.has_pending = (low_index != high_index);
+        return true;
+    }
+    return false;
+}
+
+/** @brief   Choose the record to keep from the next LTTB bucket.
+ *  @param   cursor The cursor
+ *  @param   index Set to the record kept
+ *  @returns @c true if a record was chosen, @c false once the window is done
+ */
+static bool next_lttb (DownsampleCursor& cursor, uint32_t& index)
+{
+    TelemetryRecord record;
+
+    // Bucket 0 is the first record and bucket buckets + 1 the last
+    if (cursor.bucket == 0)
+    {
+        cursor.bucket++;
+        index = cursor.first;
+        return true;
+    }
+    while (cursor.bucket <= cursor.buckets)
+    {
+        uint32_t bucket = cursor.bucket++ - 1;
+
+        // The third corner of the triangle is the average of the next bucket
+        float next_time = 0.0f;
+        float next_value = 0.0f;
+        uint32_t readable = 0;
+        uint32_t start = (bucket + 1 < cursor.buckets) ? bucket_start (cursor, bucket + 1) : cursor.first + cursor.count - 1;
+        uint32_t stop = (bucket + 1 < cursor.buckets) ? bucket_start (cursor, bucket + 2) : cursor.first + cursor.count;
+        for (uint32_t at = start; at < stop; at++)
+        {
+            if (telemetry_get (at, record))
+            {
+                next_time += (record.time_us - cursor.start_us) / 1000.0f;
+                next_value += field_value (record, cursor.field);
+                readable++;
+            }
+        }
+        if (readable > 0)
+        {
+            next_time /= readable;
+            next_value /= readable;
+        }
+        else
+        {
+            next_time = cursor.kept_time;
+            next_value = cursor.kept_value;
+        }
+
+        float best_area = -1.0f;
+        stop = bucket_start (cursor, bucket + 1);
+        for (uint32_t at = bucket_start (cursor, bucket); at < stop; at++)
+        {
+            if (!telemetry_get (at, record))
+            {
+                continue;
+            }
+            float time = (record.time_us - cursor.start_us) / 1000.0f;
+            float value = field_value (record, cursor.field);
+            float area = fabsf ((cursor.kept_time - next_time) * (value - cursor.kept_value)
+                                - (cursor.kept_time - time) * (next_value - cursor.kept_value));
+            if (area > best_area)
+            {
+                best_area = area;
+                index = at;
+            }
+        }
+        if (best_area >= 0.0f)
+        {
+            telemetry_get (index, record);
+            cursor.kept_time = (record.time_us - cursor.start_us) / 1000.0f;
+            cursor.kept_value = field_value (record, cursor.field);
+            return true;
+        }
+    }
+    if (cursor.bucket == cursor.buckets + 1)
+    {
+        cursor.bucket++;
+        index = cursor.first + cursor.count - 1;
+        return true;
+    }
+    return false;
+}
+
+/** @brief   Get the index of the next record to keep.
+ *  @details Indices are handed out in time order. The record itself should
+ *           be read with @c telemetry_get(), which fails if it has been
+ *           overwritten since it was chosen.
+ *  @param   cursor The cursor from @c downsample_begin()
+ *  @param   index Set to the index of the record
+ *  @returns @c true if there is a record, @c false once the window is done
+ */
+bool downsample_next (DownsampleCursor& cursor, uint32_t& index)
+{
+    if (cursor.has_pending)
+    {
+        cursor.has_pending = false;
+        index = cursor.pending;
+        return true;
+    }
+    switch (cursor.method)
+    {
+        case DS_MINMAX:
+            return next_minmax (cursor, index);
+        case DS_LTTB:
+            return next_lttb (cursor, index);
+        default:
+            if (cursor.next < telemetry_oldest ())
+            {
+                cursor.next = telemetry_oldest ();     // Overwritten while we were sending
+            }
+            if (cursor.next >= cursor.first + cursor.count)
+            {
+                return false;
+            }
+            index = cursor.next++;
+            return true;
+    }
+}
@@ -0,0 +1,70 @@
+/** @file downsample.h
+ * This is the header file for the telemetry downsampler, which picks a few
+ * hundred records out of a long window of the telemetry ring so a plot of
+ * the whole window can be sent quickly without hiding short transients. Two
+ * methods are offered:
+ * 
+ * - Min/max envelope: the window is cut into buckets and the records with
+ *   the smallest and largest value in each bucket are kept, in time order.
+ * - Largest-Triangle-Three-Buckets (LTTB): one record is kept per bucket,
+ *   the one which makes the largest triangle with the record kept from the
+ *   bucket before and the average of the bucket after. This keeps the shape
+ *   of the curve with half as many points as the envelope.
+ * 
+ * Either way the result is a subset of the records, so it can be written in
+ * the same format as the raw ring. The work is done a bucket at a time as
+ * the records are asked for.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _DOWNSAMPLE_
+#define _DOWNSAMPLE_
+
+#include <Arduino.h>
+
+/// Ways of choosing which records to keep
+enum DownsampleMethod
+{
+    DS_ALL,                 ///< Keep every record
+    DS_MINMAX,              ///< Keep the smallest and largest value of each bucket
+    DS_LTTB                 ///< Largest-Triangle-Three-Buckets
+};
+
+/// Value of each record which the downsampler looks at
+enum TelemetryField
+{
+    FIELD_ANGLE,            ///< Measured angle
+    FIELD_RATE,             ///< Gyroscope rate
+    FIELD_SETPOINT,         ///< Desired angle
+    FIELD_ERROR,            ///< Control error
+    FIELD_EFFORT,           ///< Motor effort
+    NUM_FIELDS
+};
+
+/** @brief Position in a downsampled window of the telemetry ring
+*/
+struct DownsampleCursor
+{
+    uint32_t first;         ///< Index of the first record in the window
+    uint32_t count;         ///< Number of records in the window
+    uint32_t buckets;       ///< Number of buckets the window is cut into
+    uint32_t bucket;        ///< Bucket being worked on
+    uint32_t next;          ///< Next record to hand out when keeping every record
+    uint32_t pending;       ///< Second record found in a min/max bucket
+    bool has_pending;       ///< @c true if @c pending is still to be handed out
+    uint8_t method;         ///< A @c DownsampleMethod
+    uint8_t field;          ///< A @c TelemetryField
+    float kept_time;        ///< LTTB: time of the record last kept, in ms from the start of the window
+    float kept_value;       ///< LTTB: value of the record last kept
+    uint32_t start_us;      ///< Time of the first record in the window
+};
+
+bool downsample_field (const char* name, TelemetryField& field);
+void downsample_begin (DownsampleCursor& cursor, uint32_t first, uint32_t end, uint16_t points,
+                       DownsampleMethod method, TelemetryField field);
+bool downsample_next (DownsampleCursor& cursor, uint32_t& index);
+
+#endif
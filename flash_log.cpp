@@ -0,0 +1,314 @@
+/** @file flash_log.cpp
+ * This is the implementation file for the flash log. The flash log task
+ * reads the telemetry ring through its own cursor, as a streaming client
+ * does, so the control task does no extra work for it. Records are packed
+ * into a block in RAM and each full block is appended to the current
+ * segment with one write, so LittleFS fills flash blocks in sequence instead
+ * of rewriting a partly filled block for each small append. The file is only
+ * synced every @c FLASH_SYNC_BLOCKS blocks, which bounds both the metadata
+ * writes and the data a reset can lose.
+ * 
+ * Writing flash stalls both cores while each page is programmed, so the task
+ * writes at most one block per pass. If flash falls so far behind that the
+ * telemetry ring overwrites records the task hasn't read, those records are
+ * counted as dropped and logging carries on from the oldest record left;
+ * each block header holds the drop count, so gaps show up in the decoded log.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <LittleFS.h>
+#include "flash_log.h"
+#include "task_config.h"
+#include "logger.h"
+#include "storage.h"
+
+const uint32_t FLASH_LOG_PERIOD_MS = 200;   ///< Time between passes of the flash log task
+const uint8_t FLASH_SYNC_BLOCKS = 4;        ///< Blocks written between syncs of the segment file
+const size_t FLASH_RESERVE_BYTES = 64 * 1024;   ///< Flash left free for the black box
+
+static const char FLASH_LOG_DIR[] = "/log";     ///< Directory in LittleFS holding the segments
+
+static uint8_t block[FLASH_BLOCK_BYTES];    ///< Block being filled; flash log task only
+static File segment;                        ///< Segment being written; flash log task only
+
+static bool enabled = false;                ///< @c true once the directory is ready
+static uint32_t oldest_id = 0;              ///< Number of the oldest segment in flash
+static uint32_t current_id = 0;             ///< Number of the segment being written, or the next one
+static bool current_open = false;           ///< @c true while @c segment is open
+static uint8_t current_blocks = 0;          ///< Blocks written to the current segment
+static uint32_t blocks_written = 0;         ///< Blocks written since boot
+static uint32_t write_errors = 0;           ///< Blocks which couldn't be written
+static uint32_t dropped = 0;                ///< Records lost since boot
+static uint32_t slowest_write_us = 0;       ///< Longest time taken to write one block
+
+
+/** @brief   Make the path of a segment in LittleFS.
+ *  @param   id Number of the segment
+ *  @param   path Where the path is put
+ *  @param   size Size of @c path in bytes
+*/
+static void make_path (uint32_t id, char* path, size_t size)
+{
+    snprintf (path, size, "%s/%05lu.tlm", FLASH_LOG_DIR, (unsigned long)id);
+}
+
+/** @brief   Find the path of a segment, for downloading it.
+ *  @param   id Number of the segment
+ *  @param   path Where the path is put
+ *  @param   size Size of @c path in bytes
+ *  @returns @c true if the segment is in flash
+*/
+bool flash_log_segment_path (uint32_t id, char* path, size_t size)
+{
+    if (!enabled)
+    {
+        return false;
+    }
+    make_path (id, path, size);
+    return LittleFS.exists (path);
+}
+
+/** @brief   Return @c true if a segment is still being written.
+ *  @details Such a segment can't be downloaded until it is complete.
+ *  @param   id Number of the segment
+*/
+bool flash_log_segment_open (uint32_t id)
+{
+    return current_open && id == current_id;
+}
+
+/** @brief   Get the number of a segment from its file name.
+ *  @param   name The file name, with or without the directory
+ *  @param   id Where the number is put
+ *  @returns @c true if the file is a segment
+*/
+static bool parse_name (const char* name, uint32_t& id)
+{
+    const char* slash = strrchr (name, '/');
+    if (slash)
+    {
+        name = slash + 1;
+    }
+    char* end;
+    id = strtoul (name, &end, 10);
+    return end != name && strcmp (end, ".tlm") == 0;
+}
+
+/** @brief   Find the oldest and newest segments left from earlier sessions.
+*/
+static void scan_segments (void)
+{
+    bool any = false;
+    uint32_t newest = 0;
+    File directory = LittleFS.open (FLASH_LOG_DIR);
+    for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+    {
+        uint32_t id;
+        if (parse_name (file.name (), id))
+        {
+            oldest_id = (!any || id < oldest_id) ? id : oldest_id;
+            newest = (!any || id > newest) ? id : newest;
+            any = true;
+        }
+    }
+    current_id = any ? newest + 1 : 0;
+    oldest_id = any ? oldest_id : 0;
+}
+
+/** @brief   Start a new segment, deleting old ones to make room for it.
+ *  @returns @c true if the segment is open
+*/
+static bool open_segment (void)
+{
+    char path[24];
+    while (oldest_id < current_id
+           && (current_id - oldest_id >= FLASH_LOG_SEGMENTS
+               || storage_free () < FLASH_SEGMENT_BLOCKS * FLASH_BLOCK_BYTES + FLASH_RESERVE_BYTES))
+    {
+        make_path (oldest_id++, path, sizeof (path));
+        LittleFS.remove (path);
+    }
+
+    make_path (current_id, path, sizeof (path));
+    segment = LittleFS.open (path, "w");
+    if (!segment)
+    {
+        return false;
+    }
+    current_open = true;
+    current_blocks = 0;
+    LOG_INFO (MOD_MAIN, FMT_FLOG_SEGMENT, current_id, storage_free ());
+    return true;
+}
+
+/** @brief   Finish the current segment.
+*/
+static void close_segment (void)
+{
+    segment.close ();
+    current_open = false;
+    current_id++;
+}
+
+/** @brief   Append the filled block to the current segment.
+ *  @returns @c true if the block was written
+*/
+static bool write_block (void)
+{
+    const FlashBlockHeader* header = (const FlashBlockHeader*)block;
+    if (!current_open && !open_segment ())
+    {
+        write_errors++;
+        dropped += header->count;
+        return false;
+    }
+
+    uint32_t start = micros ();
+    bool ok = segment.write (block, FLASH_BLOCK_BYTES) == FLASH_BLOCK_BYTES;
+    if (ok && ++current_blocks % FLASH_SYNC_BLOCKS == 0)
+    {
+        segment.flush ();
+    }
+    uint32_t took = micros () - start;
+    slowest_write_us = took > slowest_write_us ? took : slowest_write_us;
+
+    if (!ok)
+    {
+        // A partly written block would be skipped by the decoder anyway; start afresh
+        write_errors++;
+        dropped += header->count;
+        LOG_ERROR (MOD_MAIN, FMT_FLOG_WRITE_FAILED, current_id, header->count);
+        close_segment ();
+        return false;
+    }
+    blocks_written++;
+    if (current_blocks >= FLASH_SEGMENT_BLOCKS)
+    {
+        close_segment ();
+    }
+    return true;
+}
+
+/** @brief   Write the flash log's counters and the segments in flash as a JSON object.
+ *  @param   out The device to which the object is written
+*/
+void flash_log_json (Print& out)
+{
+    JsonWriter json (out);
+    json.begin_object ();
+    json.value ("enabled", enabled);
+    json.value ("current", current_id);
+    json.value ("blocks", blocks_written);
+    json.value ("dropped", dropped);
+    json.value ("write_errors", write_errors);
+    json.value ("slowest_write_us", slowest_write_us);
+    json.value ("free_bytes", (unsigned long)storage_free ());
+
+    json.begin_array ("segments");
+    if (enabled)
+    {
+        File directory = LittleFS.open (FLASH_LOG_DIR);
+        for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+        {
+            uint32_t id;
+            if (parse_name (file.name (), id))
+            {
+                json.begin_object ();
+                json.value ("id", id);
+                json.value ("bytes", (unsigned long)file.size ());
+                json.value ("open", flash_log_segment_open (id));
+                json.end_object ();
+            }
+        }
+    }
+    json.end_array ();
+    json.end_object ();
+}
+
+/** @brief   Print the flash log's counters.
+ *  @param   out The device to which the report is printed
+*/
+void flash_log_print (Print& out)
+{
+    if (!enabled)
+    {
+        out << "Flash log: disabled" << endl;
+        return;
+    }
+    out << "Flash log: segments " << oldest_id << " to " << current_id
+        << (current_open ? " (writing)" : "") << ", " << blocks_written << " blocks written, "
+        << dropped << " records dropped, " << write_errors << " write errors" << endl;
+    out << "Slowest block write " << slowest_write_us << " us" << endl;
+    storage_print (out);
+}
+
+/** @brief   Task which copies the telemetry ring into segment files in flash.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_FLASH_LOG (void* p_params)
+{
+    FlashBlockHeader* header = (FlashBlockHeader*)block;
+    TelemetryRecord* records = (TelemetryRecord*)(block + sizeof (FlashBlockHeader));
+
+    if (!storage_ready () || !(LittleFS.exists (FLASH_LOG_DIR) || LittleFS.mkdir (FLASH_LOG_DIR)))
+    {
+        // The task isn't deleted, as the memory report still looks at its stack
+        while (true)
+        {
+            vTaskDelay (portMAX_DELAY);
+        }
+    }
+    scan_segments ();
+    enabled = true;
+
+    // Log from now on; what is already in the ring is from before the session
+    uint32_t cursor = telemetry_count ();
+    memcpy (header->magic, "GSLB", 4);
+    header->version = FLASH_LOG_VERSION;
+    header->decimation = FLASH_LOG_DECIMATION;
+    header->count = 0;
+    TickType_t last_wake = xTaskGetTickCount ();
+
+    while (true)
+    {
+        vTaskDelayUntil (&last_wake, pdMS_TO_TICKS (FLASH_LOG_PERIOD_MS));
+        task_woke (TASK_FLASH_LOG);
+
+        while (cursor < telemetry_count () && header->count < FLASH_BLOCK_RECORDS)
+        {
+            uint32_t oldest = telemetry_oldest ();
+            if (cursor < oldest)
+            {
+                dropped += (oldest - cursor + FLASH_LOG_DECIMATION - 1) / FLASH_LOG_DECIMATION;
+                cursor = oldest;
+            }
+            if (cursor % FLASH_LOG_DECIMATION == 0)
+            {
+                if (header->count == 0)
+                {
+                    header->first_index = cursor;
+                    header->dropped = dropped;
+                }
+                if (telemetry_get (cursor, records[header->count]))
+                {
+                    header->count++;
+                }
+                else
+                {
+                    dropped++;
+                }
+            }
+            cursor++;
+        }
+
+        // At most one block per pass, so flash writes take a bounded share of time
+        if (header->count == FLASH_BLOCK_RECORDS)
+        {
+            write_block ();
+            header->count = 0;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/** @file flash_log.h
+ * This is the header file for the flash log, which copies the telemetry ring
+ * into LittleFS so that a whole shoot can be analysed afterwards. Records go
+ * into rotating segment files of @c FLASH_SEGMENT_BLOCKS blocks each; when
+ * @c FLASH_LOG_SEGMENTS segments exist, or flash is nearly full, the oldest
+ * segment is deleted to make room for the next.
+ * 
+ * Each block is @c FLASH_BLOCK_BYTES long, the size of a LittleFS block, and
+ * is a @c FlashBlockHeader followed by up to @c FLASH_BLOCK_RECORDS
+ * @c TelemetryRecord structures. Blocks stand alone, so a segment cut short
+ * by a reset still decodes up to its last whole block; tools/flash_log_csv.py
+ * turns segments into CSV. The segments are listed at GET @c /api/v1/log and
+ * downloaded from @c /api/v1/log?segment=N.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _FLASH_LOG_
+#define _FLASH_LOG_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "telemetry.h"
+#include "json_writer.h"
+
+const size_t FLASH_BLOCK_BYTES = 4096;      ///< Bytes written to flash at a time; one LittleFS block
+const uint8_t FLASH_SEGMENT_BLOCKS = 16;    ///< Blocks in each segment file; 64 KB, about 33 s at 100 Hz
+const uint8_t FLASH_LOG_SEGMENTS = 16;      ///< Most segments kept; older ones are deleted
+const uint8_t FLASH_LOG_DECIMATION = 1;     ///< Only every this many control cycles is logged
+const uint8_t FLASH_LOG_VERSION = 1;        ///< Version of the block layout, for tools/flash_log_csv.py
+
+/** @brief Header at the start of each block in a segment file
+*/
+struct FlashBlockHeader
+{
+    char magic[4];          ///< "GSLB"
+    uint8_t version;        ///< @c FLASH_LOG_VERSION
+    uint8_t decimation;     ///< @c FLASH_LOG_DECIMATION
+    uint16_t count;         ///< Records in this block
+    uint32_t first_index;   ///< Telemetry ring index of the first record in this block
+    uint32_t dropped;       ///< Records dropped since boot before this block was written
+};
+
+/// Records which fit in one block after its header
+const uint16_t FLASH_BLOCK_RECORDS = (FLASH_BLOCK_BYTES - sizeof (FlashBlockHeader)) / sizeof (TelemetryRecord);
+
+static_assert (sizeof (FlashBlockHeader) == 16, "tools/flash_log_csv.py expects a 16 byte block header");
+static_assert (sizeof (TelemetryRecord) == 20, "tools/flash_log_csv.py expects 20 byte records");
+
+bool flash_log_segment_path (uint32_t id, char* path, size_t size);
+bool flash_log_segment_open (uint32_t id);
+void flash_log_json (Print& out);
+void flash_log_print (Print& out);
+
+#endif
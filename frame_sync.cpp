@@ -0,0 +1,162 @@
+/** @file frame_sync.cpp
+ * This is the implementation file for the camera frame sync input. The
+ * interrupt handler is the only writer of the edge ring and works as the
+ * telemetry ring does. It runs from IRAM, as it may fire while flash is being
+ * written, so it only reads the clock, stores the time and wakes the frame
+ * sync task; the task passes each new edge to the logger.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "frame_sync.h"
+#include "task_config.h"
+#include "logger.h"
+#include "json_writer.h"
+
+static uint32_t ring[FRAME_SYNC_RING_SIZE];     ///< Times of the most recent edges, oldest overwritten first
+static std::atomic<uint32_t> written (0);       ///< Number of edges ever recorded
+static volatile uint32_t last_edge_us = 0;      ///< Time of the last edge recorded
+static volatile uint32_t glitches = 0;          ///< Edges thrown away for coming too soon after the last
+static uint32_t missed = 0;                     ///< Edges overwritten before the task logged them
+static TaskHandle_t sync_task = NULL;           ///< Task woken for each edge
+static uint8_t sync_pin = 0;                    ///< The input pin, for reports
+
+
+/** @brief   Interrupt handler which records the time of an edge.
+*/
+static void IRAM_ATTR on_edge (void)
+{
+    uint32_t now = micros ();
+    uint32_t index = written.load (std::memory_order_relaxed);
+    if (index > 0 && now - last_edge_us < FRAME_SYNC_MIN_US)
+    {
+        glitches = glitches + 1;
+        return;
+    }
+    last_edge_us = now;
+    ring[index % FRAME_SYNC_RING_SIZE] = now;
+    written.store (index + 1, std::memory_order_release);
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR (sync_task, &woken);
+    portYIELD_FROM_ISR (woken);
+}
+
+/** @brief   Start timestamping edges on the sync input.
+ *  @details The frame sync task must already be running.
+ *  @param   pin The GPIO pin the camera's sync output is wired to
+ *  @param   mode @c RISING or @c FALLING, whichever marks the start of a frame
+*/
+void frame_sync_begin (uint8_t pin, int mode)
+{
+    sync_pin = pin;
+    sync_task = task_handle (TASK_FRAME_SYNC);
+    log_set_rate (MOD_SYNC, FRAME_SYNC_LOG_RATE, 10);
+    pinMode (pin, INPUT_PULLUP);
+    attachInterrupt (digitalPinToInterrupt (pin), on_edge, mode);
+}
+
+/** @brief   Return the number of edges recorded since boot.
+ *  @details This is one more than the number of the newest edge.
+*/
+uint32_t frame_sync_count (void)
+{
+    return written.load (std::memory_order_acquire);
+}
+
+/** @brief   Get the time of an edge.
+ *  @param   index Number of the edge, counted from the first since boot
+ *  @param   time_us Where the time is put
+ *  @returns @c true if the time was copied, @c false if the edge hasn't
+ *           happened yet or has already been overwritten
+*/
+bool frame_sync_get (uint32_t index, uint32_t& time_us)
+{
+    uint32_t count = frame_sync_count ();
+    if (index >= count || count - index > FRAME_SYNC_RING_SIZE)
+    {
+        return false;
+    }
+    time_us = ring[index % FRAME_SYNC_RING_SIZE];
+    std::atomic_thread_fence (std::memory_order_acquire);
+    return written.load (std::memory_order_relaxed) - index < FRAME_SYNC_RING_SIZE;
+}
+
+/** @brief   Write the edge counts and the most recent edges as a JSON object.
+ *  @details Each edge is listed as @c [number, time_us], oldest first.
+ *  @param   out The device to which the object is written
+*/
+void frame_sync_json (Print& out)
+{
+    uint32_t count = frame_sync_count ();
+    uint32_t first = count > FRAME_SYNC_REPORT ? count - FRAME_SYNC_REPORT : 0;
+
+    JsonWriter json (out);
+    json.begin_object ();
+    json.value ("pin", sync_pin);
+    json.value ("edges", count);
+    json.value ("glitches", glitches);
+    json.value ("now_us", micros ());
+    json.begin_array ("recent");
+    for (uint32_t index = first; index < count; index++)
+    {
+        uint32_t time_us;
+        if (frame_sync_get (index, time_us))
+        {
+            json.begin_array ().value (NULL, index).value (NULL, time_us).end_array ();
+        }
+    }
+    json.end_array ();
+    json.end_object ();
+}
+
+/** @brief   Print the edge counts and the rate of recent edges.
+ *  @param   out The device to which the report is printed
+*/
+void frame_sync_print (Print& out)
+{
+    uint32_t count = frame_sync_count ();
+    out << "Frame sync on GPIO " << sync_pin << ": " << count << " edges, " << glitches
+        << " glitches, " << missed << " not logged" << endl;
+
+    uint32_t first_us, last_us;
+    uint32_t first = count > FRAME_SYNC_RING_SIZE / 2 ? count - FRAME_SYNC_RING_SIZE / 2 : 0;
+    if (count >= 2 && frame_sync_get (first, first_us) && frame_sync_get (count - 1, last_us)
+        && last_us != first_us)
+    {
+        out << "Recent rate " << (count - 1 - first) * 1e6f / (last_us - first_us) << " Hz, last edge "
+            << micros () - last_us << " us ago" << endl;
+    }
+}
+
+/** @brief   Task which logs each edge recorded by the interrupt handler.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_FRAME_SYNC (void* p_params)
+{
+    uint32_t cursor = 0;
+
+    while (true)
+    {
+        ulTaskNotifyTake (pdTRUE, portMAX_DELAY);
+        task_woke (TASK_FRAME_SYNC);
+
+        uint32_t count = frame_sync_count ();
+        while (cursor < count)
+        {
+            uint32_t time_us;
+            if (frame_sync_get (cursor, time_us))
+            {
+                LOG_INFO (MOD_SYNC, FMT_FRAME_SYNC, cursor, time_us);
+            }
+            else
+            {
+                missed++;
+            }
+            cursor++;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/** @file frame_sync.h
+ * This is the header file for the camera frame sync input. A camera's sync
+ * or flash output is wired to a GPIO pin; each edge is timestamped in an
+ * interrupt with @c micros(), the clock the IMU samples are stamped with,
+ * so logged motion can be lined up with video frames.
+ * 
+ * Every edge is logged by the @c MOD_SYNC module as a numbered
+ * @c FMT_FRAME_SYNC message, and the most recent edges are kept in RAM for
+ * GET @c /api/v1/sync. While a gyro log take is being recorded, every edge
+ * is also saved in the take file next to the IMU samples; see gyro_log.h.
+ * tools/sync_align.py fits the edges against the camera's frame times to
+ * find the offset and drift between the two clocks.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _FRAME_SYNC_
+#define _FRAME_SYNC_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+const uint16_t FRAME_SYNC_RING_SIZE = 256;  ///< Edges kept in RAM
+const uint32_t FRAME_SYNC_MIN_US = 1000;    ///< Edges closer than this to the last one are counted as glitches
+const uint16_t FRAME_SYNC_REPORT = 100;     ///< Most edges listed by @c frame_sync_json()
+const uint16_t FRAME_SYNC_LOG_RATE = 250;   ///< Edges per second the logger lets through
+
+void frame_sync_begin (uint8_t pin, int mode);
+uint32_t frame_sync_count (void);
+bool frame_sync_get (uint32_t index, uint32_t& time_us);
+void frame_sync_json (Print& out);
+void frame_sync_print (Print& out);
+
+#endif
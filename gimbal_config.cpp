@@ -0,0 +1,240 @@
+/** @file gimbal_config.cpp
+ * This is the implementation file for the gimbal's run-time settings. New
+ * settings are put into the mailbox inside a critical section, so the task
+ * applying them (the AsyncTCP task, for the web API) can't be preempted in
+ * the middle of a write and leave the control tasks spinning; the spinlock
+ * also keeps two writes from overlapping. The mode and the calibration
+ * request are atomics which any task may change.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "gimbal_config.h"
+#include "json_writer.h"
+#include "lockfree.h"
+#include "logger.h"
+
+/// Where calibration has got to
+enum CalibrationState
+{
+    CAL_IDLE,               ///< No calibration asked for
+    CAL_REQUESTED,          ///< Asked for; the acquisition task hasn't started it yet
+    CAL_RUNNING             ///< The acquisition task is summing readings
+};
+
+/// Settings in effect at boot
+static const GimbalConfig CONFIG_DEFAULTS =
+{
+#define CONFIG_DEFAULT(name, type, initial, low, high, text) initial,
+    CONFIG_FIELDS (CONFIG_DEFAULT)
+#undef CONFIG_DEFAULT
+};
+
+/// Names of the modes, for the API and reports
+static const char* const mode_names[NUM_MODES] =
+{
+#define GIMBAL_MODE_NAME(id, name, text) name,
+    GIMBAL_MODES (GIMBAL_MODE_NAME)
+#undef GIMBAL_MODE_NAME
+};
+
+static Mailbox<GimbalConfig> settings;                      ///< Settings applied since boot, if any
+static portMUX_TYPE settings_lock = portMUX_INITIALIZER_UNLOCKED;  ///< Makes each write of @c settings one step
+static std::atomic<uint8_t> mode (MODE_STABILIZE);          ///< The operating mode
+static std::atomic<uint8_t> cal_state (CAL_IDLE);           ///< A @c CalibrationState
+static std::atomic<uint32_t> calibrations (0);              ///< Calibrations finished since boot
+static std::atomic<uint32_t> cal_failures (0);              ///< Calibrations which gave up before enough readings arrived
+
+
+/** @brief   Get the settings now in effect.
+ *  @param   config A reference to where the settings are copied
+ */
+void gimbal_config_get (GimbalConfig& config)
+{
+    if (!settings.get (config))
+    {
+        config = CONFIG_DEFAULTS;
+    }
+}
+
+/** @brief   Return how many times the settings have been changed since boot.
+ *  @details A task can keep the last version it saw and only redo its setup
+ *           when this changes.
+ */
+uint32_t gimbal_config_version (void)
+{
+    return settings.writes ();
+}
+
+/** @brief   Change some of the settings.
+ *  @details The members of the JSON object name the settings to be changed;
+ *           the others keep their values. Nothing is changed unless every
+ *           member is a known setting with an integer value in its range.
+ *           Any task may call this; the write takes a few microseconds with
+ *           interrupts off on the calling core.
+ *  @param   json A reader over the request body
+ *  @returns @c NULL if the settings were changed, or what was wrong
+ */
+const char* gimbal_config_apply (JsonReader& json)
+{
+    GimbalConfig config;
+    gimbal_config_get (config);
+
+    JsonMember member;
+    while (json.next (member))
+    {
+        bool known = false;
+#define CONFIG_PARSE(name, kind, initial, low, high, text) \
+        if (member.key_is (#name)) \
+        { \
+            if (member.type != JSON_NUMBER || member.number < (low) || member.number > (high)) \
+            { \
+                return "Value out of range: " #name; \
+            } \
+            config.name = (kind)member.number; \
+            known = true; \
+        }
+        CONFIG_FIELDS (CONFIG_PARSE)
+#undef CONFIG_PARSE
+        if (!known)
+        {
+            return "Unknown setting";
+        }
+    }
+    if (!json.ok ())
+    {
+        return "Body must be a flat JSON object";
+    }
+
+    portENTER_CRITICAL (&settings_lock);
+    settings.put (config);
+    portEXIT_CRITICAL (&settings_lock);
+    LOG_INFO (MOD_CONTROL, FMT_CONFIG_SET, settings.writes ());
+    return NULL;
+}
+
+/** @brief   Write the settings now in effect as a JSON object.
+ *  @param   out The device to which the object is written
+ */
+void gimbal_config_json (Print& out)
+{
+    GimbalConfig config;
+    gimbal_config_get (config);
+
+    JsonWriter json (out);
+    json.begin_object ();
+    json.value ("version", gimbal_config_version ());
+#define CONFIG_JSON(name, type, initial, low, high, text) json.value (#name, (long)config.name);
+    CONFIG_FIELDS (CONFIG_JSON)
+#undef CONFIG_JSON
+    json.end_object ();
+}
+
+/** @brief   Return the operating mode.
+ */
+GimbalMode gimbal_mode (void)
+{
+    return (GimbalMode)mode.load ();
+}
+
+/** @brief   Change the operating mode.
+ *  @param   new_mode The mode to be used from the next control cycle
+ */
+void gimbal_set_mode (GimbalMode new_mode)
+{
+    if (new_mode < NUM_MODES && mode.exchange (new_mode) != new_mode)
+    {
+        LOG_INFO (MOD_CONTROL, FMT_MODE_SET, new_mode);
+    }
+}
+
+/** @brief   Return the name of a mode, as used by the API.
+ *  @param   which The mode
+ */
+const char* gimbal_mode_name (GimbalMode which)
+{
+    return (which < NUM_MODES) ? mode_names[which] : "?";
+}
+
+/** @brief   Look up a mode by the name given in a JSON member.
+ *  @param   member A member whose value should be a mode's name
+ *  @param   which Set to the mode if the name is known
+ *  @returns @c true if the name is known
+ */
+bool gimbal_mode_parse (const JsonMember& member, GimbalMode& which)
+{
+    for (uint8_t index = 0; index < NUM_MODES; index++)
+    {
+        if (member.text_is (mode_names[index]))
+        {
+            which = (GimbalMode)index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief   Ask the acquisition task to recalibrate the IMU.
+ *  @details The gimbal must be held level while the readings are taken; the
+ *           pitch motor is braked until the calibration is done.
+ *  @returns @c true if the request was taken, @c false if a calibration is
+ *           already under way
+ */
+bool gimbal_calibrate_request (void)
+{
+    uint8_t expected = CAL_IDLE;
+    return cal_state.compare_exchange_strong (expected, CAL_REQUESTED);
+}
+
+/** @brief   Check for and take a calibration request; for the acquisition task.
+ *  @returns @c true if a calibration should be started now
+ */
+bool gimbal_calibrate_start (void)
+{
+    uint8_t expected = CAL_REQUESTED;
+    return cal_state.compare_exchange_strong (expected, CAL_RUNNING);
+}
+
+/** @brief   Report that a calibration has finished; for the acquisition task.
+ *  @param   ok @c true if new offsets are in effect
+ */
+void gimbal_calibrate_done (bool ok)
+{
+    if (ok)
+    {
+        calibrations++;
+    }
+    else
+    {
+        cal_failures++;
+    }
+    cal_state.store (CAL_IDLE);
+}
+
+/** @brief   Return @c true while a calibration is asked for or under way.
+ */
+bool gimbal_calibrating (void)
+{
+    return cal_state.load () != CAL_IDLE;
+}
+
+/** @brief   Print the settings, their ranges and the mode.
+ *  @param   out The device to which the report is printed
+ */
+void gimbal_config_print (Print& out)
+{
+    GimbalConfig config;
+    gimbal_config_get (config);
+
+    out << "Settings, version " << gimbal_config_version () << ":" << endl;
+#define CONFIG_PRINT(name, type, initial, low, high, text) \
+    out << "  " #name " = " << (long)config.name << " (" << (low) << " to " << (high) << ") " text << endl;
+    CONFIG_FIELDS (CONFIG_PRINT)
+#undef CONFIG_PRINT
+    out << "Mode: " << gimbal_mode_name (gimbal_mode ())
+        << (gimbal_calibrating () ? ", calibrating" : "") << endl;
+    out << "Calibrations: " << calibrations.load () << " done, " << cal_failures.load () << " failed" << endl;
+}
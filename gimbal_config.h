@@ -0,0 +1,80 @@
+/** @file gimbal_config.h
+ * This is the header file for the gimbal's settings which can be changed
+ * while it runs: the controller gains and limits, the angle filter, the
+ * setpoint slew rate and the length of a calibration, plus the operating mode
+ * and requests to recalibrate. The control tasks read the settings through a
+ * @c Mailbox each cycle, so a change takes effect on the next sample without
+ * any lock on the control core.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _GIMBAL_CONFIG_
+#define _GIMBAL_CONFIG_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "json_reader.h"
+
+/** @brief   The table of settings.
+ *  @details Each line gives the name, which is also the JSON key, the type,
+ *           the value at boot, the smallest and largest values accepted and a
+ *           description.
+ */
+#define CONFIG_FIELDS(X) \
+    X (home,         int16_t,   0,  -90,   90, "Pitch angle in degrees held when no remote setpoint is fresh") \
+    X (accept,       int16_t,  10,    0,   45, "Errors in degrees smaller than this make the motor brake") \
+    X (kp,           int16_t,  10, -100,  100, "Proportional gain; its sign picks the drive direction") \
+    X (duty_forward, uint8_t,  25,    0,  255, "Duty cycle for channel 1 of the pitch motor") \
+    X (duty_reverse, uint8_t,  50,    0,  255, "Duty cycle for channel 2 of the pitch motor") \
+    X (smoothing,    uint8_t,   0,    0,    6, "Angle filter: each sample moves the angle 1/2^n of the way, 0 for none") \
+    X (slew_rate,    uint16_t,  0,    0, 1000, "Most degrees per second the setpoint moves, 0 for no limit") \
+    X (cal_samples,  uint16_t, 200,  10, 1000, "Readings averaged by a calibration")
+
+/** @brief Every setting, as listed in @c CONFIG_FIELDS
+*/
+struct GimbalConfig
+{
+#define CONFIG_MEMBER(name, type, initial, low, high, text) type name;
+    CONFIG_FIELDS (CONFIG_MEMBER)
+#undef CONFIG_MEMBER
+};
+
+/** @brief   The table of operating modes.
+ *  @details Each line gives an ID, the name used by the API and a description.
+ */
+#define GIMBAL_MODES(X) \
+    X (MODE_STABILIZE, "stabilize", "hold the remote setpoint while it is fresh, otherwise home") \
+    X (MODE_LOCAL,     "local",     "hold home, ignoring remote setpoints") \
+    X (MODE_IDLE,      "idle",      "brake the motors")
+
+/// Operating modes, as listed in @c GIMBAL_MODES
+enum GimbalMode
+{
+#define GIMBAL_MODE_ID(id, name, text) id,
+    GIMBAL_MODES (GIMBAL_MODE_ID)
+#undef GIMBAL_MODE_ID
+    NUM_MODES
+};
+
+void gimbal_config_get (GimbalConfig& config);
+uint32_t gimbal_config_version (void);
+const char* gimbal_config_apply (JsonReader& json);
+void gimbal_config_json (Print& out);
+
+GimbalMode gimbal_mode (void);
+void gimbal_set_mode (GimbalMode mode);
+const char* gimbal_mode_name (GimbalMode mode);
+bool gimbal_mode_parse (const JsonMember& member, GimbalMode& mode);
+
+bool gimbal_calibrate_request (void);
+bool gimbal_calibrate_start (void);
+void gimbal_calibrate_done (bool ok);
+bool gimbal_calibrating (void);
+
+void gimbal_config_print (Print& out);
+
+#endif
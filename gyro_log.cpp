@@ -0,0 +1,416 @@
+/** @file gyro_log.cpp
+ * This is the implementation file for the gyro log. The acquisition task is
+ * the only writer of the ring, which works as the telemetry ring does, so
+ * adding a sample never waits. The gyro log task reads the ring through its
+ * own cursor while a take is being recorded and appends the samples to the
+ * take file in blocks of @c FLASH_BLOCK_BYTES, as the flash log does.
+ * Samples the ring overwrites before the task reads them are counted as
+ * dropped; each sample carries its own time, so Gyroflow sees the gap.
+ * Frame sync edges are read from their own ring the same way and written
+ * in between the samples, each before the first sample taken after it.
+ * 
+ * A take stops by itself if flash runs low, leaving room for the black box.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include <LittleFS.h>
+#include "gyro_log.h"
+#include "flash_log.h"
+#include "frame_sync.h"
+#include "task_config.h"
+#include "logger.h"
+#include "storage.h"
+
+const uint32_t GYRO_LOG_PERIOD_MS = 100;    ///< Time between passes of the gyro log task
+const size_t GYRO_MIN_FREE_BYTES = 32 * 1024;   ///< A take stops when less flash than this is free
+
+static const char GYRO_LOG_DIR[] = "/gyro"; ///< Directory in LittleFS holding the takes
+
+static GyroSample ring[GYRO_RING_SIZE];     ///< The samples, oldest overwritten first
+static std::atomic<uint32_t> written (0);   ///< Number of samples ever written
+static std::atomic<bool> wanted (false);    ///< @c true while a take should be recorded
+
+static uint8_t block[FLASH_BLOCK_BYTES];    ///< Block being filled; gyro log task only
+static File take;                           ///< Take being written; gyro log task only
+
+static bool enabled = false;                ///< @c true once the directory is ready
+static bool take_open = false;              ///< @c true while @c take is open
+static uint32_t current_id = 0;             ///< Number of the take being written, or the next one
+static uint32_t take_samples = 0;           ///< Samples in the current or last take
+static uint32_t dropped = 0;                ///< Samples lost from the current or last take
+static uint32_t take_edges = 0;             ///< Frame sync edges in the current or last take
+static uint32_t edges_dropped = 0;          ///< Edges overwritten before they could be written
+static uint32_t write_errors = 0;           ///< Blocks which couldn't be written since boot
+
+
+/** @brief   Add a sample to the ring, overwriting the oldest if it is full.
+ *  @details Only the acquisition task may call this function.
+ *  @param   time_us Time at which the IMU was sampled
+ *  @param   raw The readings, with the gyroscope bias already taken off
+*/
+void gyro_log_add (uint32_t time_us, const ImuRaw& raw)
+{
+    uint32_t index = written.load (std::memory_order_relaxed);
+    GyroSample& sample = ring[index % GYRO_RING_SIZE];
+    sample.time_us = time_us;
+    sample.gyro[0] = raw.GyX == GYRO_EDGE_MARK ? GYRO_EDGE_MARK + 1 : raw.GyX;
+    sample.gyro[1] = raw.GyY;
+    sample.gyro[2] = raw.GyZ;
+    sample.acc[0] = raw.AcX;
+    sample.acc[1] = raw.AcY;
+    sample.acc[2] = raw.AcZ;
+    written.store (index + 1, std::memory_order_release);
+}
+
+/** @brief   Copy a sample out of the ring.
+ *  @param   index Index of the sample, counted from the first sample since boot
+ *  @param   sample A reference to where the sample is copied
+ *  @returns @c true if the sample was copied, @c false if it has been overwritten
+*/
+static bool get_sample (uint32_t index, GyroSample& sample)
+{
+    uint32_t count = written.load (std::memory_order_acquire);
+    if (index >= count || count - index > GYRO_RING_SIZE)
+    {
+        return false;
+    }
+    sample = ring[index % GYRO_RING_SIZE];
+    std::atomic_thread_fence (std::memory_order_acquire);
+    return written.load (std::memory_order_relaxed) - index < GYRO_RING_SIZE;
+}
+
+/** @brief   Start or stop recording a take.
+ *  @param   on @c true to start, @c false to stop
+ *  @returns @c false if flash isn't available for recording
+*/
+bool gyro_log_record (bool on)
+{
+    if (on && !enabled)
+    {
+        return false;
+    }
+    wanted.store (on);
+    return true;
+}
+
+/** @brief   Return @c true while a take is being recorded, or is about to be.
+*/
+bool gyro_log_recording (void)
+{
+    return wanted.load ();
+}
+
+/** @brief   Make the path of a take in LittleFS.
+ *  @param   id Number of the take
+ *  @param   path Where the path is put
+ *  @param   size Size of @c path in bytes
+*/
+static void make_path (uint32_t id, char* path, size_t size)
+{
+    snprintf (path, size, "%s/%05lu.gyr", GYRO_LOG_DIR, (unsigned long)id);
+}
+
+/** @brief   Find the path of a take, for downloading it.
+ *  @param   id Number of the take
+ *  @param   path Where the path is put
+ *  @param   size Size of @c path in bytes
+ *  @returns @c true if the take is in flash
+*/
+bool gyro_log_take_path (uint32_t id, char* path, size_t size)
+{
+    if (!enabled)
+    {
+        return false;
+    }
+    make_path (id, path, size);
+    return LittleFS.exists (path);
+}
+
+/** @brief   Return @c true if a take is still being recorded.
+ *  @details Such a take can't be downloaded until it is stopped.
+ *  @param   id Number of the take
+*/
+bool gyro_log_take_open (uint32_t id)
+{
+    return take_open && id == current_id;
+}
+
+/** @brief   Get the number of a take from its file name.
+ *  @param   name The file name, with or without the directory
+ *  @param   id Where the number is put
+ *  @returns @c true if the file is a take
+*/
+static bool parse_name (const char* name, uint32_t& id)
+{
+    const char* slash = strrchr (name, '/');
+    if (slash)
+    {
+        name = slash + 1;
+    }
+    char* end;
+    id = strtoul (name, &end, 10);
+    return end != name && strcmp (end, ".gyr") == 0;
+}
+
+/** @brief   Find the number of the next take from those left from earlier sessions.
+*/
+static void scan_takes (void)
+{
+    File directory = LittleFS.open (GYRO_LOG_DIR);
+    for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+    {
+        uint32_t id;
+        if (parse_name (file.name (), id) && id >= current_id)
+        {
+            current_id = id + 1;
+        }
+    }
+}
+
+/** @brief   Open a new take file and put its header at the start of the block.
+ *  @returns The number of bytes in the block, or zero if the file couldn't be opened
+*/
+static size_t open_take (void)
+{
+    char path[24];
+    if (current_id >= GYRO_TAKES)
+    {
+        make_path (current_id - GYRO_TAKES, path, sizeof (path));
+        LittleFS.remove (path);
+    }
+    make_path (current_id, path, sizeof (path));
+    take = LittleFS.open (path, "w");
+    if (!take)
+    {
+        write_errors++;
+        return 0;
+    }
+    take_open = true;
+    take_samples = 0;
+    dropped = 0;
+    take_edges = 0;
+    edges_dropped = 0;
+
+    GyroLogHeader header = { { 'G', 'S', 'G', 'Y' }, GYRO_LOG_VERSION, sizeof (GyroSample),
+                             CONTROL_RATE_HZ, GYRO_LSB_PER_DPS, GYRO_LSB_PER_G, (uint32_t)millis () };
+    memcpy (block, &header, sizeof (header));
+    LOG_INFO (MOD_MAIN, FMT_GYRO_TAKE_START, current_id);
+    return sizeof (header);
+}
+
+/** @brief   Append the bytes in the block to the take file.
+ *  @param   length Number of bytes to write
+ *  @returns @c true if they were written
+*/
+static bool write_block (size_t length)
+{
+    if (take.write (block, length) == length)
+    {
+        return true;
+    }
+    write_errors++;
+    LOG_ERROR (MOD_MAIN, FMT_GYRO_WRITE_FAILED, current_id);
+    return false;
+}
+
+/** @brief   Add one sample or edge to the block, writing the block when it is full.
+ *  @param   record The record, a @c GyroSample or a @c GyroEdge
+ *  @param   filled Bytes in the block, updated
+ *  @returns @c false if the block had to be written and the write failed
+*/
+static bool append (const void* record, size_t& filled)
+{
+    memcpy (block + filled, record, sizeof (GyroSample));
+    filled += sizeof (GyroSample);
+    if (filled + sizeof (GyroSample) > FLASH_BLOCK_BYTES)
+    {
+        bool ok = write_block (filled);
+        filled = 0;
+        return ok;
+    }
+    return true;
+}
+
+/** @brief   Write the frame sync edges which came before a given time.
+ *  @param   edge_cursor Number of the next edge to write, updated
+ *  @param   before_us Edges at or after this time are left for later
+ *  @param   filled Bytes in the block, updated
+ *  @returns @c false if a block write failed
+*/
+static bool append_edges (uint32_t& edge_cursor, uint32_t before_us, size_t& filled)
+{
+    GyroEdge edge = { 0, GYRO_EDGE_MARK, { 0, 0, 0 }, 0 };
+    uint32_t count = frame_sync_count ();
+    while (edge_cursor < count)
+    {
+        if (!frame_sync_get (edge_cursor, edge.time_us))
+        {
+            edges_dropped++;
+            edge_cursor++;
+            continue;
+        }
+        if ((int32_t)(edge.time_us - before_us) >= 0)
+        {
+            break;
+        }
+        edge.number = edge_cursor++;
+        take_edges++;
+        if (!append (&edge, filled))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief   Finish the current take.
+*/
+static void close_take (void)
+{
+    take.close ();
+    take_open = false;
+    LOG_INFO (MOD_MAIN, FMT_GYRO_TAKE_STOP, current_id, take_samples, dropped);
+    LOG_INFO (MOD_MAIN, FMT_GYRO_TAKE_EDGES, current_id, take_edges, edges_dropped);
+    current_id++;
+}
+
+/** @brief   Write the state of the gyro log and the takes in flash as a JSON object.
+ *  @param   out The device to which the object is written
+*/
+void gyro_log_json (Print& out)
+{
+    JsonWriter json (out);
+    json.begin_object ();
+    json.value ("enabled", enabled);
+    json.value ("recording", take_open);
+    json.value ("take", current_id);
+    json.value ("samples", take_samples);
+    json.value ("dropped", dropped);
+    json.value ("edges", take_edges);
+    json.value ("edges_dropped", edges_dropped);
+    json.value ("write_errors", write_errors);
+    json.value ("rate_hz", CONTROL_RATE_HZ);
+
+    json.begin_array ("takes");
+    if (enabled)
+    {
+        File directory = LittleFS.open (GYRO_LOG_DIR);
+        for (File file = directory.openNextFile (); file; file = directory.openNextFile ())
+        {
+            uint32_t id;
+            if (parse_name (file.name (), id))
+            {
+                json.begin_object ();
+                json.value ("id", id);
+                json.value ("bytes", (unsigned long)file.size ());
+                json.value ("open", gyro_log_take_open (id));
+                json.end_object ();
+            }
+        }
+    }
+    json.end_array ();
+    json.end_object ();
+}
+
+/** @brief   Print the state of the gyro log.
+ *  @param   out The device to which the report is printed
+*/
+void gyro_log_print (Print& out)
+{
+    if (!enabled)
+    {
+        out << "Gyro log: disabled" << endl;
+        return;
+    }
+    out << "Gyro log: " << (take_open ? "recording take " : "stopped, next take ") << current_id
+        << ", " << take_samples << " samples, " << dropped << " dropped, "
+        << take_edges << " sync edges, " << write_errors << " write errors" << endl;
+}
+
+/** @brief   Task which copies the gyro ring into a take file while recording.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_GYRO_LOG (void* p_params)
+{
+    if (!storage_ready () || !(LittleFS.exists (GYRO_LOG_DIR) || LittleFS.mkdir (GYRO_LOG_DIR)))
+    {
+        // The task isn't deleted, as the memory report still looks at its stack
+        while (true)
+        {
+            vTaskDelay (portMAX_DELAY);
+        }
+    }
+    scan_takes ();
+    enabled = true;
+
+    uint32_t cursor = 0;
+    uint32_t edge_cursor = 0;
+    size_t filled = 0;
+    TickType_t last_wake = xTaskGetTickCount ();
+
+    while (true)
+    {
+        vTaskDelayUntil (&last_wake, pdMS_TO_TICKS (GYRO_LOG_PERIOD_MS));
+        task_woke (TASK_GYRO_LOG);
+
+        if (!take_open)
+        {
+            if (!wanted.load ())
+            {
+                continue;
+            }
+            filled = open_take ();
+            if (filled == 0)
+            {
+                wanted.store (false);
+                continue;
+            }
+            cursor = written.load (std::memory_order_acquire);
+            edge_cursor = frame_sync_count ();
+        }
+
+        // Copy what has arrived, putting each edge before the first sample
+        // taken after it; a full block is written at once
+        bool ok = true;
+        uint32_t count = written.load (std::memory_order_acquire);
+        GyroSample sample;
+        while (ok && cursor < count)
+        {
+            if (count - cursor > GYRO_RING_SIZE)
+            {
+                dropped += count - cursor - GYRO_RING_SIZE;
+                cursor = count - GYRO_RING_SIZE;
+            }
+            if (get_sample (cursor, sample))
+            {
+                ok = append_edges (edge_cursor, sample.time_us, filled) && append (&sample, filled);
+                take_samples++;
+            }
+            else
+            {
+                dropped++;
+            }
+            cursor++;
+        }
+
+        if (ok && storage_free () < GYRO_MIN_FREE_BYTES)
+        {
+            LOG_WARN (MOD_MAIN, FMT_GYRO_FLASH_FULL, current_id);
+            wanted.store (false);
+        }
+        if (!ok || !wanted.load ())
+        {
+            if (ok && filled > 0)
+            {
+                write_block (filled);
+            }
+            filled = 0;
+            wanted.store (false);
+            close_take ();
+        }
+    }
+}
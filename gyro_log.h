@@ -0,0 +1,81 @@
+/** @file gyro_log.h
+ * This is the header file for the gyro log, which records the IMU's motion
+ * at the full acquisition rate for stabilizing footage afterwards in
+ * Gyroflow. The acquisition task puts every sample, with the gyroscope bias
+ * taken off, into a RAM ring; while a take is being recorded, a low-priority
+ * task copies the ring into a file in LittleFS.
+ * 
+ * A take file is a @c GyroLogHeader followed by @c GyroSample structures.
+ * The camera frame sync edges from frame_sync.h which arrive during a take
+ * are stored among the samples, in time order, as @c GyroEdge records, so
+ * the sync data stays with the motion it belongs to. tools/gyroflow_export.py turns it into Gyroflow's GCSV format, adding the
+ * orientation of the IMU relative to the camera. Takes are listed at GET
+ * @c /api/v1/gyro, started and stopped with PUT @c {"recording":true} or
+ * @c {"recording":false}, and downloaded from @c /api/v1/gyro?take=N.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _GYRO_LOG_
+#define _GYRO_LOG_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "IMU.h"
+#include "json_writer.h"
+
+const uint16_t GYRO_RING_SIZE = 1024;       ///< Samples kept in RAM; about ten seconds at 100 Hz
+const uint8_t GYRO_TAKES = 4;               ///< Takes kept in flash; older ones are deleted
+const uint16_t GYRO_LSB_PER_DPS = 131;      ///< Gyroscope counts per degree per second, at +/-250 deg/s
+const uint16_t GYRO_LSB_PER_G = 16384;      ///< Accelerometer counts per g, at +/-2 g
+const uint8_t GYRO_LOG_VERSION = 2;         ///< Version of the file layout, for tools/gyroflow_export.py
+const int16_t GYRO_EDGE_MARK = INT16_MIN;   ///< Gyroscope X of a record which is a @c GyroEdge; samples never have it
+
+/** @brief One IMU sample in the gyro log
+*/
+struct GyroSample
+{
+    uint32_t time_us;       ///< Time at which the IMU was sampled, from @c micros()
+    int16_t gyro[3];        ///< Gyroscope X, Y and Z with the bias taken off
+    int16_t acc[3];         ///< Raw accelerometer X, Y and Z
+};
+
+/** @brief Camera frame sync edge, stored among the samples of a take
+*/
+struct GyroEdge
+{
+    uint32_t time_us;       ///< Time of the edge, from @c micros() like the samples
+    int16_t mark;           ///< @c GYRO_EDGE_MARK, where a sample has its gyroscope X
+    uint16_t spare[3];      ///< Zero
+    uint32_t number;        ///< Number of the edge since boot, as in @c frame_sync_get()
+};
+
+/** @brief Header at the start of each take file
+*/
+struct GyroLogHeader
+{
+    char magic[4];          ///< "GSGY"
+    uint8_t version;        ///< @c GYRO_LOG_VERSION
+    uint8_t sample_size;    ///< Size of each sample in bytes
+    uint16_t rate_hz;       ///< Nominal samples per second
+    uint16_t gyro_lsb;      ///< @c GYRO_LSB_PER_DPS
+    uint16_t acc_lsb;       ///< @c GYRO_LSB_PER_G
+    uint32_t start_ms;      ///< Time the take began, from @c millis()
+};
+
+static_assert (sizeof (GyroSample) == 16, "tools/gyroflow_export.py expects 16 byte samples");
+static_assert (sizeof (GyroEdge) == sizeof (GyroSample), "Edges take the place of samples in a take");
+static_assert (sizeof (GyroLogHeader) == 16, "tools/gyroflow_export.py expects a 16 byte header");
+
+void gyro_log_add (uint32_t time_us, const ImuRaw& raw);
+bool gyro_log_record (bool on);
+bool gyro_log_recording (void);
+bool gyro_log_take_path (uint32_t id, char* path, size_t size);
+bool gyro_log_take_open (uint32_t id);
+void gyro_log_json (Print& out);
+void gyro_log_print (Print& out);
+
+#endif
@@ -0,0 +1,222 @@
+/** @file json_reader.cpp
+ * This is the implementation file for the small JSON reader.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "json_reader.h"
+
+const uint8_t JSON_KEY_MAX = 32;            ///< Longest key which is accepted
+
+
+/** @brief   Check whether a member has the given key.
+ *  @param   name The key to compare against
+ *  @returns @c true if the key matches exactly
+*/
+bool JsonMember :: key_is (const char* name) const
+{
+    return strlen (name) == key_length && strncmp (key, name, key_length) == 0;
+}
+
+/** @brief   Check whether a member's value is the given string.
+ *  @param   name The string to compare against
+ *  @returns @c true if the value is a string which matches exactly
+*/
+bool JsonMember :: text_is (const char* name) const
+{
+    return type == JSON_STRING && strlen (name) == text_length && strncmp (text, name, text_length) == 0;
+}
+
+/** @brief   Skip any white space.
+*/
+void JsonReader :: skip_space (void)
+{
+    while (at < end && (*at == ' ' || *at == '\t' || *at == '\r' || *at == '\n'))
+    {
+        at++;
+    }
+}
+
+/** @brief   Read one character, after any white space.
+ *  @param   ch The character which must come next
+ *  @returns @c true if it was there
+*/
+bool JsonReader :: expect (char ch)
+{
+    skip_space ();
+    if (at < end && *at == ch)
+    {
+        at++;
+        return true;
+    }
+    return false;
+}
+
+/** @brief   Read a quoted string, leaving any escapes in place.
+ *  @param   text Set to the first character inside the quotes
+ *  @param   length Set to the number of characters inside the quotes
+ *  @returns @c true if a complete string was read
+*/
+bool JsonReader :: read_string (const char*& text, uint16_t& length)
+{
+    if (!expect ('"'))
+    {
+        return false;
+    }
+    text = at;
+    while (at < end && *at != '"')
+    {
+        if ((uint8_t)*at < 0x20)
+        {
+            return false;
+        }
+        if (*at == '\\')
+        {
+            at++;
+        }
+        at++;
+    }
+    if (at >= end)
+    {
+        return false;
+    }
+    length = at - text;
+    at++;
+    return true;
+}
+
+/** @brief   Read an integer which fits in 32 bits.
+ *  @param   number Set to the value read
+ *  @returns @c true if an integer was read
+*/
+bool JsonReader :: read_number (int32_t& number)
+{
+    bool negative = (at < end && *at == '-');
+    if (negative)
+    {
+        at++;
+    }
+    if (at >= end || !isdigit (*at))
+    {
+        return false;
+    }
+
+    int64_t value = 0;
+    while (at < end && isdigit (*at))
+    {
+        value = value * 10 + (*at++ - '0');
+        if (value > 0x80000000LL)
+        {
+            return false;
+        }
+    }
+    if (at < end && (*at == '.' || *at == 'e' || *at == 'E'))
+    {
+        return false;
+    }
+    value = negative ? -value : value;
+    if (value > INT32_MAX)
+    {
+        return false;
+    }
+    number = (int32_t)value;
+    return true;
+}
+
+/** @brief   Read a literal such as @c true.
+ *  @param   word The literal
+ *  @returns @c true if it was there
+*/
+bool JsonReader :: read_word (const char* word)
+{
+    size_t length = strlen (word);
+    if ((size_t)(end - at) < length || strncmp (at, word, length) != 0)
+    {
+        return false;
+    }
+    at += length;
+    return true;
+}
+
+/** @brief   Read the next member of the object.
+ *  @param   member Filled in with the member's key and value
+ *  @returns @c true if a member was read; @c false at the end of the object
+ *           or on an error, which @c ok() tells apart
+*/
+bool JsonReader :: next (JsonMember& member)
+{
+    if (error || finished)
+    {
+        return false;
+    }
+    bool first = !started;
+    started = true;
+    if (first && !expect ('{'))
+    {
+        return fail ();
+    }
+    if (expect ('}'))
+    {
+        // Only white space may follow the object
+        finished = true;
+        skip_space ();
+        return (at == end) ? false : fail ();
+    }
+    if (!first && !expect (','))
+    {
+        return fail ();
+    }
+
+    uint16_t key_length;
+    if (!read_string (member.key, key_length) || key_length > JSON_KEY_MAX || !expect (':'))
+    {
+        return fail ();
+    }
+    member.key_length = key_length;
+
+    skip_space ();
+    member.text = NULL;
+    member.text_length = 0;
+    member.number = 0;
+    member.flag = false;
+    if (at < end && *at == '"')
+    {
+        member.type = JSON_STRING;
+        if (!read_string (member.text, member.text_length))
+        {
+            return fail ();
+        }
+    }
+    else if (read_word ("true"))
+    {
+        member.type = JSON_BOOL;
+        member.flag = true;
+    }
+    else if (read_word ("false"))
+    {
+        member.type = JSON_BOOL;
+        member.flag = false;
+    }
+    else if (read_word ("null"))
+    {
+        member.type = JSON_NULL;
+    }
+    else if (read_number (member.number))
+    {
+        member.type = JSON_NUMBER;
+    }
+    else
+    {
+        return fail ();
+    }
+
+    // A member must be followed by a comma or the closing brace
+    skip_space ();
+    if (at >= end || (*at != ',' && *at != '}'))
+    {
+        return fail ();
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+/** @file json_reader.h
+ * This is the header file for a small JSON reader. It reads the flat objects
+ * which the REST API takes, such as @c {"kp":12,"mode":"idle"}, in place:
+ * nothing is copied or allocated, and each member points back into the text
+ * it came from.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _JSON_READER_
+#define _JSON_READER_
+
+#include <Arduino.h>
+
+/// Kinds of value a member of a flat object can have
+enum JsonType
+{
+    JSON_NULL,              ///< @c null
+    JSON_BOOL,              ///< @c true or @c false; see @c JsonMember::flag
+    JSON_NUMBER,            ///< An integer; see @c JsonMember::number
+    JSON_STRING             ///< A string; see @c JsonMember::text
+};
+
+/** @brief One member of an object, as found by @c JsonReader::next()
+*/
+struct JsonMember
+{
+    const char* key;        ///< The key, not terminated; escapes are not decoded
+    uint8_t key_length;     ///< Number of characters in the key
+    JsonType type;          ///< Kind of value
+    const char* text;       ///< A string value, not terminated; escapes are not decoded
+    uint16_t text_length;   ///< Number of characters in a string value
+    int32_t number;         ///< A number value
+    bool flag;              ///< A boolean value
+
+    bool key_is (const char* name) const;
+    bool text_is (const char* name) const;
+};
+
+/** @brief   Class which walks the members of a flat JSON object.
+ *  @details Nested objects and arrays, fractions and exponents are refused,
+ *           since nothing the API takes needs them:
+ *           @code
+ *           JsonReader json (body, length);
+ *           JsonMember member;
+ *           while (json.next (member)) { ... }
+ *           if (!json.ok ()) { ... }
+ *           @endcode
+ */
+class JsonReader
+{
+    protected:
+        const char* at;             ///< Next character to be read
+        const char* end;            ///< One past the last character
+        bool started;               ///< Set once the opening brace has been read
+        bool finished;              ///< Set once the closing brace has been read
+        bool error;                 ///< Set when the text isn't a flat object
+
+        void skip_space (void);
+        bool expect (char ch);
+        bool read_string (const char*& text, uint16_t& length);
+        bool read_number (int32_t& number);
+        bool read_word (const char* word);
+        bool fail (void) { error = true; return false; }
+
+    public:
+        JsonReader (const char* text, size_t length)
+            : at (text), end (text + length), started (false), finished (false), error (false) { }
+
+        bool next (JsonMember& member);
+        bool ok (void) const { return !error; }
+};
+
+#endif
@@ -0,0 +1,213 @@
+/** @file json_writer.cpp
+ * This is the implementation file for the small JSON writer.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <math.h>
+#include "json_writer.h"
+
+/// Most digits after the point that @c fixed() writes; ten to this power still fits in 32 bits
+const uint8_t MAX_FIXED_DECIMALS = 9;
+
+
+/** @brief   Write the comma and key, if any, which go before an item.
+ *  @param   key The item's key, or @c NULL inside an array
+*/
+void JsonWriter :: item (const char* key)
+{
+    uint32_t bit = 1UL << depth;
+    if (has_items & bit)
+    {
+        out.write (',');
+    }
+    has_items |= bit;
+    if (key)
+    {
+        string (key);
+        out.write (':');
+    }
+}
+
+/** @brief   Write a quoted string, escaping the characters JSON requires.
+ *  @param   text The string to be written
+*/
+void JsonWriter :: string (const char* text)
+{
+    out.write ('"');
+    for ( ; *text; text++)
+    {
+        char ch = *text;
+        if (ch == '"' || ch == '\\')
+        {
+            out.write ('\\');
+            out.write (ch);
+        }
+        else if ((uint8_t)ch < 0x20)
+        {
+            char escape[8];
+            snprintf (escape, sizeof (escape), "\\u%04x", ch);
+            out.print (escape);
+        }
+        else
+        {
+            out.write (ch);
+        }
+    }
+    out.write ('"');
+}
+
+/** @brief   Open an object.
+ *  @param   key The object's key, or @c NULL at the top level or inside an array
+*/
+JsonWriter& JsonWriter :: begin_object (const char* key)
+{
+    item (key);
+    out.write ('{');
+    depth++;
+    has_items &= ~(1UL << depth);
+    return *this;
+}
+
+/** @brief   Close the innermost object.
+*/
+JsonWriter& JsonWriter :: end_object (void)
+{
+    depth--;
+    out.write ('}');
+    return *this;
+}
+
+/** @brief   Open an array.
+ *  @param   key The array's key, or @c NULL at the top level or inside an array
+*/
+JsonWriter& JsonWriter :: begin_array (const char* key)
+{
+    item (key);
+    out.write ('[');
+    depth++;
+    has_items &= ~(1UL << depth);
+    return *this;
+}
+
+/** @brief   Close the innermost array.
+*/
+JsonWriter& JsonWriter :: end_array (void)
+{
+    depth--;
+    out.write (']');
+    return *this;
+}
+
+/** @brief   Write a string value.
+ *  @param   key The value's key, or @c NULL inside an array
+ *  @param   text The string
+*/
+JsonWriter& JsonWriter :: value (const char* key, const char* text)
+{
+    item (key);
+    string (text);
+    return *this;
+}
+
+/** @brief   Write a signed integer value.
+ *  @param   key The value's key, or @c NULL inside an array
+ *  @param   number The number
+*/
+JsonWriter& JsonWriter :: value (const char* key, long number)
+{
+    item (key);
+    out.print (number);
+    return *this;
+}
+
+/** @brief   Write an unsigned integer value.
+ *  @param   key The value's key, or @c NULL inside an array
+ *  @param   number The number
+*/
+JsonWriter& JsonWriter :: value (const char* key, unsigned long number)
+{
+    item (key);
+    out.print (number);
+    return *this;
+}
+
+/** @brief   Write @c true or @c false.
+ *  @param   key The value's key, or @c NULL inside an array
+ *  @param   flag The value
+*/
+JsonWriter& JsonWriter :: value (const char* key, bool flag)
+{
+    item (key);
+    out.print (flag ? "true" : "false");
+    return *this;
+}
+
+/** @brief   Write a floating point value; infinities and NaN are written as null.
+ *  @param   key The value's key, or @c NULL inside an array
+ *  @param   number The number
+ *  @param   decimals Number of digits after the decimal point
+*/
+JsonWriter& JsonWriter :: value (const char* key, float number, uint8_t decimals)
+{
+    if (isnan (number) || isinf (number))
+    {
+        return null (key);
+    }
+    item (key);
+    out.print (number, decimals);
+    return *this;
+}
+
+/** @brief   Write a fixed-point value, such as tenths of a percent, as a decimal number.
+ *  @param   key The value's key, or @c NULL inside an array
+ *  @param   scaled The value times ten to the power of @c decimals
+ *  @param   decimals Number of digits after the decimal point, at most
+ *           @c MAX_FIXED_DECIMALS; more are treated as that many
+*/
+JsonWriter& JsonWriter :: fixed (const char* key, int32_t scaled, uint8_t decimals)
+{
+    item (key);
+    if (decimals > MAX_FIXED_DECIMALS)
+    {
+        decimals = MAX_FIXED_DECIMALS;
+    }
+    uint32_t scale = 1;
+    for (uint8_t digit = 0; digit < decimals; digit++)
+    {
+        scale *= 10;
+    }
+    uint32_t magnitude = scaled < 0 ? -(int64_t)scaled : scaled;
+    if (scaled < 0)
+    {
+        out.write ('-');
+    }
+    out.print ((unsigned long)(magnitude / scale));
+    if (decimals > 0)
+    {
+        // Digits are filled in from the right so the leading zeros come for free
+        char fraction[MAX_FIXED_DECIMALS + 2];
+        uint32_t remainder = magnitude % scale;
+        fraction[0] = '.';
+        for (uint8_t digit = decimals; digit > 0; digit--)
+        {
+            fraction[digit] = '0' + remainder % 10;
+            remainder /= 10;
+        }
+        fraction[decimals + 1] = '\0';
+        out.print (fraction);
+    }
+    return *this;
+}
+
+/** @brief   Write @c null.
+ *  @param   key The value's key, or @c NULL inside an array
+*/
+JsonWriter& JsonWriter :: null (const char* key)
+{
+    item (key);
+    out.print ("null");
+    return *this;
+}
@@ -0,0 +1,54 @@
+/** @file json_writer.h
+ * This is the header file for a small JSON writer. It writes straight to
+ * any @c Print, usually a fixed buffer or a chunked reply, and keeps track
+ * of the commas itself, so replies can be built without any @c String or
+ * heap use.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _JSON_WRITER_
+#define _JSON_WRITER_
+
+#include <Arduino.h>
+
+/** @brief   Class which writes a JSON document to a @c Print.
+ *  @details Every method takes an optional key. Inside an object a key must
+ *           be given; inside an array it must be @c NULL. Calls can be chained:
+ *           @code
+ *           JsonWriter json (out);
+ *           json.begin_object ().value ("pitch", 3).fixed ("load", 125, 1).end_object ();
+ *           @endcode
+ */
+class JsonWriter
+{
+    protected:
+        Print& out;                 ///< Where the document is written
+        uint8_t depth;              ///< Number of objects and arrays open
+        uint32_t has_items;         ///< Bit for each open level which already has an item
+
+        void item (const char* key);
+        void string (const char* text);
+
+    public:
+        JsonWriter (Print& destination) : out (destination), depth (0), has_items (0) { }
+
+        JsonWriter& begin_object (const char* key = NULL);
+        JsonWriter& end_object (void);
+        JsonWriter& begin_array (const char* key = NULL);
+        JsonWriter& end_array (void);
+
+        JsonWriter& value (const char* key, const char* text);
+        JsonWriter& value (const char* key, long number);
+        JsonWriter& value (const char* key, unsigned long number);
+        JsonWriter& value (const char* key, int number) { return value (key, (long)number); }
+        JsonWriter& value (const char* key, unsigned int number) { return value (key, (unsigned long)number); }
+        JsonWriter& value (const char* key, bool flag);
+        JsonWriter& value (const char* key, float number, uint8_t decimals = 3);
+        JsonWriter& fixed (const char* key, int32_t scaled, uint8_t decimals);
+        JsonWriter& null (const char* key);
+};
+
+#endif
@@ -0,0 +1,167 @@
+/** @file lockfree.h
+ * This file contains lock-free structures used to hand data between tasks,
+ * in particular between tasks running on different cores. Unlike a
+ * @c Share, which goes through a FreeRTOS queue and its cross-core spinlock,
+ * these never block the writer.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _LOCKFREE_
+#define _LOCKFREE_
+
+#include <stdint.h>
+#include <atomic>
+
+/** @brief   Class which holds the latest value written by a single writer.
+ *  @details This is a sequence lock. The writer bumps a counter to an odd
+ *           number, copies the value in, then bumps it to an even number. A
+ *           reader copies the value out and retries if the counter changed
+ *           under it. Readers on the other core spin for at most the time it
+ *           takes to copy one @c T, provided the writer isn't preempted part
+ *           way through; a writer which shares its core with busier tasks
+ *           should call @c put() inside a critical section. A reader on the same core as the writer
+ *           must have a lower priority than the writer, or it could preempt a
+ *           write and spin forever.
+ *  @p       The type @c T must be trivially copyable.
+*/
+template <class T>
+class Mailbox
+{
+    protected:
+        std::atomic<uint32_t> sequence;     ///< Odd while a write is in progress
+        T value;                            ///< The most recently written value
+
+    public:
+        Mailbox (void) : sequence (0), value () { }
+
+        /** @brief   Write a new value, replacing the old one.
+         *  @details Only one task may ever call this method for a given mailbox.
+         *  @param   new_value The value to be written
+        */
+        void put (const T& new_value)
+        {
+            uint32_t seq = sequence.load (std::memory_order_relaxed);
+            sequence.store (seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_release);
+            value = new_value;
+            sequence.store (seq + 2, std::memory_order_release);
+        }
+
+        /** @brief   Read the latest value.
+         *  @param   out A reference to where the value is copied
+         *  @returns @c true if a value has ever been written, @c false if not
+        */
+        bool get (T& out) const
+        {
+            uint32_t before;
+            uint32_t after;
+            do
+            {
+                before = sequence.load (std::memory_order_acquire);
+                out = value;
+                std::atomic_thread_fence (std::memory_order_acquire);
+                after = sequence.load (std::memory_order_relaxed);
+            }
+            while ((before & 1) || before != after);
+
+            return before != 0;
+        }
+
+        /** @brief   Return how many times the mailbox has been written.
+        */
+        uint32_t writes (void) const
+        {
+            return sequence.load (std::memory_order_relaxed) / 2;
+        }
+};
+
+/** @brief   Class which implements a bounded queue with many writers and one reader.
+ *  @details Each slot has its own sequence number which says whether it is free
+ *           for a writer or full for the reader. A writer claims a slot with one
+ *           compare-and-swap and never waits for another writer, so @c put() may
+ *           be called from any task on either core, or from an interrupt. When
+ *           the queue is full @c put() fails at once rather than blocking.
+ *  @p       The size @c N must be a power of two.
+*/
+template <class T, uint16_t N>
+class MpscRing
+{
+    static_assert ((N & (N - 1)) == 0, "MpscRing size must be a power of two");
+
+    protected:
+        /// One slot in the ring, with the sequence number which guards it
+        struct Cell
+        {
+            std::atomic<uint32_t> sequence;
+            T data;
+        };
+
+        Cell cells[N];                  ///< Storage for the items in the ring
+        std::atomic<uint32_t> head;     ///< Position of the next slot to be claimed by a writer
+        uint32_t tail;                  ///< Position of the next slot to be read
+
+    public:
+        MpscRing (void) : head (0), tail (0)
+        {
+            for (uint32_t index = 0; index < N; index++)
+            {
+                cells[index].sequence.store (index, std::memory_order_relaxed);
+            }
+        }
+
+        /** @brief   Put an item into the ring without ever waiting.
+         *  @param   item The item to be copied into the ring
+         *  @returns @c true if the item was queued, @c false if the ring was full
+        */
+        bool put (const T& item)
+        {
+            uint32_t pos = head.load (std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell& cell = cells[pos & (N - 1)];
+                uint32_t seq = cell.sequence.load (std::memory_order_acquire);
+                int32_t diff = (int32_t)(seq - pos);
+                if (diff == 0)
+                {
+                    if (head.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.data = item;
+                        cell.sequence.store (pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = head.load (std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /** @brief   Take the oldest item out of the ring.
+         *  @details Only one task may ever call this method for a given ring.
+         *  @param   item A reference to where the item is copied
+         *  @returns @c true if an item was taken, @c false if the ring was empty
+        */
+        bool get (T& item)
+        {
+            Cell& cell = cells[tail & (N - 1)];
+            uint32_t seq = cell.sequence.load (std::memory_order_acquire);
+            if ((int32_t)(seq - (tail + 1)) < 0)
+            {
+                return false;
+            }
+            item = cell.data;
+            cell.sequence.store (tail + N, std::memory_order_release);
+            tail++;
+            return true;
+        }
+};
+
+#endif
@@ -0,0 +1,84 @@
+/** @file log_formats.h
+ * This file lists every message which can be logged. Call sites log a
+ * format ID and up to four integer arguments; the text is only looked up
+ * when the logging task prints the record.
+ * 
+ * To add a message, add a line to @c LOG_FORMATS with a new ID and its
+ * @c printf style format string. Arguments are 32-bit integers, so use
+ * @c %d and friends. Only add lines at the end of the list, or logs
+ * captured from older firmware will be decoded with the wrong text.
+ * 
+ * When @c LOG_DEFERRED_FORMAT is set, the strings are not built into the
+ * firmware at all. The records are sent in binary and tools/log_decode.py
+ * reads this file to turn the format IDs back into text.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _LOG_FORMATS_
+#define _LOG_FORMATS_
+
+#define LOG_FORMATS(X) \
+    X (FMT_MOTOR_FORWARD,       "Motor spinning forward") \
+    X (FMT_MOTOR_BACKWARD,      "Motor spinning backwards") \
+    X (FMT_MOTOR_BRAKE,         "Motor braked") \
+    X (FMT_PITCH_ERROR,         "Calculated error: %d") \
+    X (FMT_GYRO_ROLL,           "Roll angle from Gyroscope (after correction): %d") \
+    X (FMT_IMU_NO_DATA,         "No Data Available") \
+    X (FMT_IMU_BYTES_AVAILABLE, "Data Available: %d Bytes") \
+    X (FMT_IMU_RAW_ACC,         "Raw acceleration: %d, %d, %d") \
+    X (FMT_ACC_PITCH,           "Pitch angle from Accelerometer (after correction): %d") \
+    X (FMT_ACC_ROLL,            "Roll angle from Accelerometer (after correction): %d") \
+    X (FMT_GYRO_DURATION,       "Duration of individual recording during readings: %d") \
+    X (FMT_ACC_PITCH_OFFSET,    "Acc Pitch Offset is: %d") \
+    X (FMT_GYRO_ROLL_OFFSET,    "Gyro Roll Offset is: %d") \
+    X (FMT_HOLD_FLAT,           "Hold IMU flat") \
+    X (FMT_WIFI_CONNECTING,     "Connecting to WiFi") \
+    X (FMT_WIFI_WAITING,        "Not connected") \
+    X (FMT_WIFI_CONNECTED,      "Connected at IP address %d.%d.%d.%d") \
+    X (FMT_HTTP_REQUEST,        "HTTP request from client %d.%d.%d.%d") \
+    X (FMT_HTTP_STARTED,        "HTTP server started") \
+    X (FMT_LOG_LOST,            "%d log records lost, ring full") \
+    X (FMT_SUP_MISS,            "Stage %d (0 acquire, 1 fuse, 2 control) missed its deadline, %d us since heartbeat") \
+    X (FMT_SUP_STATE,           "Supervisor state %d -> %d (0 OK, 1 degraded, 2 safe, 3 reset), cause stage %d") \
+    X (FMT_SUP_LAST_RESET,      "Last reset was by the supervisor: stage %d silent for %d us") \
+    X (FMT_WIFI_LOST,           "WiFi connection lost") \
+    X (FMT_WIFI_BACKOFF,        "Retrying WiFi in %d ms") \
+    X (FMT_BOOT_STAGE,          "Boot stage %d done at %d ms, took %d us") \
+    X (FMT_BOOT_SLOW,           "Stabilizing %d ms after reset, over the %d ms boot budget") \
+    X (FMT_WEB_CORE,            "AsyncTCP task has affinity %d; it should be pinned to the network core") \
+    X (FMT_CONFIG_SET,          "Settings version %d applied") \
+    X (FMT_MODE_SET,            "Mode set to %d (0 stabilize, 1 local, 2 idle)") \
+    X (FMT_CAL_START,           "Recalibrating from %d readings; hold the gimbal level") \
+    X (FMT_STEP_DONE,           "Step of %d deg: rise %d ms, overshoot %d%%, settling %d ms (0 if it didn't settle)") \
+    X (FMT_BB_TRIGGER,          "Black box triggered (0 manual, 1 error, 2 fault, 3 watchdog: %d) at record %d") \
+    X (FMT_BB_SAVED,            "Black box recording %d saved, %d records, cause %d") \
+    X (FMT_BB_FAILED,           "Black box recording %d could not be written") \
+    X (FMT_FS_MOUNT_FAILED,     "LittleFS could not be mounted; black box and flash log disabled") \
+    X (FMT_FLOG_SEGMENT,        "Flash log segment %d started, %d bytes free") \
+    X (FMT_FLOG_WRITE_FAILED,   "Flash log segment %d: block write failed, %d records dropped") \
+    X (FMT_GYRO_BIAS,           "Gyro bias X %d, Y %d, Z %d counts") \
+    X (FMT_GYRO_TAKE_START,     "Gyro log take %d started") \
+    X (FMT_GYRO_TAKE_STOP,      "Gyro log take %d stopped, %d samples, %d dropped") \
+    X (FMT_GYRO_WRITE_FAILED,   "Gyro log take %d: write failed") \
+    X (FMT_GYRO_FLASH_FULL,     "Gyro log take %d stopped; flash is nearly full") \
+    X (FMT_FRAME_SYNC,          "Frame sync edge %u at %u us") \
+    X (FMT_STATS_NO_ROOM,       "CPU stats: %d tasks don't fit in %d entries; this window is skipped") \
+    X (FMT_CAL_TIMEOUT,         "Recalibration gave up after %d cycles; fewer than %d readings arrived") \
+    X (FMT_CAL_BOOT_FAILED,     "Boot calibration attempt %d of %d got too few readings") \
+    X (FMT_CAL_BOOT_HELD,       "IMU not calibrated at boot; pitch motor held braked until a recalibration succeeds") \
+    X (FMT_GYRO_TAKE_EDGES,     "Gyro log take %d has %d frame sync edges, %d dropped") \
+    X (FMT_CMD_TABLE_FULL,      "Serial command table full at %d commands; %d not registered")
+
+/// Identifiers of the messages which can be logged
+enum LogFormat
+{
+#define LOG_FORMAT_ID(id, text) id,
+    LOG_FORMATS (LOG_FORMAT_ID)
+#undef LOG_FORMAT_ID
+    NUM_LOG_FORMATS
+};
+
+#endif
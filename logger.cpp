@@ -0,0 +1,199 @@
+/** @file logger.cpp
+ * This is the implementation file for the asynchronous logger.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "logger.h"
+#include "lockfree.h"
+#include "task_config.h"
+#include "trace_recorder.h"
+
+const uint16_t LOG_RING_SIZE = 64;  ///< Number of records which can wait to be printed
+
+#if !LOG_DEFERRED_FORMAT
+/// Format strings, indexed by @c LogFormat
+static const char* const log_format_text[NUM_LOG_FORMATS] =
+{
+#define LOG_FORMAT_TEXT(id, text) text,
+    LOG_FORMATS (LOG_FORMAT_TEXT)
+#undef LOG_FORMAT_TEXT
+};
+
+static const char* const module_names[NUM_LOG_MODULES] = { "main", "imu", "motor", "control", "net", "sync" };
+static const char level_letters[] = { '-', 'E', 'W', 'I', 'D', 'T' };
+#endif
+
+static MpscRing<LogRecord, LOG_RING_SIZE> log_ring;    ///< Records waiting to be printed
+
+static volatile uint8_t module_level[NUM_LOG_MODULES] =
+    { LVL_INFO, LVL_INFO, LVL_INFO, LVL_INFO, LVL_INFO, LVL_INFO };
+static uint16_t rate_interval_ms[NUM_LOG_MODULES] = { 100, 100, 100, 100, 100, 100 };
+static uint16_t rate_burst_ms[NUM_LOG_MODULES] = { 500, 500, 500, 500, 500, 500 };
+
+/// Theoretical arrival time of the next message with each format, for rate limiting
+static std::atomic<uint32_t> next_allowed_ms[NUM_LOG_FORMATS];
+
+static std::atomic<uint32_t> logged (0);        ///< Records put into the ring
+static std::atomic<uint32_t> overflowed (0);    ///< Records lost because the ring was full
+static std::atomic<uint32_t> rate_limited (0);  ///< Records thrown away by the rate limiter
+
+
+/** @brief   Log a message from any task or interrupt without blocking.
+ *  @details The message is dropped at once if its module's level is too low,
+ *           if its format has been logged faster than the module's rate limit
+ *           allows, or if the ring is full. Each format gets its own rate limit,
+ *           so one chatty message can't crowd out the others.
+ *  @param   module The part of the program logging the message
+ *  @param   level The severity of the message
+ *  @param   format The message from @c LOG_FORMATS to be printed
+ *  @param   a0 The first argument for the format string, and so on
+*/
+void log_event (LogModule module, LogLevel level, LogFormat format,
+                int32_t a0, int32_t a1, int32_t a2, int32_t a3)
+{
+    if (level > module_level[module])
+    {
+        return;
+    }
+
+    // Generic cell rate algorithm: each message pushes the next allowed time
+    // back by one interval, and up to a burst's worth of credit can build up.
+    // Callers on both cores may race for the same format, so the slot is
+    // only moved on if nobody else moved it first
+    uint32_t now = millis ();
+    uint32_t allowed = next_allowed_ms[format].load (std::memory_order_relaxed);
+    uint32_t next;
+    do
+    {
+        if ((int32_t)(allowed - now) > (int32_t)rate_burst_ms[module])
+        {
+            rate_limited.fetch_add (1, std::memory_order_relaxed);
+            return;
+        }
+        next = ((int32_t)(allowed - now) > 0 ? allowed : now) + rate_interval_ms[module];
+    }
+    while (!next_allowed_ms[format].compare_exchange_weak (allowed, next, std::memory_order_relaxed));
+
+    LogRecord record;
+    record.time_ms = now;
+    record.format = format;
+    record.module = module;
+    record.level = level;
+    record.args[0] = a0;
+    record.args[1] = a1;
+    record.args[2] = a2;
+    record.args[3] = a3;
+
+    if (log_ring.put (record))
+    {
+        logged.fetch_add (1, std::memory_order_relaxed);
+    }
+    else
+    {
+        overflowed.fetch_add (1, std::memory_order_relaxed);
+    }
+}
+
+/** @brief   Set the most verbose level which a module will log.
+ *  @param   module The module whose level is set
+ *  @param   level Messages at this level or more severe are logged
+*/
+void log_set_level (LogModule module, LogLevel level)
+{
+    module_level[module] = level;
+}
+
+/** @brief   Return the most verbose level which a module will log.
+ *  @param   module The module whose level is wanted
+*/
+LogLevel log_get_level (LogModule module)
+{
+    return (LogLevel)module_level[module];
+}
+
+/** @brief   Set how often each message from a module may be logged.
+ *  @param   module The module whose rate limit is set
+ *  @param   per_second Long term number of each message allowed per second
+ *  @param   burst Number of each message which may be logged back to back
+*/
+void log_set_rate (LogModule module, uint16_t per_second, uint8_t burst)
+{
+    if (per_second == 0)
+    {
+        per_second = 1;
+    }
+    rate_interval_ms[module] = 1000 / per_second;
+    rate_burst_ms[module] = rate_interval_ms[module] * burst;
+}
+
+/** @brief   Print how many messages were logged and how many were lost.
+ *  @param   out The device to which the report is printed
+*/
+void log_print_stats (Print& out)
+{
+    out << "Logged: " << logged.load () << ", ring full: " << overflowed.load ()
+        << ", rate limited: " << rate_limited.load () << endl;
+}
+
+/** @brief   Send one record to the serial port.
+ *  @details Normally the record is formatted as a line of text. In deferred
+ *           builds the raw record is sent in a frame instead, and the text is
+ *           put back together on the host by tools/log_decode.py.
+ *  @param   record The record to be sent
+*/
+static void print_record (const LogRecord& record)
+{
+#if LOG_DEFERRED_FORMAT
+    const uint8_t* p_bytes = (const uint8_t*)&record;
+    uint8_t checksum = 0;
+    for (uint8_t index = 0; index < sizeof (LogRecord); index++)
+    {
+        checksum += p_bytes[index];
+    }
+    Serial.write (LOG_FRAME_SYNC, sizeof (LOG_FRAME_SYNC));
+    Serial.write (p_bytes, sizeof (LogRecord));
+    Serial.write (checksum);
+#else
+    Serial.printf ("[%lu] %c %s: ", (unsigned long)record.time_ms,
+                   level_letters[record.level], module_names[record.module]);
+    Serial.printf (log_format_text[record.format], (int)record.args[0],
+                   (int)record.args[1], (int)record.args[2], (int)record.args[3]);
+    Serial.println ();
+#endif
+}
+
+/** @brief   Task which prints the records in the log ring.
+ *  @details This task runs at low priority on the network core. It is the only
+ *           place where logged messages are formatted and sent to the serial
+ *           port, so the time this takes never lands on the control core.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_LOG (void* p_params)
+{
+    LogRecord record;
+    uint32_t reported_loss = 0;
+
+    while (true)
+    {
+        task_woke (TASK_LOG);
+        while (log_ring.get (record))
+        {
+            TRACE_SCOPE ("log_print");
+            print_record (record);
+        }
+
+        // The ring has just been emptied, so there is room to report the loss
+        uint32_t lost = overflowed.load (std::memory_order_relaxed);
+        if (lost != reported_loss)
+        {
+            LOG_WARN (MOD_MAIN, FMT_LOG_LOST, lost - reported_loss);
+            reported_loss = lost;
+        }
+
+        vTaskDelay (10);
+    }
+}
@@ -0,0 +1,124 @@
+/** @file logger.h
+ * This is the header file for the asynchronous logger. Tasks push compact
+ * binary records into a lock-free ring and a low-priority task on the
+ * network core formats them and prints them, so nothing in the control
+ * path ever waits for the serial port.
+ * 
+ * Code should log through the @c LOG_ERROR() ... @c LOG_TRACE() macros
+ * rather than calling @c log_event() directly. Messages more verbose than
+ * @c LOG_COMPILE_LEVEL are removed by the preprocessor, arguments and all,
+ * so release builds can be made with, for example,
+ * @c -DLOG_COMPILE_LEVEL=LOG_LEVEL_WARN @c -DLOG_DEFERRED_FORMAT=1
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _LOGGER_
+#define _LOGGER_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "log_formats.h"
+
+/// Parts of the program which log messages; each has its own level and rate limit
+enum LogModule
+{
+    MOD_MAIN,
+    MOD_IMU,
+    MOD_MOTOR,
+    MOD_CONTROL,
+    MOD_NET,
+    MOD_SYNC,
+    NUM_LOG_MODULES
+};
+
+// Numeric levels, so they can be compared by the preprocessor
+#define LOG_LEVEL_OFF   0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+/// Messages more verbose than this are not compiled into the firmware
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/// When set, records are sent in binary and the format strings are left out of flash
+#ifndef LOG_DEFERRED_FORMAT
+#define LOG_DEFERRED_FORMAT 0
+#endif
+
+/// Severity of a message; a module prints messages at or below its level
+enum LogLevel
+{
+    LVL_OFF = LOG_LEVEL_OFF,
+    LVL_ERROR = LOG_LEVEL_ERROR,
+    LVL_WARN = LOG_LEVEL_WARN,
+    LVL_INFO = LOG_LEVEL_INFO,
+    LVL_DEBUG = LOG_LEVEL_DEBUG,
+    LVL_TRACE = LOG_LEVEL_TRACE
+};
+
+const uint8_t LOG_MAX_ARGS = 4;     ///< Number of integer arguments a record can hold
+const uint8_t LOG_FRAME_SYNC[2] = { 0xA5, 0x5A };  ///< Start of each binary log frame
+
+/** @brief   One message as it sits in the log ring.
+ *  @details In deferred builds this structure is sent as is, little endian,
+ *           between the bytes of @c LOG_FRAME_SYNC and a checksum byte, so its
+ *           layout must match the one in tools/log_decode.py.
+*/
+struct LogRecord
+{
+    uint32_t time_ms;               ///< Time at which the message was logged
+    uint16_t format;                ///< Which message from @c LOG_FORMATS this is
+    uint8_t module;                 ///< Module which logged the message
+    uint8_t level;                  ///< Severity of the message
+    int32_t args[LOG_MAX_ARGS];     ///< Arguments for the format string
+};
+
+void log_event (LogModule module, LogLevel level, LogFormat format,
+                int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0, int32_t a3 = 0);
+void log_set_level (LogModule module, LogLevel level);
+LogLevel log_get_level (LogModule module);
+void log_set_rate (LogModule module, uint16_t per_second, uint8_t burst);
+void log_print_stats (Print& out);
+void task_LOG (void* p_params);
+
+// Each macro expands to nothing when its level is compiled out, so neither the
+// call nor the evaluation of its arguments is left in the firmware
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(module, format, ...) log_event (module, LVL_ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(module, format, ...) do { } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(module, format, ...) log_event (module, LVL_WARN, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(module, format, ...) do { } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(module, format, ...) log_event (module, LVL_INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(module, format, ...) do { } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(module, format, ...) log_event (module, LVL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(module, format, ...) do { } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE(module, format, ...) log_event (module, LVL_TRACE, format, ##__VA_ARGS__)
+#else
+#define LOG_TRACE(module, format, ...) do { } while (0)
+#endif
+
+#endif
@@ -8,13 +8,34 @@
 */
 
 #include <Arduino.h>
-#include <WiFi.h>
-#include <WebServer.h>
 
 #include "IMU.h"
 #include "motor_obj.h"
-#include "taskqueue.h"
-#include "mycerts.h"
+#include "lockfree.h"
+#include "task_config.h"
+#include "core_load.h"
+#include "controller.h"
+#include "pitch_loop.h"
+#include "gimbal_config.h"
+#include "pipeline.h"
+#include "logger.h"
+#include "cpu_stats.h"
+#include "serial_cmd.h"
+#include "scope_profiler.h"
+#include "trace_recorder.h"
+#include "supervisor.h"
+#include "wifi_link.h"
+#include "boot_sequence.h"
+#include "telemetry.h"
+#include "rolling_stats.h"
+#include "stab_metrics.h"
+#include "blackbox.h"
+#include "flash_log.h"
+#include "gyro_log.h"
+#include "frame_sync.h"
+#include "telemetry_stream.h"
+#include "udp_link.h"
+#include "web_server.h"
 
 #define USE_LAN
 
@@ -30,254 +51,307 @@ uint8_t m2_in2_pin = 27;    ///< Input pin 2 for motor 2
 uint8_t m3_in1_pin = 33;    ///< Input pin 1 for motor 3
 uint8_t m3_in2_pin = 15;    ///< Input pin 2 for motor 3
 
+uint8_t frame_sync_pin = 32;    ///< Input from the camera's frame sync or flash output
+
 uint32_t m1_freq = 16000;   ///< PWM Frequency for Motor 1
 uint32_t m2_freq = 16000;   ///< PWM Frequency for Motor 2
 uint32_t m3_freq = 1000;    ///< PWM Frequency for Motor 3
 
 uint8_t pwm_resolution = 8; ///< Resolution of pwm frequency value
 
+uint32_t imu_settle_ms = 50;    ///< Time for the MPU-6050 to settle after waking; gyro start-up is 30 ms
+uint8_t cal_cycle_allowance = 2;    ///< Cycles a recalibration may take per reading before it gives up
+uint8_t boot_cal_attempts = 3;      ///< Tries at the boot calibration before falling back to live samples
+
 IMU mpu; ///< IMU Object
 Motor pitch_motor;  ///< Pitch motor object
 Motor roll_motor;   ///< Roll motor object
 Motor yaw_motor;    ///< Yaw motor object
 
-Share<int16_t> pitch("Reading Angle (main)"); ///< Share variable from IMU class
+/// Motors which the supervisor stops if the control chain misses its deadlines
+Motor* const all_motors[] = { &pitch_motor, &roll_motor, &yaw_motor };
 
+Mailbox<AttitudeSample> attitude; ///< Latest attitude, written by the fuse stage on the control core
+Mailbox<PipelineSample> sampled;  ///< Latest raw sample, from the acquisition stage to the fuse stage
+Mailbox<PipelineSample> fused;    ///< Latest fused sample, from the fuse stage to the controller
 
-/** @brief   The web server object.
- *  @details This server is responsible for responding to HTTP requests from
- *           other computers, replying with useful information.
-*/
-WebServer server (80);
+PipelineStats pipeline_stats;     ///< Latency of each pipeline stage, recorded by the pitch controller
+StabilityMetrics pitch_quality;   ///< How well the pitch axis holds its setpoint, recorded by the pitch controller
 
-void setup_wifi (void)
-{
-  Serial << "Connecting to " << ssid;
-  WiFi.begin(ssid, password);
 
-  while (WiFi.status() != WL_CONNECTED)
-  {
-    vTaskDelay(1000);
-    Serial.print("Not connected");
-  }
-
-  Serial << "Connected at IP address " << WiFi.localIP() << endl;
+/** @brief   Print the latency of each pipeline stage, for the serial command.
+ *  @param   out The device to which the report is printed
+ */
+void print_latency (Print& out)
+{
+    pipeline_stats.print (out);
 }
 
-/** @brief   Put a web page header into an HTML string. 
- *  @details This header may be modified if the developer wants some actual
- *           @a style for her or his web page. It is intended to be a common
- *           header (and stylle) for each of the pages served by this server.
- *  @param   a_string A reference to a string to which the header is added; the
- *           string must have been created in each function that calls this one
- *  @param   page_title The title of the page
-*/
-void HTML_header (String& a_string, const char* page_title)
+/** @brief   Print the stabilization quality of the pitch axis, for the serial command.
+ *  @param   out The device to which the report is printed
+ */
+void print_quality (Print& out)
 {
-    a_string += "<!DOCTYPE html> <html>\n";
-    a_string += "<head><meta name=\"viewport\" content=\"width=device-width,";
-    a_string += " initial-scale=1.0, user-scalable=no\">\n<title> ";
-    a_string += page_title;
-    a_string += "</title>\n";
-    a_string += "<style>html { font-family: Helvetica; display: inline-block;";
-    a_string += " margin: 0px auto; text-align: center;}\n";
-    a_string += "body{margin-top: 50px;} h1 {color: #4444AA;margin: 50px auto 30px;}\n";
-    a_string += "p {font-size: 24px;color: #222222;margin-bottom: 10px;}\n";
-    a_string += "</style>\n</head>\n";
+    pitch_quality.print (out);
 }
 
-/** @brief   Callback function that responds to HTTP requests without a subpage
- *           name.
- *  @details When another computer contacts this ESP32 through TCP/IP port 80
- *           (the insecure Web port) with a request for the main web page, this
- *           callback function is run. It sends the main web page's text to the
- *           requesting machine.
+/** @brief   Clear the scope profiler's statistics, for the serial command.
+ *  @param   out The device to which the confirmation is printed
  */
-void handle_DocumentRoot ()
+void print_profiler_reset (Print& out)
 {
-    Serial << "HTTP request from client #" << server.client () << endl;
-
-    String a_str;
-    HTML_header (a_str, "ESP32 Web Server Test");
-    a_str += "<body>\n<div id=\"webpage\">\n";
-    a_str += "<h1>ME 507 Cam Stabilizer</h1>\n";
-    a_str += "Jathun Somasundaram\n";
-    a_str += "<p><p> <a href=\"/toggle\">WOOOO</a>\n";
-    a_str += "<p><p> <a href=\"/csv\">IT WORKS :D</a>\n";
-    a_str += "</div>\n</body>\n</html>\n";
-
-    server.send (200, "text/html", a_str); 
+    profiler_reset ();
+    out << "Scope profiler cleared" << endl;
 }
 
-
-/** @brief   Respond to a request for an HTTP page that doesn't exist.
- *  @details This function produces the Error 404, Page Not Found error. 
+/** @brief   Throw away the trace ring, for the serial command.
+ *  @param   out The device to which the confirmation is printed
  */
-void handle_NotFound (void)
+void print_trace_clear (Print& out)
 {
-    server.send (404, "text/plain", "Not found");
+    trace_clear ();
+    out << "Trace cleared" << endl;
 }
 
-void handle_CSV (void)
+/** @brief   Start a black-box recording, for the serial command.
+ *  @param   out The device to which the result is printed
+ */
+void print_blackbox_trigger (Print& out)
 {
-    // The page will be composed in an Arduino String object, then sent.
-    // The first line will be column headers so we know what the data is
-    String csv_str = "Time, Jumpiness\n";
+    out << (blackbox_trigger (BB_MANUAL) ? "Black box triggered" : "Black box busy or disabled") << endl;
+}
 
-    // Create some fake data and put it into a String object. We could just
-    // as easily have taken values from a data array, if such an array existed
-    for (uint8_t index = 0; index < 20; index++)
-    {
-        csv_str += index;
-        csv_str += ",";
-        csv_str += String (sin (index / 5.4321), 3);       // 3 decimal places
-        csv_str += "\n";
-    }
+/** @brief   Start recording a gyro log take, for the serial command.
+ *  @param   out The device to which the result is printed
+ */
+void print_gyro_start (Print& out)
+{
+    out << (gyro_log_record (true) ? "Gyro log recording" : "Gyro log disabled") << endl;
+}
 
-    // Send the CSV file as plain text so it can be easily saved as a file
-    server.send (404, "text/plain", csv_str);
+/** @brief   Stop recording a gyro log take, for the serial command.
+ *  @param   out The device to which the result is printed
+ */
+void print_gyro_stop (Print& out)
+{
+    gyro_log_record (false);
+    out << "Gyro log stopped" << endl;
 }
 
-/** @brief   Task which sets up and runs a web server.
- *  @details After setup, function @c handleClient() must be run periodically
- *           to check for page requests from web clients. One could run this
- *           task as the lowest priority task with a short or no delay, as there
- *           generally isn't much rush in replying to web queries.
+/** @brief   Task that acquires samples from the IMU, the first stage of the pipeline.
+ *  @details This task first wakes the IMU, lets it settle and calibrates it;
+ *           these boot stages run while the motors and network are set up in
+ *           other tasks. It then wakes every @c IMU_PERIOD, reads all of the
+ *           IMU's data registers in one burst, stamps the sample with a trace ID
+ *           and the time, and wakes the fuse stage. It runs on the control core
+ *           at a higher priority than the stages after it. A recalibration
+ *           asked for through the API is fed from these same samples, so the
+ *           pipeline keeps running while it is done; if too many reads fail
+ *           for it to finish in time, it gives up and the old offsets stay.
+ *           If the boot calibration fails, recalibrations are asked for until
+ *           one succeeds, which keeps the pitch motor braked until then.
  *  @param   p_params Pointer to unused parameters
  */
-void task_SERVER (void* p_params)
+void task_read_IMU (void* p_params )
 {
-    // The server has been created statically when the program was started and
-    // is accessed as a global object because not only this function but also
-    // the page handling functions referenced below need access to the server
-    server.on ("/", handle_DocumentRoot);
-    server.onNotFound (handle_NotFound);
+  PipelineSample sample;
+  sample.trace_id = 0;
+  GimbalConfig config;
+  gimbal_config_get(config);
+  uint32_t cal_cycles_left = 0;   // Cycles before a recalibration gives up
 
-    // Get the web server running
-    server.begin ();
-    Serial.println ("HTTP server started");
+  boot_stage_begin(BOOT_IMU_WAKE);
+  mpu.IMU_init(I2C_SDA, I2C_SCL, MPU_ADDR, PWR_MGMT_1);
+  boot_stage_end(BOOT_IMU_WAKE);
 
-    for (;;)
+  boot_stage_begin(BOOT_IMU_SETTLE);
+  vTaskDelay(pdMS_TO_TICKS(imu_settle_ms));
+  boot_stage_end(BOOT_IMU_SETTLE);
+
+  boot_stage_begin(BOOT_CALIBRATE);
+  LOG_INFO(MOD_MAIN, FMT_HOLD_FLAT);
+  bool calibrated = false;
+  for(uint8_t attempt = 1; attempt <= boot_cal_attempts && !calibrated; attempt++)
+  {
+    calibrated = mpu.cal_acc(MPU_ADDR, config.cal_samples);
+    if(!calibrated)
     {
-        // The web server must be periodically run to watch for page requests
-        server.handleClient ();
-        vTaskDelay (600);
+      LOG_ERROR(MOD_IMU, FMT_CAL_BOOT_FAILED, attempt, boot_cal_attempts);
+    }
+  }
+  if(!calibrated)
+  {
+    // Controlling with zero offsets would drive the camera to a wrong level,
+    // so keep recalibrating from live samples, with the motor braked, instead
+    LOG_ERROR(MOD_MAIN, FMT_CAL_BOOT_HELD);
+    gimbal_calibrate_request();
+  }
+  boot_stage_end(BOOT_CALIBRATE);
+
+  TickType_t last_wake = xTaskGetTickCount();
+
+  while(true)
+  {
+    vTaskDelayUntil(&last_wake, IMU_PERIOD);
+    task_woke(TASK_IMU);
+    TRACE_SCOPE("acquire");
+
+    if(gimbal_calibrate_start())
+    {
+      gimbal_config_get(config);
+      LOG_INFO(MOD_IMU, FMT_CAL_START, config.cal_samples);
+      mpu.cal_begin(config.cal_samples);
+      cal_cycles_left = (uint32_t)config.cal_samples * cal_cycle_allowance;
     }
-}
 
+    bool have_sample = mpu.read_raw(MPU_ADDR, sample.raw);
+    if(mpu.cal_running())
+    {
+      if(have_sample && mpu.cal_add(sample.raw))
+      {
+        calibrated = true;
+        gimbal_calibrate_done(true);
+      }
+      else if(--cal_cycles_left == 0)
+      {
+        mpu.cal_cancel();
+        LOG_WARN(MOD_IMU, FMT_CAL_TIMEOUT, (uint32_t)config.cal_samples * cal_cycle_allowance, config.cal_samples);
+        gimbal_calibrate_done(false);
+        if(!calibrated)
+        {
+          gimbal_calibrate_request();
+        }
+      }
+    }
 
+    if(have_sample)
+    {
+      sample.t_sampled = micros();
+      sample.trace_id++;
+      sampled.put(sample);
+      ImuRaw motion = sample.raw;
+      mpu.remove_gyro_bias(motion);
+      gyro_log_add(sample.t_sampled, motion);
+      supervisor_heartbeat(HB_ACQUIRE, sample.trace_id);
+      xTaskNotifyGive(task_handle(TASK_FUSE));
+    }
+  }
+}
 
-/** @brief   Task that reads the angles from the IMU class.
- *  @details This task runs the read angle functions from the IMU class every 100 ms.
+/** @brief   Task that turns raw IMU readings into angles, the second stage of the pipeline.
+ *  @details This task sleeps until the acquisition task has a new sample, computes
+ *           the pitch and roll angles, smooths them if the @c smoothing setting
+ *           asks for it, publishes them in the @c attitude mailbox for readers on
+ *           the other core and wakes the controller.
  *  @param   p_params Pointer to unused parameters
  */
-void task_read_IMU (void* p_params )
+void task_FUSE (void* p_params)
 {
+  PipelineSample sample;
+  AttitudeSample angles;
+  AngleFuser fuser;
+
   while(true)
   {
-    Serial << "Reading Pitch Angle" << endl;
-    mpu.read_acc_pitch(MPU_ADDR);
-    mpu.read_acc_roll(MPU_ADDR);
-    vTaskDelay(100);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    task_woke(TASK_FUSE);
+    TRACE_SCOPE("fuse");
+    sampled.get(sample);
+
+    fuser.fuse(mpu, sample.raw, sample.pitch, sample.roll);
+    sample.t_fused = micros();
+    fused.put(sample);
+
+    angles.sequence = sample.trace_id;
+    angles.time_us = sample.t_sampled;
+    angles.pitch = sample.pitch;
+    angles.roll = sample.roll;
+    attitude.put(angles);
+    supervisor_heartbeat(HB_FUSE, sample.trace_id);
+
+    xTaskNotifyGive(task_handle(TASK_PITCH));
   }
 }
 
+/** @brief   Task that controls the pitch axis, the last stages of the pipeline.
+ *  @details This task sleeps until a fused sample is ready, runs the controller on
+ *           it and writes the result to the pitch motor straight away. The sample's
+ *           stage timestamps are then added to the latency statistics. The gains
+ *           are reloaded whenever the settings change; the mode decides whether
+ *           remote setpoints are followed and whether the motor is driven at all.
+ *  @param   p_params Pointer to unused parameters
+ */
 void task_PITCH (void* p_params)
 {
-  
-  // Variables related to desired angles
-  int16_t pitch_home = 0;
-  int16_t pitch_max = 40;
-  int16_t pitch_min = -40;
-  int16_t err_accept = 10;
-  int16_t err_pitch;
-
-  int16_t current_pitch; // Pitch from IMU
-  int16_t prev_pitch; 
-  int16_t set_pitch;     // Pitch from controller
-  
-  int16_t pitch_kp = 10;
+  PitchLoop loop(pitch_quality);
+  loop.begin();
+
+  PipelineSample sample;
+  PitchCycle cycle;
+  TelemetryRecord record;
+  BlackboxRecord box;
 
-  int16_t state = 0;
+  // Wait until the IMU is calibrated and the motors are set up
+  boot_stage_begin(BOOT_CONTROL);
 
   while(true)
   {
-    if(state == 0)
-    {
-      //Serial << "Motor Stopped" << endl;
-      pitch_motor.brake();
-      prev_pitch = current_pitch;
-      current_pitch = pitch.get();
-      //Serial << "Retrieved pitch: " << current_pitch << endl;
-      
-      //delay(1500);
-
-      //Serial << prev_pitch << " , " << current_pitch << endl;
-      err_pitch = pitch_home - current_pitch; 
-      
-      Serial << "Calculated error: " << err_pitch << endl;
-      
-      if(abs(err_pitch) < abs(err_accept)) 
-      {
-        //Serial << "This is fine :)" << endl;
-        state = 4;
-      }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    task_woke(TASK_PITCH);
+    TRACE_SCOPE("control_cycle");
+    fused.get(sample);
 
-      if(abs(err_pitch) > abs(err_accept))
-      {
-        //Serial << "This is not fine, " << err_pitch << endl;
-        state = 1;
-      }
-    }
+    cycle = loop.control(sample.pitch, udp_pitch_setpoint);
+    sample.t_controlled = micros();
 
-    if(state == 1)
     {
-      set_pitch = err_pitch * pitch_kp;
-      //Serial << "Setpoint acquired: " << set_pitch << endl;
-
-      if(set_pitch < 0)
+      PROFILE_SCOPE("pitch_actuate");
+      if(!supervisor_motors_enabled())
       {
-        //pitch_motor.spin(50,0);
-        state = 2;
+        // The supervisor is holding the motors in the safe state
       }
-      if(set_pitch > 0)
+      else if(cycle.command.brake)
       {
-        //pitch_motor.spin(0,50);
-        state = 3;
+        pitch_motor.brake();
       }
-      if(set_pitch = 0)
+      else
       {
-        //pitch_motor.brake();
-        //delay(1000);
-        state = 4;
+        pitch_motor.spin(cycle.command.ch1_dc, cycle.command.ch2_dc);
       }
     }
-
-    if(state == 2)
+    sample.t_actuated = micros();
+    supervisor_heartbeat(HB_CONTROL, sample.trace_id);
+    if(!boot_done(BOOT_CONTROL))
     {
-      //Serial << "Setpoint was counter, motor spinning clockwise" << endl;
-      pitch_motor.spin(25,0);
-      delay(100);
-      state = 4;
+      boot_stage_end(BOOT_CONTROL);
     }
 
-    if(state == 3)
-    {
-      //Serial << "Setpoint was clock, motor spinning counter" << endl;
-      pitch_motor.spin(0,50);
-      delay(60);
-      state = 4;
-    }
-
-    if(state == 4)
-    {
-      //Serial << "Motor braking" << endl;
-      pitch_motor.brake();
-      delay(100);
-      state = 0; 
-    }
-
-    vTaskDelay(300);  
+    LOG_DEBUG(MOD_CONTROL, FMT_PITCH_ERROR, cycle.error);
+    pipeline_stats.record(sample);
+
+    record.time_us = sample.t_sampled;
+    record.sequence = sample.trace_id;
+    record.angle = sample.pitch;
+    record.rate = sample.raw.GyY;
+    record.setpoint = cycle.setpoint;
+    record.error = cycle.error;
+    record.effort = cycle.effort;
+    record.flags = (cycle.command.brake ? TELEM_BRAKE : 0) | (supervisor_motors_enabled() ? 0 : TELEM_HELD)
+                   | (cycle.idle ? TELEM_IDLE : 0);
+    record.flags |= loop.measure(record.time_us, record.angle, cycle);
+    telemetry_record(record);
+
+    box.time_us = sample.t_sampled;
+    box.sequence = sample.trace_id;
+    box.raw = sample.raw;
+    box.pitch = sample.pitch;
+    box.roll = sample.roll;
+    box.setpoint = record.setpoint;
+    box.effort = record.effort;
+    box.flags = record.flags;
+    box.state = supervisor_state();
+    blackbox_record(box);
+    rolling_stats_add(record.time_us, record.error, record.effort, sample.t_actuated - sample.t_sampled);
   }
 }
 void task_YAW (void* p_params)
@@ -298,26 +372,58 @@ void task_ROLL (void* p_params)
 
 void setup() 
 {
+  boot_stage_begin (BOOT_SERIAL);
   Serial.begin (115200);
     while (!Serial) 
     {
     }
-
-  setup_wifi();
-  mpu.IMU_init(I2C_SDA, I2C_SCL, MPU_ADDR, PWR_MGMT_1);
+  boot_stage_end (BOOT_SERIAL);
+
+  boot_stage_begin (BOOT_LOGGER);
+  task_start (TASK_LOG);
+  boot_stage_end (BOOT_LOGGER);
+
+  core_load_begin ();
+
+  serial_cmd_register ("config", gimbal_config_print, "settings, mode and calibrations");
+  serial_cmd_register ("wifi", wifi_print, "state of the WiFi link");
+  serial_cmd_register ("udp", udp_print, "UDP telemetry and command channel");
+  serial_cmd_register ("stream", stream_print, "live telemetry stream clients");
+  serial_cmd_register ("quality", print_quality, "stabilization quality of the pitch axis");
+  serial_cmd_register ("blackbox", blackbox_print, "black-box recorder state and recordings");
+  serial_cmd_register ("bbtrigger", print_blackbox_trigger, "save a black-box recording now");
+  serial_cmd_register ("flashlog", flash_log_print, "flash log segments and drops");
+  serial_cmd_register ("gyro", gyro_log_print, "gyro log for Gyroflow");
+  serial_cmd_register ("gyrostart", print_gyro_start, "start recording a gyro log take");
+  serial_cmd_register ("gyrostop", print_gyro_stop, "stop recording the gyro log take");
+  serial_cmd_register ("sync", frame_sync_print, "camera frame sync edges");
+  serial_cmd_register ("trends", rolling_stats_print, "latest 1 s, 10 s and 1 min trend windows");
+  serial_cmd_register ("boot", boot_print, "timeline of the boot stages");
+  serial_cmd_register ("health", supervisor_print, "supervisor state and stage heartbeats");
+  serial_cmd_register ("stats", cpu_stats_print, "CPU use of each task and core");
+  serial_cmd_register ("memory", task_report_memory, "stack high-water marks and heap");
+  serial_cmd_register ("latency", print_latency, "latency of each pipeline stage");
+  serial_cmd_register ("load", core_load_print, "tick-sampled load on each core");
+  serial_cmd_register ("prof", profiler_print, "cycle counts of each profiled scope");
+  serial_cmd_register ("profreset", print_profiler_reset, "clear the scope profiler");
+  serial_cmd_register ("trace", trace_export_json, "dump the trace ring as Chrome trace JSON");
+  serial_cmd_register ("traceclear", print_trace_clear, "clear the trace ring");
+
+  supervisor_begin (all_motors, sizeof (all_motors) / sizeof (all_motors[0]));
+
+  // Acquisition and control are pinned to core 1; the server shares core 0
+  // with the WiFi stack. See the task table in task_config.h. The IMU task
+  // wakes and calibrates the IMU and the WiFi task brings up the network
+  // while the motors are set up here; see the stages in boot_sequence.h
+  tasks_start ();
+
+  boot_stage_begin (BOOT_PWM);
   pitch_motor.init(m1_in1_pin, m1_in2_pin, m1_freq, pwm_resolution);
   roll_motor.init(m2_in1_pin, m2_in2_pin,m2_freq, pwm_resolution);
   yaw_motor.init(m3_in1_pin, m3_in2_pin,m3_freq, pwm_resolution);
+  boot_stage_end (BOOT_PWM);
 
-  Serial << "Hold IMU flat" << endl;
-  delay (1000);
-  mpu.cal_acc_pitch (MPU_ADDR);
-  mpu.cal_acc_roll (MPU_ADDR);
-
-  xTaskCreate (task_read_IMU, "Reading" , 2048, NULL, 2, NULL);
-  xTaskCreate (task_PITCH, "Testing Pitch Axis", 2048, NULL, 2, NULL);
-  //xTaskCreate (task_ROLL, "Testing Roll Axis", 2048, NULL, 1, NULL);
-  xTaskCreate (task_SERVER, "Handling webpage", 2048, NULL, 1, NULL);
+  frame_sync_begin (frame_sync_pin, RISING);
 
   
 
@@ -8,11 +8,17 @@
 */
 
 #include "motor_obj.h"
+#include "logger.h"
+
+/// The ESP32 has 16 LEDC channels; each pair shares a timer, so each motor gets its own
+uint8_t Motor :: next_channel = 0;
 
 /** @brief  Method to initialize a motor object with specific parameters
  * 
  *  @details This method will allow a motor object to be initialized 
- *           with the inputs listed below, which will allow for 3 different motors
+ *           with the inputs listed below, which will allow for 3 different motors.
+ *           Each motor claims the next pair of LEDC channels, so motors don't
+ *           drive each other's pins and each can have its own frequency.
  * 
  *  @param   in1_pin This is the pin number for channel 1 of the motor driver
  *  @param   in2_pin This is the pin number for channel 2 of the motor driver
@@ -24,8 +30,8 @@
 
 void Motor :: init(uint8_t in1_pin, uint8_t in2_pin, uint32_t freq, uint8_t res)
 {
-    uint8_t in1_channel = 0;
-    uint8_t in2_channel = 1;
+    in1_channel = next_channel++;
+    in2_channel = next_channel++;
     
     pinMode(in1_pin, OUTPUT);
     pinMode(in2_pin, OUTPUT);
@@ -39,17 +45,14 @@ void Motor :: init(uint8_t in1_pin, uint8_t in2_pin, uint32_t freq, uint8_t res)
 
 void Motor :: spin (uint8_t ch1_dc, uint8_t ch2_dc)
 {
-    uint8_t in1_channel = 0;
-    uint8_t in2_channel = 1;
-    
     if (ch1_dc > 0 && ch2_dc == 0)
     {
-        Serial << "Motor spinning forward" << endl;
+        LOG_DEBUG (MOD_MOTOR, FMT_MOTOR_FORWARD);
     }
 
     if (ch1_dc == 0 && ch2_dc > 0)
     {
-        Serial << "Motor spinning backwards" << endl;
+        LOG_DEBUG (MOD_MOTOR, FMT_MOTOR_BACKWARD);
     }
 
    
@@ -60,14 +63,22 @@ void Motor :: spin (uint8_t ch1_dc, uint8_t ch2_dc)
 
 void Motor :: brake (void)
 {
-    uint8_t in1_channel = 0;
-    uint8_t in2_channel = 1;
-    
-    Serial << "Motor braked" << endl;
+    LOG_DEBUG (MOD_MOTOR, FMT_MOTOR_BRAKE);
     
     ledcWrite (in1_channel, 255);
     ledcWrite (in2_channel, 255);
 }
 
+/** @brief  Method which lets the motor spin freely
+ * 
+ *  @details Both channels are driven low, so the driver's outputs float and the
+ *           motor coasts instead of being shorted as it is by @c brake()
+*/
+void Motor :: coast (void)
+{
+    ledcWrite (in1_channel, 0);
+    ledcWrite (in2_channel, 0);
+}
+
 
 
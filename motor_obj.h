@@ -21,12 +21,17 @@ class Motor
 {
     protected:
     float motor_time_tau = 6.08; // milliseconds
+    uint8_t in1_channel = 0;    ///< LEDC channel driving channel 1 of the motor driver
+    uint8_t in2_channel = 1;    ///< LEDC channel driving channel 2 of the motor driver
+
+    static uint8_t next_channel;    ///< First LEDC channel not yet claimed by a motor
 
 
     public:
         void init(uint8_t in1_pin, uint8_t in2_pin, uint32_t freq, uint8_t res);
         void spin (uint8_t ch1_dc, uint8_t ch2_dc);
         void brake (void);
+        void coast (void);
     
 };
 
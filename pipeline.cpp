@@ -0,0 +1,126 @@
+/** @file pipeline.cpp
+ * This is the implementation file for the latency statistics kept on the
+ * sensor-to-actuator pipeline.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "pipeline.h"
+
+/// Names printed for each stage in the latency report
+static const char* const STAGE_NAMES[NUM_STAGES] = { "fuse", "control", "actuate", "sample-to-motor" };
+
+
+/** @brief   Create an empty histogram.
+*/
+LatencyHistogram :: LatencyHistogram (void)
+{
+    reset ();
+}
+
+/** @brief   Clear all the counts in the histogram.
+*/
+void LatencyHistogram :: reset (void)
+{
+    memset (buckets, 0, sizeof (buckets));
+    count = 0;
+    max_us = 0;
+    total_us = 0;
+}
+
+/** @brief   Add one latency to the histogram.
+ *  @param   latency_us The latency in microseconds
+*/
+void LatencyHistogram :: record (uint32_t latency_us)
+{
+    uint8_t bucket = 0;
+    for (uint32_t value = latency_us >> 1; value != 0 && bucket < NUM_BUCKETS - 1; value >>= 1)
+    {
+        bucket++;
+    }
+    buckets[bucket]++;
+    count++;
+    total_us += latency_us;
+    if (latency_us > max_us)
+    {
+        max_us = latency_us;
+    }
+}
+
+/** @brief   Find an upper bound for a percentile of the recorded latencies.
+ *  @param   percent The percentile wanted, from 0 to 100
+ *  @returns The top of the bucket which holds that percentile, in microseconds
+*/
+uint32_t LatencyHistogram :: percentile (uint8_t percent) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint32_t wanted = ((uint64_t)count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+    {
+        seen += buckets[bucket];
+        if (seen >= wanted)
+        {
+            uint32_t top = (2UL << bucket) - 1;
+            return top < max_us ? top : max_us;
+        }
+    }
+    return max_us;
+}
+
+/** @brief   Print a one-line summary of the histogram.
+ *  @param   out The device to which the summary is printed
+*/
+void LatencyHistogram :: print (Print& out) const
+{
+    out << "n=" << count << " mean=" << get_mean () << "us p50<=" << percentile (50)
+        << "us p99<=" << percentile (99) << "us max=" << max_us << "us";
+}
+
+
+/** @brief   Create an empty set of pipeline statistics.
+*/
+PipelineStats :: PipelineStats (void)
+{
+    last_trace_id = 0;
+    dropped = 0;
+}
+
+/** @brief   Record the latencies of a sample which has been through every stage.
+ *  @details Samples skipped between this one and the last one recorded were
+ *           overwritten before the controller got to them and are counted as dropped.
+ *  @param   sample The sample, with all of its timestamps filled in
+*/
+void PipelineStats :: record (const PipelineSample& sample)
+{
+    if (last_trace_id != 0 && sample.trace_id > last_trace_id + 1)
+    {
+        dropped += sample.trace_id - last_trace_id - 1;
+    }
+    last_trace_id = sample.trace_id;
+
+    stages[STAGE_FUSE].record (sample.t_fused - sample.t_sampled);
+    stages[STAGE_CONTROL].record (sample.t_controlled - sample.t_fused);
+    stages[STAGE_ACTUATE].record (sample.t_actuated - sample.t_controlled);
+    stages[STAGE_TOTAL].record (sample.t_actuated - sample.t_sampled);
+}
+
+/** @brief   Print the latency of every stage in human readable form.
+ *  @param   out The device to which the report is printed
+*/
+void PipelineStats :: print (Print& out) const
+{
+    for (uint8_t index = 0; index < NUM_STAGES; index++)
+    {
+        out << STAGE_NAMES[index] << ": ";
+        stages[index].print (out);
+        out << endl;
+    }
+    out << "last trace ID: " << last_trace_id << ", dropped: " << dropped << endl;
+}
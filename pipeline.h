@@ -0,0 +1,90 @@
+/** @file pipeline.h
+ * This is the header file for the sensor-to-actuator pipeline. Each sample
+ * travels through the stages acquire, fuse, control and actuate; each stage's
+ * task is woken by a notification from the one before it. The sample carries
+ * a trace ID and a timestamp from every stage so the latency of each stage,
+ * and of the whole chain, can be measured.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _PIPELINE_
+#define _PIPELINE_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "IMU.h"
+
+/** @brief One sample on its way from the IMU to the motors
+*/
+struct PipelineSample
+{
+    uint32_t trace_id;      ///< Sequence number given to the sample when it was read
+    uint32_t t_sampled;     ///< Time in microseconds at which the I2C read finished
+    uint32_t t_fused;       ///< Time at which the angles were computed
+    uint32_t t_controlled;  ///< Time at which the controller finished
+    uint32_t t_actuated;    ///< Time at which the motor duty cycles were written
+    ImuRaw raw;             ///< Raw readings from the IMU
+    int16_t pitch;          ///< Pitch angle in degrees, filled in by the fuse stage
+    int16_t roll;           ///< Roll angle in degrees, filled in by the fuse stage
+};
+
+/** @brief Latencies which are measured for each sample
+*/
+enum PipelineStage
+{
+    STAGE_FUSE,             ///< From sample read to angles computed
+    STAGE_CONTROL,          ///< From angles computed to controller finished
+    STAGE_ACTUATE,          ///< From controller finished to duty cycles written
+    STAGE_TOTAL,            ///< From sample read to duty cycles written
+    NUM_STAGES
+};
+
+/** @brief   Class which keeps a histogram of latencies in microseconds.
+ *  @details Bucket @c n counts latencies from 2^n up to 2^(n+1) - 1 microseconds,
+ *           with bucket 0 also holding zero. Only one task may record into a
+ *           histogram; any task may read it.
+*/
+class LatencyHistogram
+{
+    public:
+        static const uint8_t NUM_BUCKETS = 20;  ///< Enough for latencies up to about a second
+
+    protected:
+        uint32_t buckets[NUM_BUCKETS];  ///< Number of latencies which fell in each bucket
+        uint32_t count;                 ///< Number of latencies recorded
+        uint32_t max_us;                ///< Largest latency recorded
+        uint64_t total_us;              ///< Sum of all latencies, for the mean
+
+    public:
+        LatencyHistogram (void);
+        void record (uint32_t latency_us);
+        void reset (void);
+        uint32_t get_count (void) const { return count; }
+        uint32_t get_max (void) const { return max_us; }
+        uint32_t get_mean (void) const { return count ? total_us / count : 0; }
+        uint32_t percentile (uint8_t percent) const;
+        void print (Print& out) const;
+};
+
+/** @brief Class which records the latencies of every stage of the pipeline
+*/
+class PipelineStats
+{
+    protected:
+        LatencyHistogram stages[NUM_STAGES];    ///< One histogram per measured latency
+        uint32_t last_trace_id;                 ///< Trace ID of the last sample recorded
+        uint32_t dropped;                       ///< Samples overwritten before being controlled
+
+    public:
+        PipelineStats (void);
+        void record (const PipelineSample& sample);
+        const LatencyHistogram& stage (PipelineStage which) const { return stages[which]; }
+        uint32_t get_dropped (void) const { return dropped; }
+        void print (Print& out) const;
+};
+
+#endif
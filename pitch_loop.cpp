@@ -0,0 +1,123 @@
+/** @file pitch_loop.cpp
+ * This is the implementation file for the work done each cycle by the fuse
+ * and pitch stages of the pipeline.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "pitch_loop.h"
+#include "task_config.h"
+#include "scope_profiler.h"
+
+
+/** @brief   Compute the pitch and roll angles of a sample and smooth them.
+ *  @details With the @c smoothing setting at zero the angles are passed on as
+ *           they are; otherwise each is a shift filter with that many bits.
+ *           The angle functions are profiled here rather than inside @c IMU,
+ *           as the IMU task also calls them while calibrating.
+ *  @param   imu The IMU whose calibration offsets are applied
+ *  @param   raw Raw readings from @c IMU::read_raw()
+ *  @param   pitch Where the pitch angle in degrees is put
+ *  @param   roll Where the roll angle in degrees is put
+ */
+void AngleFuser :: fuse (IMU& imu, const ImuRaw& raw, int16_t& pitch, int16_t& roll)
+{
+    {
+        PROFILE_SCOPE ("acc_pitch");
+        pitch = imu.acc_pitch (raw);
+    }
+    {
+        PROFILE_SCOPE ("acc_roll");
+        roll = imu.acc_roll (raw);
+    }
+
+    GimbalConfig config;
+    gimbal_config_get (config);
+    if (config.smoothing == 0)
+    {
+        pitch_smooth = pitch * 256L;
+        roll_smooth = roll * 256L;
+    }
+    else
+    {
+        pitch_smooth += (pitch * 256L - pitch_smooth) >> config.smoothing;
+        roll_smooth += (roll * 256L - roll_smooth) >> config.smoothing;
+        pitch = (pitch_smooth + 128) >> 8;
+        roll = (roll_smooth + 128) >> 8;
+    }
+}
+
+/** @brief   Set the controller and the quality metrics up from @c config.
+ *  @param   home The angle the controller holds until it is given a target
+ */
+void PitchLoop :: apply_config (int16_t home)
+{
+    controller.init (home, config.accept, config.kp, config.duty_forward, config.duty_reverse);
+    controller.set_slew (config.slew_rate * 1000L / CONTROL_RATE_HZ);
+    quality.set_min_band (config.accept);
+    quality.set_limits (config.duty_forward, config.duty_reverse);
+}
+
+/** @brief   Load the settings and start holding the home angle.
+ */
+void PitchLoop :: begin (void)
+{
+    config_version = gimbal_config_version ();
+    gimbal_config_get (config);
+    apply_config (config.home);
+}
+
+/** @brief   Run one control cycle on a fused angle.
+ *  @details The settings are reloaded first if they have changed, which
+ *           also clears the quality metrics so they belong to one tuning. In
+ *           the stabilize mode a fresh remote setpoint replaces home. The
+ *           motor is braked in the idle mode and while a calibration is asked
+ *           for or under way.
+ *  @param   angle The fused pitch angle in degrees
+ *  @param   remote_setpoint Function which gives the remote setpoint and
+ *           returns @c true if there is a fresh one
+ *  @returns What the motor should do and why
+ */
+PitchCycle PitchLoop :: control (int16_t angle, bool (*remote_setpoint)(int16_t&))
+{
+    if (gimbal_config_version () != config_version)
+    {
+        config_version = gimbal_config_version ();
+        gimbal_config_get (config);
+        apply_config (controller.get_home ());
+        quality.reset ();
+    }
+
+    GimbalMode mode = gimbal_mode ();
+    int16_t setpoint = config.home;
+    if (mode == MODE_STABILIZE)
+    {
+        remote_setpoint (setpoint);
+    }
+
+    PitchCycle cycle;
+    controller.set_target (setpoint);
+    cycle.command = controller.update (angle);
+    cycle.idle = (mode == MODE_IDLE) || gimbal_calibrating ();
+    if (cycle.idle)
+    {
+        cycle.command.brake = true;
+    }
+    cycle.setpoint = controller.get_home ();
+    cycle.error = controller.get_error ();
+    cycle.effort = cycle.command.brake ? 0 : (int16_t)cycle.command.ch1_dc - cycle.command.ch2_dc;
+    return cycle;
+}
+
+/** @brief   Record a control cycle in the quality metrics.
+ *  @param   time_us Time at which the IMU was sampled, from @c micros()
+ *  @param   angle The fused pitch angle in degrees
+ *  @param   cycle What @c control() decided for this angle
+ *  @returns The @c TELEM_STEP and @c TELEM_SATURATED flags for the cycle
+ */
+uint8_t PitchLoop :: measure (uint32_t time_us, int16_t angle, const PitchCycle& cycle)
+{
+    return quality.record (time_us, angle, cycle.setpoint, cycle.effort);
+}
@@ -0,0 +1,69 @@
+/** @file pitch_loop.h
+ * This is the header file for the work done each cycle by the fuse and pitch
+ * stages of the pipeline. The tasks in main.cpp wrap these steps with their
+ * notifications, timestamps and heartbeats; the simulator in sim/ calls the
+ * same steps, so what it measures is what the firmware does, including the
+ * settings reloads, the mode and the braking during a calibration.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _PITCH_LOOP_
+#define _PITCH_LOOP_
+
+#include <Arduino.h>
+
+#include "IMU.h"
+#include "controller.h"
+#include "gimbal_config.h"
+#include "stab_metrics.h"
+
+/** @brief   Class which turns raw IMU readings into angles, smoothed as the settings ask.
+ */
+class AngleFuser
+{
+    protected:
+        int32_t pitch_smooth;   ///< Smoothed pitch angle in 1/256 degree
+        int32_t roll_smooth;    ///< Smoothed roll angle in 1/256 degree
+
+    public:
+        AngleFuser (void) : pitch_smooth (0), roll_smooth (0) { }
+        void fuse (IMU& imu, const ImuRaw& raw, int16_t& pitch, int16_t& roll);
+};
+
+/** @brief What one cycle of the pitch loop decided
+*/
+struct PitchCycle
+{
+    MotorCommand command;   ///< What the pitch motor should do; braked while idle
+    int16_t setpoint;       ///< Angle the controller is holding, after the slew limit
+    int16_t error;          ///< Control error in degrees
+    int16_t effort;         ///< Channel 1 duty minus channel 2 duty; zero when braked
+    bool idle;              ///< @c true if the mode or a calibration braked the motor
+};
+
+/** @brief   Class which runs the pitch controller from the current settings and mode.
+ *  @details Only one task may use a pitch loop. @c control() is kept short as
+ *           the motor is written straight after it; @c measure() records the
+ *           cycle in the quality metrics once the motor has been written.
+ */
+class PitchLoop
+{
+    protected:
+        AxisController controller;      ///< The control law
+        StabilityMetrics& quality;      ///< Where each cycle is measured
+        GimbalConfig config;            ///< Settings in use
+        uint32_t config_version;        ///< Version of the settings in @c config
+
+        void apply_config (int16_t home);
+
+    public:
+        PitchLoop (StabilityMetrics& metrics) : quality (metrics), config_version (0) { }
+        void begin (void);
+        PitchCycle control (int16_t angle, bool (*remote_setpoint)(int16_t&));
+        uint8_t measure (uint32_t time_us, int16_t angle, const PitchCycle& cycle);
+};
+
+#endif
@@ -0,0 +1,64 @@
+/** @file response_pool.cpp
+ * This is the implementation file for the pool of web reply buffers.
+ * Slots are claimed with an atomic flag, so any task may take or release
+ * one without a lock.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "response_pool.h"
+
+static ResponseSlot slots[RESPONSE_SLOTS];                  ///< The buffers
+static std::atomic<bool> busy[RESPONSE_SLOTS];              ///< Set while a slot is in use
+static std::atomic<uint32_t> acquired (0);                  ///< Slots handed out since boot
+static std::atomic<uint32_t> refused (0);                   ///< Requests turned away because every slot was busy
+
+
+/** @brief   Claim a free slot.
+ *  @returns The slot, or @c NULL if every slot is in use
+*/
+ResponseSlot* response_acquire (void)
+{
+    for (uint8_t index = 0; index < RESPONSE_SLOTS; index++)
+    {
+        bool expected = false;
+        if (busy[index].compare_exchange_strong (expected, true, std::memory_order_acquire))
+        {
+            slots[index].cleanup = NULL;
+            acquired++;
+            return &slots[index];
+        }
+    }
+    refused++;
+    return NULL;
+}
+
+/** @brief   Run a slot's cleanup function, if any, and hand the slot back.
+ *  @param   slot The slot from @c response_acquire()
+*/
+void response_release (ResponseSlot* slot)
+{
+    if (slot->cleanup)
+    {
+        slot->cleanup (slot);
+        slot->cleanup = NULL;
+    }
+    busy[slot - slots].store (false, std::memory_order_release);
+}
+
+/** @brief   Print how the pool is being used.
+ *  @param   out The device to which the report is printed
+*/
+void response_pool_print (Print& out)
+{
+    uint8_t in_use = 0;
+    for (uint8_t index = 0; index < RESPONSE_SLOTS; index++)
+    {
+        in_use += busy[index].load () ? 1 : 0;
+    }
+    out << "Reply buffers: " << in_use << " of " << RESPONSE_SLOTS << " in use, "
+        << acquired.load () << " used since boot, " << refused.load () << " requests refused" << endl;
+}
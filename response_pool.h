@@ -0,0 +1,33 @@
+/** @file response_pool.h
+ * This is the header file for the pool of web reply buffers. Dynamic replies
+ * are rendered into one of a few fixed slots and sent from there, and long
+ * replies keep their producer in a slot, so serving a page never touches the
+ * heap for its content. The slot is handed back when the client goes away.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _RESPONSE_POOL_
+#define _RESPONSE_POOL_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+const uint8_t RESPONSE_SLOTS = 4;           ///< Replies which can be in flight at once
+const size_t RESPONSE_SLOT_BYTES = 3072;    ///< Size of each slot
+
+/** @brief One buffer in the pool
+*/
+struct ResponseSlot
+{
+    alignas (8) uint8_t data[RESPONSE_SLOT_BYTES];  ///< The rendered reply, or the object producing it
+    void (*cleanup)(ResponseSlot*);     ///< Run when the slot is released, or @c NULL
+};
+
+ResponseSlot* response_acquire (void);
+void response_release (ResponseSlot* slot);
+void response_pool_print (Print& out);
+
+#endif
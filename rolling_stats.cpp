@@ -0,0 +1,335 @@
+/** @file rolling_stats.cpp
+ * This is the implementation file for the rolling statistics. The control
+ * task is the only writer. Each finished window is put in a @c Mailbox in
+ * its level's history, so readers on the other core get a consistent copy
+ * of it without a lock.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "rolling_stats.h"
+#include "json_writer.h"
+#include "lockfree.h"
+
+/// Names of the metrics, for reports
+static const char* const metric_names[NUM_METRICS] =
+{
+#define ROLLING_METRIC_NAME(id, name) name,
+    ROLLING_METRICS (ROLLING_METRIC_NAME)
+#undef ROLLING_METRIC_NAME
+};
+
+/// Names of the levels, for reports and requests
+static const char* const level_names[NUM_LEVELS] =
+{
+#define ROLLING_LEVEL_NAME(id, name, seconds, kept) name,
+    ROLLING_LEVELS (ROLLING_LEVEL_NAME)
+#undef ROLLING_LEVEL_NAME
+};
+
+/// Length of each level's windows in seconds
+static const uint16_t level_seconds[NUM_LEVELS] =
+{
+#define ROLLING_LEVEL_SECONDS(id, name, seconds, kept) seconds,
+    ROLLING_LEVELS (ROLLING_LEVEL_SECONDS)
+#undef ROLLING_LEVEL_SECONDS
+};
+
+/// Number of finished windows kept at each level
+static const uint16_t level_kept[NUM_LEVELS] =
+{
+#define ROLLING_LEVEL_KEPT(id, name, seconds, kept) kept,
+    ROLLING_LEVELS (ROLLING_LEVEL_KEPT)
+#undef ROLLING_LEVEL_KEPT
+};
+
+/// Finished windows kept at all levels together
+const uint16_t HISTORY_SIZE = 0
+#define ROLLING_LEVEL_SUM(id, name, seconds, kept) + kept
+    ROLLING_LEVELS (ROLLING_LEVEL_SUM)
+#undef ROLLING_LEVEL_SUM
+    ;
+
+static RollingWindow current[NUM_LEVELS];               ///< The window being summed at each level
+static uint16_t merged[NUM_LEVELS];                     ///< Windows of the level below merged into @c current
+static uint32_t second_start_us;                        ///< When the current one-second window began
+static bool started = false;                            ///< Set once the first value has been added
+static Mailbox<RollingWindow> history[HISTORY_SIZE];    ///< Finished windows, each level's after the one before's
+static std::atomic<uint32_t> finished[NUM_LEVELS];      ///< Windows finished at each level since boot
+
+
+/** @brief   Empty the sums.
+*/
+void RunningStat :: clear (void)
+{
+    count = 0;
+    min = INT32_MAX;
+    max = INT32_MIN;
+    sum = 0;
+    sum_squares = 0;
+}
+
+/** @brief   Add one value to the sums.
+ *  @param   value The value
+*/
+void RunningStat :: add (int32_t value)
+{
+    count++;
+    min = (value < min) ? value : min;
+    max = (value > max) ? value : max;
+    sum += value;
+    sum_squares += (int64_t)value * value;
+}
+
+/** @brief   Add the sums from another window to these.
+ *  @param   other The other window's sums
+*/
+void RunningStat :: merge (const RunningStat& other)
+{
+    count += other.count;
+    min = (other.min < min) ? other.min : min;
+    max = (other.max > max) ? other.max : max;
+    sum += other.sum;
+    sum_squares += other.sum_squares;
+}
+
+/** @brief   Find where a window is kept in the history.
+ *  @param   level The window's level
+ *  @param   number The window's number, counted from the first at that level since boot
+ */
+static Mailbox<RollingWindow>& history_slot (uint8_t level, uint32_t number)
+{
+    uint16_t offset = 0;
+    for (uint8_t below = 0; below < level; below++)
+    {
+        offset += level_kept[below];
+    }
+    return history[offset + number % level_kept[level]];
+}
+
+/** @brief   Start a new window at one level.
+ *  @param   level The level
+ */
+static void open_window (uint8_t level)
+{
+    current[level].start_ms = millis ();
+    for (uint8_t metric = 0; metric < NUM_METRICS; metric++)
+    {
+        current[level].stats[metric].clear ();
+    }
+    merged[level] = 0;
+}
+
+/** @brief   Finish the window at one level, merge it into the level above and start the next.
+ *  @param   level The level
+ */
+static void close_window (uint8_t level)
+{
+    uint32_t number = finished[level].load (std::memory_order_relaxed);
+    history_slot (level, number).put (current[level]);
+    finished[level].store (number + 1, std::memory_order_release);
+
+    if (level + 1 < NUM_LEVELS)
+    {
+        RollingWindow& above = current[level + 1];
+        if (merged[level + 1] == 0)
+        {
+            above.start_ms = current[level].start_ms;
+        }
+        for (uint8_t metric = 0; metric < NUM_METRICS; metric++)
+        {
+            above.stats[metric].merge (current[level].stats[metric]);
+        }
+        if (++merged[level + 1] * level_seconds[level] >= level_seconds[level + 1])
+        {
+            close_window (level + 1);
+        }
+    }
+    open_window (level);
+}
+
+/** @brief   Add the results of one control cycle.
+ *  @details Only the control task may call this function. A window is closed
+ *           by the first sample taken a whole window length after it opened.
+ *  @param   time_us Time at which the IMU was sampled, from @c micros()
+ *  @param   error Control error in degrees
+ *  @param   effort Motor effort
+ *  @param   latency_us Time from the IMU sample to the motor being driven
+ */
+void rolling_stats_add (uint32_t time_us, int32_t error, int32_t effort, int32_t latency_us)
+{
+    if (!started)
+    {
+        for (uint8_t level = 0; level < NUM_LEVELS; level++)
+        {
+            open_window (level);
+        }
+        second_start_us = time_us;
+        started = true;
+    }
+    else if (time_us - second_start_us >= level_seconds[LEVEL_SECOND] * 1000000UL)
+    {
+        close_window (LEVEL_SECOND);
+        second_start_us = time_us;
+    }
+
+    RunningStat* stats = current[LEVEL_SECOND].stats;
+    stats[METRIC_ERROR].add (error);
+    stats[METRIC_EFFORT].add (effort);
+    stats[METRIC_LATENCY].add (latency_us);
+}
+
+/** @brief   Get the most recently finished window at a level.
+ *  @param   level The level
+ *  @param   window A reference to where the window is copied
+ *  @returns @c true if a window has been finished at that level
+ */
+bool rolling_stats_latest (RollingLevel level, RollingWindow& window)
+{
+    uint32_t count = finished[level].load (std::memory_order_acquire);
+    if (count == 0)
+    {
+        return false;
+    }
+    return history_slot (level, count - 1).get (window);
+}
+
+/** @brief   Look up a level by name.
+ *  @param   name The name, such as @c "10s"
+ *  @param   level Set to the level if the name is known
+ *  @returns @c true if the name is known
+ */
+bool rolling_stats_level (const char* name, RollingLevel& level)
+{
+    for (uint8_t index = 0; index < NUM_LEVELS; index++)
+    {
+        if (strcmp (name, level_names[index]) == 0)
+        {
+            level = (RollingLevel)index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief   Write the latest finished window at each level as a JSON object.
+ *  @param   out The device to which the object is written
+ */
+void rolling_stats_json (Print& out)
+{
+    JsonWriter json (out);
+    RollingWindow window;
+
+    json.begin_object ();
+    for (uint8_t level = 0; level < NUM_LEVELS; level++)
+    {
+        json.begin_object (level_names[level]);
+        if (rolling_stats_latest ((RollingLevel)level, window))
+        {
+            json.value ("start_ms", window.start_ms);
+            json.value ("samples", window.stats[0].count);
+            for (uint8_t metric = 0; metric < NUM_METRICS; metric++)
+            {
+                const RunningStat& stat = window.stats[metric];
+                json.begin_object (metric_names[metric]);
+                json.value ("mean", stat.mean (), 2);
+                json.value ("rms", stat.rms (), 2);
+                json.value ("min", (long)stat.min);
+                json.value ("max", (long)stat.max);
+                json.end_object ();
+            }
+        }
+        json.end_object ();
+    }
+    json.end_object ();
+}
+
+/** @brief   Print the latest finished window at each level.
+ *  @param   out The device to which the report is printed
+ */
+void rolling_stats_print (Print& out)
+{
+    RollingWindow window;
+    for (uint8_t level = 0; level < NUM_LEVELS; level++)
+    {
+        out << level_names[level] << ": ";
+        if (!rolling_stats_latest ((RollingLevel)level, window))
+        {
+            out << "no window finished yet" << endl;
+            continue;
+        }
+        out << window.stats[0].count << " samples from " << window.start_ms << " ms" << endl;
+        for (uint8_t metric = 0; metric < NUM_METRICS; metric++)
+        {
+            const RunningStat& stat = window.stats[metric];
+            out << "  " << metric_names[metric] << ": mean " << stat.mean () << ", RMS " << stat.rms ()
+                << ", " << stat.min << " to " << stat.max << endl;
+        }
+    }
+}
+
+/** @brief   Start a CSV export of the windows kept at one level.
+ *  @param   cursor The cursor which keeps track of the export
+ *  @param   level The level
+ */
+void rolling_csv_begin (RollingCsvCursor& cursor, RollingLevel level)
+{
+    cursor.level = level;
+    cursor.end = finished[level].load (std::memory_order_acquire);
+    cursor.index = (cursor.end > level_kept[level]) ? cursor.end - level_kept[level] : 0;
+    cursor.header_done = false;
+}
+
+/** @brief   Write as many CSV lines as fit, oldest window first.
+ *  @details Windows finished while the export is under way are left out.
+ *  @param   cursor The cursor from @c rolling_csv_begin()
+ *  @param   out The buffer into which lines are written
+ *  @returns @c true if there is more to write, @c false once the export is done
+ */
+bool rolling_csv_chunk (RollingCsvCursor& cursor, BufferPrint& out)
+{
+    const size_t LINE_MAX = 192;
+    char line[LINE_MAX];
+
+    if (!cursor.header_done)
+    {
+        out << "start_ms,samples";
+        for (uint8_t metric = 0; metric < NUM_METRICS; metric++)
+        {
+            const char* name = metric_names[metric];
+            out << ',' << name << "_mean," << name << "_rms," << name << "_min," << name << "_max";
+        }
+        out << '\n';
+        cursor.header_done = true;
+    }
+
+    RollingWindow window;
+    while (out.room () >= LINE_MAX)
+    {
+        // Skip windows which were overwritten while we were sending
+        uint32_t count = finished[cursor.level].load (std::memory_order_acquire);
+        if (count - cursor.index > level_kept[cursor.level])
+        {
+            cursor.index = count - level_kept[cursor.level];
+        }
+        if (cursor.index >= cursor.end)
+        {
+            return false;
+        }
+        history_slot (cursor.level, cursor.index++).get (window);
+
+        size_t length = snprintf (line, sizeof (line), "%u,%u", (unsigned)window.start_ms,
+                                  (unsigned)window.stats[0].count);
+        for (uint8_t metric = 0; metric < NUM_METRICS; metric++)
+        {
+            const RunningStat& stat = window.stats[metric];
+            length += snprintf (line + length, sizeof (line) - length, ",%.2f,%.2f,%d,%d",
+                                stat.mean (), stat.rms (), (int)stat.min, (int)stat.max);
+        }
+        out << line << '\n';
+    }
+    return true;
+}
@@ -0,0 +1,102 @@
+/** @file rolling_stats.h
+ * This is the header file for the rolling statistics, which keep long-term
+ * trends of the control loop without storing every sample. The count, mean,
+ * RMS, smallest and largest value of each metric are summed over one-second
+ * windows; every ten of those are merged into a ten-second window and every
+ * six of those into a one-minute window. A short history of finished
+ * windows is kept at each level, so about an hour of trends fits in a few
+ * kilobytes, and each control cycle costs a handful of additions.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _ROLLING_STATS_
+#define _ROLLING_STATS_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "buffer_print.h"
+
+/** @brief   The table of metrics.
+ *  @details Each line gives an ID and the name used in reports.
+ */
+#define ROLLING_METRICS(X) \
+    X (METRIC_ERROR,    "error_deg") \
+    X (METRIC_EFFORT,   "effort") \
+    X (METRIC_LATENCY,  "latency_us")
+
+/// Metrics which are summed, as listed in @c ROLLING_METRICS
+enum RollingMetric
+{
+#define ROLLING_METRIC_ID(id, name) id,
+    ROLLING_METRICS (ROLLING_METRIC_ID)
+#undef ROLLING_METRIC_ID
+    NUM_METRICS
+};
+
+/** @brief   The table of window sizes, shortest first.
+ *  @details Each line gives an ID, the name used in reports, the length of
+ *           a window in seconds and the number of finished windows kept. Each
+ *           length must be a whole multiple of the one before.
+ */
+#define ROLLING_LEVELS(X) \
+    X (LEVEL_SECOND,    "1s",    1, 10) \
+    X (LEVEL_10_SECOND, "10s",  10,  6) \
+    X (LEVEL_MINUTE,    "1min", 60, 60)
+
+/// Window sizes, as listed in @c ROLLING_LEVELS
+enum RollingLevel
+{
+#define ROLLING_LEVEL_ID(id, name, seconds, kept) id,
+    ROLLING_LEVELS (ROLLING_LEVEL_ID)
+#undef ROLLING_LEVEL_ID
+    NUM_LEVELS
+};
+
+/** @brief Running sums for one metric over one window
+*/
+struct RunningStat
+{
+    uint32_t count;         ///< Number of values added
+    int32_t min;            ///< Smallest value
+    int32_t max;            ///< Largest value
+    int64_t sum;            ///< Sum of the values, for the mean
+    uint64_t sum_squares;   ///< Sum of the squares of the values, for the RMS
+
+    void clear (void);
+    void add (int32_t value);
+    void merge (const RunningStat& other);
+    float mean (void) const { return count ? (float)sum / count : 0.0f; }
+    float rms (void) const { return count ? sqrtf ((float)sum_squares / count) : 0.0f; }
+};
+
+/** @brief Every metric over one window
+*/
+struct RollingWindow
+{
+    uint32_t start_ms;                  ///< Time the window began, from @c millis()
+    RunningStat stats[NUM_METRICS];     ///< Sums for each metric
+};
+
+/** @brief Position in a CSV export of one level's history
+*/
+struct RollingCsvCursor
+{
+    uint8_t level;          ///< A @c RollingLevel
+    uint32_t index;         ///< Number of the next window to be written
+    uint32_t end;           ///< One past the newest window when the export began
+    bool header_done;       ///< @c true once the column headers have been written
+};
+
+void rolling_stats_add (uint32_t time_us, int32_t error, int32_t effort, int32_t latency_us);
+bool rolling_stats_latest (RollingLevel level, RollingWindow& window);
+bool rolling_stats_level (const char* name, RollingLevel& level);
+void rolling_stats_json (Print& out);
+void rolling_stats_print (Print& out);
+void rolling_csv_begin (RollingCsvCursor& cursor, RollingLevel level);
+bool rolling_csv_chunk (RollingCsvCursor& cursor, BufferPrint& out);
+
+#endif
@@ -0,0 +1,116 @@
+/** @file scope_profiler.cpp
+ * This is the implementation file for the scope profiler. Statistics for
+ * each scope live in a fixed-size static table, so profiling never
+ * allocates memory.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "scope_profiler.h"
+
+/// Statistics kept for one named scope
+struct ScopeStats
+{
+    const char* name;       ///< Name given to the scope
+    uint32_t count;         ///< Times the scope was run
+    uint64_t total;         ///< Total cycles spent in the scope
+    uint32_t min;           ///< Fewest cycles spent in one run
+    uint32_t max;           ///< Most cycles spent in one run
+};
+
+static ScopeStats scopes[MAX_PROFILE_SCOPES];       ///< Statistics for each registered scope
+static std::atomic<uint8_t> num_scopes (0);         ///< Number of entries used in @c scopes
+
+
+/** @brief   Give a scope its entry in the statistics table.
+ *  @details This is called once per @c PROFILE_SCOPE(), the first time it runs.
+ *           If the table is full, the scope is counted in the last entry.
+ *  @param   name The name of the scope; must be a string constant
+ *  @returns The index of the scope's entry
+*/
+uint8_t profiler_register (const char* name)
+{
+    uint8_t id = num_scopes.fetch_add (1);
+    if (id >= MAX_PROFILE_SCOPES)
+    {
+        num_scopes.store (MAX_PROFILE_SCOPES);
+        id = MAX_PROFILE_SCOPES - 1;
+        name = "(overflow)";
+    }
+    scopes[id].name = name;
+    scopes[id].min = UINT32_MAX;
+    return id;
+}
+
+/** @brief   Add one run of a scope to its statistics.
+ *  @param   id The index of the scope from @c profiler_register()
+ *  @param   cycles The number of cycles the run took
+*/
+void profiler_record (uint8_t id, uint32_t cycles)
+{
+    ScopeStats& stats = scopes[id];
+    stats.count++;
+    stats.total += cycles;
+    if (cycles < stats.min)
+    {
+        stats.min = cycles;
+    }
+    if (cycles > stats.max)
+    {
+        stats.max = cycles;
+    }
+}
+
+/** @brief   Clear the statistics of every scope, keeping their names.
+*/
+void profiler_reset (void)
+{
+    uint8_t count = num_scopes.load ();
+    for (uint8_t id = 0; id < count; id++)
+    {
+        scopes[id].count = 0;
+        scopes[id].total = 0;
+        scopes[id].min = UINT32_MAX;
+        scopes[id].max = 0;
+    }
+}
+
+/** @brief   Print the statistics of every scope.
+ *  @details Times are given in cycles and, on the ESP32, in microseconds at the
+ *           current CPU clock.
+ *  @param   out The device to which the report is printed
+*/
+void profiler_print (Print& out)
+{
+#if defined (__XTENSA__)
+    uint32_t cycles_per_us = getCpuFrequencyMhz ();
+#else
+    uint32_t cycles_per_us = 1000;      // Host builds count nanoseconds
+#endif
+
+    uint8_t count = num_scopes.load ();
+    if (count == 0)
+    {
+        out << "No scopes have run" << endl;
+    }
+    for (uint8_t id = 0; id < count; id++)
+    {
+        const ScopeStats& stats = scopes[id];
+        if (stats.name == NULL)
+        {
+            continue;
+        }
+        if (stats.count == 0)
+        {
+            out << stats.name << ": not run" << endl;
+            continue;
+        }
+        uint32_t mean = stats.total / stats.count;
+        out << stats.name << ": n=" << stats.count << " mean=" << mean
+            << " min=" << stats.min << " max=" << stats.max << " cycles ("
+            << mean / cycles_per_us << "us mean, " << stats.max / cycles_per_us << "us max)" << endl;
+    }
+}
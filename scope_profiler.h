@@ -0,0 +1,82 @@
+/** @file scope_profiler.h
+ * This is the header file for the scope profiler, which times named blocks
+ * of code in CPU cycles. Put @c PROFILE_SCOPE("name") at the top of a block;
+ * the time from there to the end of the block is added to that name's count,
+ * total, minimum and maximum.
+ * 
+ * On the ESP32 the cycle counter is the Xtensa CCOUNT register, which costs
+ * one instruction to read. On a host build @c std::chrono is used, counting
+ * nanoseconds. Building with @c -DPROFILER_ENABLED=0 removes every scope.
+ * 
+ * CCOUNT belongs to one core, so a scope must not be used in a task which
+ * can move between cores. Each scope should also only be entered by one task,
+ * as its statistics are updated without locking.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SCOPE_PROFILER_
+#define _SCOPE_PROFILER_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#if !defined (__XTENSA__)
+#include <chrono>
+#endif
+
+const uint8_t MAX_PROFILE_SCOPES = 32;      ///< Most named scopes which can be profiled
+
+/** @brief   Read the free-running cycle counter.
+ *  @returns The number of CPU cycles, or nanoseconds on a host build
+*/
+inline uint32_t profiler_cycles (void)
+{
+#if defined (__XTENSA__)
+    uint32_t ccount;
+    asm volatile ("rsr %0, ccount" : "=a" (ccount));
+    return ccount;
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+#endif
+}
+
+uint8_t profiler_register (const char* name);
+void profiler_record (uint8_t id, uint32_t cycles);
+void profiler_reset (void);
+void profiler_print (Print& out);
+
+/** @brief   Class which times the block of code it is declared in.
+ *  @details Don't use this directly; use the @c PROFILE_SCOPE() macro.
+*/
+class ProfileScope
+{
+    protected:
+        uint8_t id;             ///< Which scope's statistics this time goes to
+        uint32_t start;         ///< Cycle count when the scope was entered
+
+    public:
+        ProfileScope (uint8_t scope_id) : id (scope_id), start (profiler_cycles ()) { }
+        ~ProfileScope (void) { profiler_record (id, profiler_cycles () - start); }
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2 (a, b)
+
+#if PROFILER_ENABLED
+/// Time from here to the end of the enclosing block under the given name
+#define PROFILE_SCOPE(name) \
+    static const uint8_t PROFILE_CONCAT (profile_id_, __LINE__) = profiler_register (name); \
+    ProfileScope PROFILE_CONCAT (profile_scope_, __LINE__) (PROFILE_CONCAT (profile_id_, __LINE__))
+#else
+#define PROFILE_SCOPE(name) do { } while (0)
+#endif
+
+#endif
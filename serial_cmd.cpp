@@ -0,0 +1,116 @@
+/** @file serial_cmd.cpp
+ * This is the implementation file for the serial command interpreter.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "serial_cmd.h"
+#include "task_config.h"
+#include "logger.h"
+
+const uint8_t MAX_COMMANDS = 32;        ///< Most commands which can be registered; main.cpp and @c help use 24
+const uint8_t MAX_LINE = 32;            ///< Longest command line accepted
+
+/// One registered command
+struct SerialCommand
+{
+    const char* name;                   ///< What the user types to run the command
+    SerialCommandHandler handler;       ///< Function which runs the command
+    const char* help;                   ///< One line description printed by @c help
+};
+
+static SerialCommand commands[MAX_COMMANDS];    ///< The registered commands
+static uint8_t num_commands = 0;                ///< Number of entries used in @c commands
+static uint8_t num_refused = 0;                 ///< Number of commands which didn't fit in @c commands
+
+
+/** @brief   Register a command which can be typed into the serial monitor.
+ *  @details Commands should be registered before the command task starts.
+ *           A command which doesn't fit in the table is logged as an error,
+ *           as it can't be typed and @c help won't list it.
+ *  @param   name What the user types to run the command; must be a string constant
+ *  @param   handler Function which runs the command
+ *  @param   help One line description of the command; must be a string constant
+ *  @returns @c true if the command was added, @c false if the table is full
+*/
+bool serial_cmd_register (const char* name, SerialCommandHandler handler, const char* help)
+{
+    if (num_commands >= MAX_COMMANDS)
+    {
+        num_refused++;
+        LOG_ERROR (MOD_MAIN, FMT_CMD_TABLE_FULL, MAX_COMMANDS, num_refused);
+        return false;
+    }
+    commands[num_commands].name = name;
+    commands[num_commands].handler = handler;
+    commands[num_commands].help = help;
+    num_commands++;
+    return true;
+}
+
+/** @brief   Print the list of commands.
+ *  @param   out The device to which the list is printed
+*/
+static void print_help (Print& out)
+{
+    for (uint8_t index = 0; index < num_commands; index++)
+    {
+        out << commands[index].name << " - " << commands[index].help << endl;
+    }
+}
+
+/** @brief   Run the command typed on one line.
+ *  @param   line The line, without its line ending
+*/
+static void run_line (const char* line)
+{
+    if (line[0] == '\0')
+    {
+        return;
+    }
+    for (uint8_t index = 0; index < num_commands; index++)
+    {
+        if (strcmp (line, commands[index].name) == 0)
+        {
+            commands[index].handler (Serial);
+            return;
+        }
+    }
+    Serial << "Unknown command \"" << line << "\". Commands are:" << endl;
+    print_help (Serial);
+}
+
+/** @brief   Task which reads command lines from the serial port and runs them.
+ *  @details This task runs at low priority on the network core, so a command
+ *           which prints a long report never delays the control loop.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_SERIAL_CMD (void* p_params)
+{
+    char line[MAX_LINE];
+    uint8_t length = 0;
+
+    serial_cmd_register ("help", print_help, "list the commands");
+
+    while (true)
+    {
+        task_woke (TASK_CMD);
+        while (Serial.available ())
+        {
+            char ch = Serial.read ();
+            if (ch == '\r' || ch == '\n')
+            {
+                line[length] = '\0';
+                run_line (line);
+                length = 0;
+            }
+            else if (length < MAX_LINE - 1)
+            {
+                line[length++] = ch;
+            }
+        }
+        vTaskDelay (50);
+    }
+}
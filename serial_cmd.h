@@ -0,0 +1,23 @@
+/** @file serial_cmd.h
+ * This is the header file for the serial command interpreter. Other parts of
+ * the program register commands by name; typing a command's name into the
+ * serial monitor runs it and prints its report.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SERIAL_CMD_
+#define _SERIAL_CMD_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+/// A command's handler prints its report to the given device
+typedef void (*SerialCommandHandler) (Print& out);
+
+bool serial_cmd_register (const char* name, SerialCommandHandler handler, const char* help);
+void task_SERIAL_CMD (void* p_params);
+
+#endif
@@ -0,0 +1,168 @@
+/** @file base_motion.cpp
+ * This is the implementation file for the motion of the gimbal's base.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <PrintStream.h>
+#include "base_motion.h"
+
+/// Name, default amplitude, default frequency and description of each profile
+static const struct
+{
+    const char* name;
+    double amplitude;
+    double frequency;
+    const char* text;
+} profiles[NUM_PROFILES] =
+{
+#define BASE_PROFILE_ENTRY(id, name, amplitude, frequency, text) { name, amplitude, frequency, text },
+    BASE_PROFILES (BASE_PROFILE_ENTRY)
+#undef BASE_PROFILE_ENTRY
+};
+
+const double WALK_BOB = 1.5;                ///< Peak vertical acceleration of a walking step in m/s^2
+const double WALK_SURGE = 0.8;              ///< Peak forward acceleration of a walking step in m/s^2
+
+
+/** @brief   Start the base at rest at the beginning of a profile.
+ *  @param   base_profile Which profile to follow
+ *  @param   amplitude_deg Size of the motion in degrees
+ *  @param   frequency_hz Frequency of the motion in Hz
+ *  @param   seed Seed for the random parts of the motion
+*/
+BaseMotion :: BaseMotion (BaseProfile base_profile, double amplitude_deg, double frequency_hz, uint64_t seed)
+    : profile (base_profile), amplitude (amplitude_deg * M_PI / 180.0), frequency (frequency_hz),
+      time (0.0), random (seed)
+{
+    for (uint8_t index = 0; index < 3; index++)
+    {
+        phase[index] = 2.0 * M_PI * random.uniform ();
+        shake[index] = 0.0;
+    }
+    update (0.0);
+}
+
+/** @brief   Work out the base's motion at the current time.
+ *  @param   dt Time since the last update, for the profiles which are filtered
+*/
+void BaseMotion :: update (double dt)
+{
+    double w = 2.0 * M_PI * frequency;
+    memset (&state, 0, sizeof (state));
+
+    switch (profile)
+    {
+        case PROFILE_TILT:
+        {
+            // A raised cosine, so the rate and acceleration stay finite
+            double duration = frequency > 0.0 ? 1.0 / frequency : 0.0;
+            double x = duration > 0.0 ? (time - 1.0) / duration : (time >= 1.0 ? 1.0 : 0.0);
+            if (x >= 1.0)
+            {
+                state.pitch = amplitude;
+            }
+            else if (x > 0.0)
+            {
+                state.pitch = amplitude * (1.0 - cos (M_PI * x)) / 2.0;
+                state.pitch_rate = amplitude * M_PI * sin (M_PI * x) / (2.0 * duration);
+                state.pitch_acc = amplitude * M_PI * M_PI * cos (M_PI * x) / (2.0 * duration * duration);
+            }
+            break;
+        }
+
+        case PROFILE_SINE:
+            state.pitch = amplitude * sin (w * time);
+            state.pitch_rate = amplitude * w * cos (w * time);
+            state.pitch_acc = -amplitude * w * w * sin (w * time);
+            break;
+
+        case PROFILE_WALK:
+        {
+            // Sway at half the step rate, a nod at each step, and the body
+            // bobbing and surging with each step
+            double sway = w / 2.0;
+            state.pitch = amplitude * (0.7 * sin (sway * time + phase[0]) + 0.3 * sin (w * time + phase[1]));
+            state.pitch_rate = amplitude * (0.7 * sway * cos (sway * time + phase[0])
+                                            + 0.3 * w * cos (w * time + phase[1]));
+            state.pitch_acc = -amplitude * (0.7 * sway * sway * sin (sway * time + phase[0])
+                                            + 0.3 * w * w * sin (w * time + phase[1]));
+            state.roll = 0.5 * amplitude * sin (sway * time + phase[2]);
+            state.roll_rate = 0.5 * amplitude * sway * cos (sway * time + phase[2]);
+            state.acc_up = WALK_BOB * sin (w * time + phase[1]);
+            state.acc_forward = WALK_SURGE * sin (w * time + phase[1] + 1.0);
+            break;
+        }
+
+        case PROFILE_SHAKE:
+            // White noise through a critically damped second-order filter;
+            // the noise is scaled so the angle's RMS is the amplitude
+            if (dt > 0.0 && w > 0.0)
+            {
+                double drive = amplitude * sqrt (4.0 / (w * dt)) * random.gaussian ();
+                shake[2] = w * w * (drive - shake[0]) - 2.0 * w * shake[1];
+                shake[1] += shake[2] * dt;
+                shake[0] += shake[1] * dt;
+            }
+            state.pitch = shake[0];
+            state.pitch_rate = shake[1];
+            state.pitch_acc = shake[2];
+            break;
+
+        default:
+            break;
+    }
+}
+
+/** @brief   Look up a profile by the name used on the command line.
+ *  @param   name The profile's name
+ *  @param   profile Where the profile is put
+ *  @returns @c true if there is a profile of that name
+*/
+bool base_profile_find (const char* name, BaseProfile& profile)
+{
+    for (uint8_t index = 0; index < NUM_PROFILES; index++)
+    {
+        if (strcmp (name, profiles[index].name) == 0)
+        {
+            profile = (BaseProfile)index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief   Return the name of a profile.
+*/
+const char* base_profile_name (BaseProfile profile)
+{
+    return profiles[profile].name;
+}
+
+/** @brief   Return a profile's default amplitude in degrees.
+*/
+double base_profile_amplitude (BaseProfile profile)
+{
+    return profiles[profile].amplitude;
+}
+
+/** @brief   Return a profile's default frequency in Hz.
+*/
+double base_profile_frequency (BaseProfile profile)
+{
+    return profiles[profile].frequency;
+}
+
+/** @brief   Print the profiles with their defaults, for the help text.
+ *  @param   out The device to which the list is printed
+*/
+void base_profile_list (Print& out)
+{
+    for (uint8_t index = 0; index < NUM_PROFILES; index++)
+    {
+        out << "  " << profiles[index].name << ": " << profiles[index].text << " (" << profiles[index].amplitude
+            << " deg, " << profiles[index].frequency << " Hz)" << endl;
+    }
+}
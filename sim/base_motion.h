@@ -0,0 +1,83 @@
+/** @file base_motion.h
+ * This is the header file for the motion of the gimbal's base, the handle or
+ * vehicle the gimbal is mounted on, which the simulator shakes the gimbal
+ * with. Each profile gives the base's pitch and roll with their rates and
+ * accelerations, and the base's linear acceleration, which the accelerometer
+ * feels along with gravity.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _BASE_MOTION_
+#define _BASE_MOTION_
+
+#include <Arduino.h>
+#include "sim_random.h"
+
+/** @brief   The table of base motion profiles.
+ *  @details Each line gives an ID, the name used on the command line, the
+ *           default amplitude in degrees, the default frequency in Hz and a
+ *           description.
+ */
+#define BASE_PROFILES(X) \
+    X (PROFILE_STILL, "still",  0.0, 0.0, "base held level") \
+    X (PROFILE_TILT,  "tilt",  20.0, 2.0, "base tilts by the amplitude at 1 s, taking 1/freq seconds, and stays") \
+    X (PROFILE_SINE,  "sine",  10.0, 1.0, "base pitch swings sinusoidally") \
+    X (PROFILE_WALK,  "walk",   5.0, 1.8, "handheld while walking at freq steps per second: sway, bob and jolts") \
+    X (PROFILE_SHAKE, "shake",  3.0, 5.0, "random shake of the given RMS, low-passed at freq")
+
+/// Base motion profiles, as listed in @c BASE_PROFILES
+enum BaseProfile
+{
+#define BASE_PROFILE_ID(id, name, amplitude, frequency, text) id,
+    BASE_PROFILES (BASE_PROFILE_ID)
+#undef BASE_PROFILE_ID
+    NUM_PROFILES
+};
+
+/** @brief Motion of the base at one instant
+*/
+struct BaseState
+{
+    double pitch;           ///< Pitch in radians
+    double pitch_rate;      ///< Pitch rate in rad/s
+    double pitch_acc;       ///< Pitch acceleration in rad/s^2
+    double roll;            ///< Roll in radians
+    double roll_rate;       ///< Roll rate in rad/s
+    double acc_forward;     ///< Horizontal acceleration in the pitch plane in m/s^2
+    double acc_up;          ///< Vertical acceleration in m/s^2
+};
+
+/** @brief   Class which moves the base along a profile.
+ *  @details The motion only depends on the profile, its settings, the seed
+ *           and the time step, so runs with the same settings repeat exactly.
+*/
+class BaseMotion
+{
+    protected:
+        BaseProfile profile;    ///< Which profile is followed
+        double amplitude;       ///< Size of the motion in radians
+        double frequency;       ///< Frequency of the motion in Hz
+        double time;            ///< Time since the profile started in seconds
+        double phase[3];        ///< Random phases of the walking components
+        double shake[3];        ///< Angle, rate and acceleration of the shake filter
+        SimRandom random;       ///< Source of the random parts of the motion
+        BaseState state;        ///< Motion at @c time
+
+        void update (double dt);
+
+    public:
+        BaseMotion (BaseProfile base_profile, double amplitude_deg, double frequency_hz, uint64_t seed);
+        void step (double dt) { time += dt; update (dt); }
+        const BaseState& get (void) const { return state; }
+};
+
+bool base_profile_find (const char* name, BaseProfile& profile);
+const char* base_profile_name (BaseProfile profile);
+double base_profile_amplitude (BaseProfile profile);
+double base_profile_frequency (BaseProfile profile);
+void base_profile_list (Print& out);
+
+#endif
@@ -0,0 +1,120 @@
+/** @file gimbal_model.cpp
+ * This is the implementation file for the rigid-body model of the gimbal's
+ * pitch axis.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "gimbal_model.h"
+#include "sim_hal.h"
+
+const double STICK_RATE = 1.0e-4;           ///< Joint rates below this in rad/s may stick
+
+
+/** @brief   Set up the model at rest, level with the base.
+ *  @param   parameters The plant parameters
+ *  @param   pin_1 Pin driving channel 1 of the motor driver
+ *  @param   pin_2 Pin driving channel 2 of the motor driver
+*/
+GimbalModel :: GimbalModel (const PlantParams& parameters, uint8_t pin_1, uint8_t pin_2)
+    : plant (parameters), in1_pin (pin_1), in2_pin (pin_2), joint (0.0), joint_rate (0.0),
+      stuck (true), current (0.0), peak_current (0.0), energy (0.0)
+{
+}
+
+/** @brief   Move the model on by one time step.
+ *  @details The motor current is averaged over the PWM period, which is far
+ *           shorter than any time step that makes sense here. Integration is
+ *           semi-implicit Euler; the joint sticks when its rate passes
+ *           through zero and friction can hold it.
+ *  @param   dt Length of the step in seconds
+ *  @param   base Motion of the base during the step
+*/
+void GimbalModel :: step (double dt, const BaseState& base)
+{
+    double duty_1 = sim_pin_duty (in1_pin);
+    double duty_2 = sim_pin_duty (in2_pin);
+    double drive = fabs (duty_1 - duty_2);                  // Fraction of the time spent driving
+    double braking = duty_1 < duty_2 ? duty_1 : duty_2;     // Fraction spent with both pins high
+    double voltage = duty_1 >= duty_2 ? plant.supply : -plant.supply;
+
+    double motor_rate = plant.direction * plant.gear_ratio * joint_rate;
+    double back_emf = plant.kt * motor_rate;
+    double drive_current = (voltage - back_emf) / plant.resistance;
+    current = drive * drive_current - braking * back_emf / plant.resistance;
+    peak_current = fabs (current) > peak_current ? fabs (current) : peak_current;
+    energy += drive * voltage * drive_current * dt;
+
+    double pitch = base.pitch + joint;
+    double torque = plant.direction * plant.gear_ratio * plant.kt * current - plant.imbalance * sin (pitch);
+    double reflected = plant.rotor_inertia * plant.gear_ratio * plant.gear_ratio;
+
+    // Friction torque which would keep the payload turning with the base
+    double hold = plant.inertia * base.pitch_acc - torque;
+    if (stuck && fabs (hold) <= plant.stiction)
+    {
+        joint_rate = 0.0;
+        return;
+    }
+
+    double sliding = joint_rate;
+    if (stuck)
+    {
+        // Breaking free: friction opposes the way the joint is being pushed
+        sliding = -hold;
+        stuck = false;
+    }
+    double friction = -plant.viscous * joint_rate;
+    friction += sliding > 0.0 ? -plant.coulomb : (sliding < 0.0 ? plant.coulomb : 0.0);
+
+    double joint_acc = (torque + friction - plant.inertia * base.pitch_acc) / (plant.inertia + reflected);
+    double new_rate = joint_rate + joint_acc * dt;
+    if ((new_rate * joint_rate < 0.0 || fabs (new_rate) < STICK_RATE) && fabs (hold) <= plant.stiction)
+    {
+        new_rate = 0.0;
+        stuck = true;
+    }
+    joint_rate = new_rate;
+    joint += joint_rate * dt;
+}
+
+/** @brief   Fill in the default plant parameters.
+ *  @param   plant The parameters to be filled in
+*/
+void plant_defaults (PlantParams& plant)
+{
+#define PLANT_DEFAULT(name, initial, units, text) plant.name = initial;
+    PLANT_FIELDS (PLANT_DEFAULT)
+#undef PLANT_DEFAULT
+}
+
+/** @brief   Set one plant parameter by name.
+ *  @param   plant The parameters to be changed
+ *  @param   name Name of the parameter, as in @c PLANT_FIELDS
+ *  @param   value The new value
+ *  @returns @c true if there is a parameter of that name
+*/
+bool plant_set (PlantParams& plant, const char* name, double value)
+{
+#define PLANT_SET(field, initial, units, text) \
+    if (strcmp (name, #field) == 0) { plant.field = value; return true; }
+    PLANT_FIELDS (PLANT_SET)
+#undef PLANT_SET
+    return false;
+}
+
+/** @brief   Print every plant parameter with its value and description.
+ *  @param   plant The parameters to be printed
+ *  @param   out The device to which they are printed
+*/
+void plant_print (const PlantParams& plant, Print& out)
+{
+    char value[24];
+#define PLANT_PRINT(name, initial, units, text) \
+    snprintf (value, sizeof (value), "%g", plant.name); \
+    out << "  --" << #name << " " << value << (units[0] ? " " : "") << units << ": " << text << endl;
+    PLANT_FIELDS (PLANT_PRINT)
+#undef PLANT_PRINT
+}
@@ -0,0 +1,85 @@
+/** @file gimbal_model.h
+ * This is the header file for the rigid-body model of the gimbal's pitch
+ * axis. The payload turns on a joint in the base; the joint is driven by a
+ * geared DC motor through an H-bridge and held back by friction, which
+ * sticks the payload to the base until the torque on it is big enough to
+ * break it free. The motor model reads the duty cycles on the driver's two
+ * input pins, so it is driven by the real @c Motor class.
+ * 
+ * The H-bridge is taken to switch between drive and brake in slow decay, as
+ * the firmware's drive and brake commands do: a pin driven at duty @c d with
+ * the other low drives for @c d of the time and coasts otherwise, and both
+ * pins high short the motor, which then brakes on its own back-EMF.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _GIMBAL_MODEL_
+#define _GIMBAL_MODEL_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#include "base_motion.h"
+
+/** @brief   The table of plant parameters.
+ *  @details Each line gives the name, which is also the command line
+ *           option, the default value, the units and a description.
+ */
+#define PLANT_FIELDS(X) \
+    X (inertia,       2.0e-4, "kg m^2", "Payload inertia about the pitch axis") \
+    X (rotor_inertia, 5.0e-7, "kg m^2", "Motor rotor inertia, before the gearbox") \
+    X (gear_ratio,    30.0,   "",       "Motor turns per turn of the pitch axis") \
+    X (kt,            0.005,  "N m/A",  "Motor torque constant, also its back-EMF constant in V s/rad") \
+    X (resistance,    3.0,    "ohm",    "Motor winding resistance") \
+    X (supply,        7.4,    "V",      "H-bridge supply voltage") \
+    X (coulomb,       0.01,   "N m",    "Friction torque at the axis while it slides") \
+    X (stiction,      0.015,  "N m",    "Friction torque which must be overcome to start the axis sliding") \
+    X (viscous,       1.0e-4, "N m s",  "Viscous friction at the axis, per rad/s") \
+    X (imbalance,     0.005,  "N m",    "Gravity torque on the payload at 90 deg; positive pulls it back to level") \
+    X (direction,     -1.0,   "",       "Sign of the payload's turn when channel 1 drives; -1 tilts it nose down")
+
+/** @brief Every plant parameter, as listed in @c PLANT_FIELDS
+*/
+struct PlantParams
+{
+#define PLANT_MEMBER(name, initial, units, text) double name;
+    PLANT_FIELDS (PLANT_MEMBER)
+#undef PLANT_MEMBER
+};
+
+/** @brief   Class which integrates the motion of the pitch axis.
+ *  @details The state is the joint angle, the payload's pitch relative to
+ *           the base, so a joint stuck by friction simply stops changing.
+*/
+class GimbalModel
+{
+    protected:
+        PlantParams plant;      ///< The parameters
+        uint8_t in1_pin;        ///< Pin driving channel 1 of the motor driver
+        uint8_t in2_pin;        ///< Pin driving channel 2 of the motor driver
+        double joint;           ///< Payload pitch relative to the base in radians
+        double joint_rate;      ///< Rate of @c joint in rad/s
+        bool stuck;             ///< @c true while friction holds the joint still
+        double current;         ///< Average motor current over the last step in A
+        double peak_current;    ///< Largest magnitude of @c current
+        double energy;          ///< Energy drawn from the supply in J
+
+    public:
+        GimbalModel (const PlantParams& parameters, uint8_t pin_1, uint8_t pin_2);
+        void set_joint (double angle_deg) { joint = angle_deg * M_PI / 180.0; joint_rate = 0.0; stuck = true; }
+        void step (double dt, const BaseState& base);
+        double pitch_deg (const BaseState& base) const { return (base.pitch + joint) * 180.0 / M_PI; }
+        double pitch_rate_dps (const BaseState& base) const { return (base.pitch_rate + joint_rate) * 180.0 / M_PI; }
+        bool is_stuck (void) const { return stuck; }
+        double get_current (void) const { return current; }
+        double get_peak_current (void) const { return peak_current; }
+        double get_energy (void) const { return energy; }
+};
+
+void plant_defaults (PlantParams& plant);
+bool plant_set (PlantParams& plant, const char* name, double value);
+void plant_print (const PlantParams& plant, Print& out);
+
+#endif
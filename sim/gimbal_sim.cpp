@@ -0,0 +1,547 @@
+/** @file gimbal_sim.cpp
+ * This file runs the gimbal's pitch control loop in closed loop against a
+ * simulated gimbal, on a PC. The firmware's own @c IMU, @c Motor,
+ * @c AngleFuser, @c PitchLoop, settings and @c StabilityMetrics code is
+ * built in unchanged; the simulated MPU-6050 answers the IMU's I2C reads,
+ * the LEDC channels which @c Motor writes drive the motor model, and the
+ * rigid-body model of the pitch axis is shaken by a base motion profile.
+ * 
+ * Each control cycle does what the acquisition, fuse and pitch tasks in
+ * main.cpp do in turn, calling the same per-cycle steps from pitch_loop.h:
+ * a burst read, the angle computation and smoothing, then the controller
+ * with its mode and calibration gating and the motor command, which reaches
+ * the motor @c --latency_us after the sample was taken. Between samples the
+ * model is integrated in steps of @c --dt_us. Nothing waits for real time, and all
+ * noise and random motion come from @c --seed, so a run takes milliseconds
+ * and repeats exactly.
+ * 
+ * Each stage is traced under the task which runs it in the firmware, and
+ * @c --trace writes the trace ring, which holds the last cycles of the run,
+ * as Chrome trace-event JSON for Perfetto. Times are simulated ones, so a
+ * stage takes no time and the gap from acquire to control is the latency.
+ * 
+ * Settings are given as the same JSON object that PUT @c /api/v1/config
+ * takes, and checked by the same code. The result is a summary of how well
+ * the payload was held, by its true angle and as the firmware measures it;
+ * tools/sim_sweep.py runs many settings in parallel and ranks them.
+ * 
+ * Usage:
+ *     gimbal_sim --profile walk --config '{"kp":20,"accept":2}'
+ *     gimbal_sim --profile shake --amplitude 5 --duration 60 --seed 7 --json
+ *     gimbal_sim --step 10 --step_period 3 --csv step.csv
+ *     gimbal_sim --profile sine --duration 2 --trace sim_trace.json
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <chrono>
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "IMU.h"
+#include "motor_obj.h"
+#include "controller.h"
+#include "pitch_loop.h"
+#include "gimbal_config.h"
+#include "stab_metrics.h"
+#include "task_config.h"
+#include "trace_recorder.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "sim_hal.h"
+#include "mpu6050_sim.h"
+#include "base_motion.h"
+#include "gimbal_model.h"
+
+// Hardware settings, as in main.cpp
+const uint16_t MPU_ADDR = 0x68;         ///< I2C address of the MPU-6050
+const uint16_t I2C_SDA = 23;            ///< I2C data pin
+const uint16_t I2C_SCL = 22;            ///< I2C clock pin
+const uint16_t PWR_MGMT_1 = 0x6B;       ///< MPU-6050 power management register address
+const uint8_t m1_in1_pin = 21;          ///< Input pin 1 for motor 1
+const uint8_t m1_in2_pin = 13;          ///< Input pin 2 for motor 1
+const uint8_t m2_in1_pin = 12;          ///< Input pin 1 for motor 2
+const uint8_t m2_in2_pin = 27;          ///< Input pin 2 for motor 2
+const uint8_t m3_in1_pin = 33;          ///< Input pin 1 for motor 3
+const uint8_t m3_in2_pin = 15;          ///< Input pin 2 for motor 3
+const uint32_t m1_freq = 16000;         ///< PWM Frequency for Motor 1
+const uint32_t m2_freq = 16000;         ///< PWM Frequency for Motor 2
+const uint32_t m3_freq = 1000;          ///< PWM Frequency for Motor 3
+const uint8_t pwm_resolution = 8;       ///< Resolution of pwm frequency value
+
+/** @brief   The table of run options.
+ *  @details Each line gives the name, which is also the command line option,
+ *           the default value and a description. A default of @c NAN means
+ *           the profile's own default is used.
+ */
+#define SIM_OPTIONS(X) \
+    X (duration,    30.0,  "Seconds of simulated time") \
+    X (seed,         1.0,  "Seed for the sensor noise and random base motion") \
+    X (amplitude,    NAN,  "Size of the base motion in degrees") \
+    X (frequency,    NAN,  "Frequency of the base motion in Hz") \
+    X (step,         0.0,  "Remote setpoint steps of this many degrees from home, 0 for none") \
+    X (step_period,  4.0,  "Seconds between setpoint steps") \
+    X (start,        0.0,  "Payload pitch in degrees relative to the base after calibration") \
+    X (dt_us,      100.0,  "Model time step in microseconds") \
+    X (latency_us, 800.0,  "Time from a sample to its motor command in microseconds") \
+    X (acc_noise,  0.004,  "Accelerometer noise in g RMS") \
+    X (gyro_noise,  0.05,  "Gyroscope noise in deg/s RMS") \
+    X (gyro_bias,    1.0,  "Gyroscope bias in deg/s on each axis") \
+    X (log,          2.0,  "Print log messages up to this level: 1 error to 5 trace")
+
+/** @brief Every run option, as listed in @c SIM_OPTIONS
+*/
+struct SimOptions
+{
+#define SIM_MEMBER(name, initial, text) double name;
+    SIM_OPTIONS (SIM_MEMBER)
+#undef SIM_MEMBER
+    BaseProfile profile;    ///< Base motion profile
+    const char* config;     ///< Settings as a JSON object, or @c NULL
+    const char* csv;        ///< File for the per-cycle trace, or @c NULL
+    const char* trace;      ///< File for the Chrome trace of the last cycles, or @c NULL
+    bool json;              ///< @c true to print the summary as JSON
+};
+
+/** @brief Sums kept while the run goes, for the summary
+*/
+struct RunTotals
+{
+    double time;            ///< Time integrated in seconds
+    double error_sq;        ///< Integral of the squared true error
+    double error_max;       ///< Largest true error in degrees
+    double rate_sq;         ///< Integral of the squared payload rate
+    double base_sq;         ///< Integral of the squared base pitch
+    uint32_t cycles;        ///< Control cycles run
+    uint32_t failed_reads;  ///< Samples the IMU couldn't read
+    uint32_t braked;        ///< Cycles in which the motor was braked
+    uint32_t reversals;     ///< Times the drive switched straight between channels
+    uint64_t effort_sum;    ///< Sum of the magnitude of the effort
+};
+
+/** @brief   Class which prints to standard output, for the firmware's reports.
+*/
+class StdoutPrint : public Print
+{
+    public:
+        size_t write (uint8_t ch) override { return fputc (ch, stdout) == EOF ? 0 : 1; }
+        size_t write (const uint8_t* data, size_t length) override { return fwrite (data, 1, length, stdout); }
+};
+
+static StdoutPrint console;             ///< Standard output
+static IMU mpu;                         ///< IMU Object
+static Motor pitch_motor;               ///< Pitch motor object
+static Motor roll_motor;                ///< Roll motor object
+static Motor yaw_motor;                 ///< Yaw motor object
+static StabilityMetrics pitch_quality;  ///< Stabilization quality as the firmware measures it
+static int16_t remote_pitch = 0;        ///< Setpoint step standing in for a remote setpoint
+static bool remote_valid = false;       ///< @c true while the setpoint step is in effect
+
+
+/** @brief   Give the setpoint step as if it were a fresh remote setpoint.
+ *  @details This stands in for @c udp_pitch_setpoint() in the firmware.
+ *  @param   setpoint Where the setpoint is put if the step is in effect
+ *  @returns @c true if the step is in effect
+*/
+static bool remote_setpoint (int16_t& setpoint)
+{
+    if (remote_valid)
+    {
+        setpoint = remote_pitch;
+    }
+    return remote_valid;
+}
+
+/** @brief   Print the usage, options and their defaults.
+*/
+static void print_usage (void)
+{
+    PlantParams plant;
+    plant_defaults (plant);
+
+    console << "Usage: gimbal_sim [--option value]... [--json] [--help]" << endl;
+    console << "  --profile NAME: base motion profile, one of:" << endl;
+    base_profile_list (console);
+    console << "  --config JSON: settings, as the object PUT to /api/v1/config" << endl;
+    console << "  --csv FILE: write every control cycle to a CSV file" << endl;
+    console << "  --trace FILE: write the trace of the last cycles as Chrome trace JSON" << endl;
+    console << "  --json: print the summary as one JSON object" << endl;
+    char value[24];
+#define SIM_USAGE(name, initial, text) \
+    snprintf (value, sizeof (value), "%g", initial); \
+    console << "  --" << #name << " " << value << ": " << text << endl;
+    SIM_OPTIONS (SIM_USAGE)
+#undef SIM_USAGE
+    console << "Plant:" << endl;
+    plant_print (plant, console);
+}
+
+/** @brief   Read the command line.
+ *  @param   argc Number of arguments
+ *  @param   argv The arguments
+ *  @param   options Where the run options are put
+ *  @param   plant Where the plant parameters are put
+ *  @returns @c true if the run should go ahead
+*/
+static bool parse_arguments (int argc, char** argv, SimOptions& options, PlantParams& plant)
+{
+#define SIM_DEFAULT(name, initial, text) options.name = initial;
+    SIM_OPTIONS (SIM_DEFAULT)
+#undef SIM_DEFAULT
+    options.profile = PROFILE_STILL;
+    options.config = NULL;
+    options.csv = NULL;
+    options.trace = NULL;
+    options.json = false;
+    plant_defaults (plant);
+
+    for (int index = 1; index < argc; index++)
+    {
+        const char* name = argv[index];
+        if (strncmp (name, "--", 2) != 0)
+        {
+            fprintf (stderr, "Unexpected argument %s; try --help\n", name);
+            return false;
+        }
+        name += 2;
+        if (strcmp (name, "help") == 0)
+        {
+            print_usage ();
+            return false;
+        }
+        if (strcmp (name, "json") == 0)
+        {
+            options.json = true;
+            continue;
+        }
+        if (index + 1 >= argc)
+        {
+            fprintf (stderr, "--%s needs a value\n", name);
+            return false;
+        }
+        const char* text = argv[++index];
+
+        if (strcmp (name, "profile") == 0)
+        {
+            if (!base_profile_find (text, options.profile))
+            {
+                fprintf (stderr, "Unknown profile %s; try --help\n", text);
+                return false;
+            }
+            continue;
+        }
+        if (strcmp (name, "config") == 0)
+        {
+            options.config = text;
+            continue;
+        }
+        if (strcmp (name, "csv") == 0)
+        {
+            options.csv = text;
+            continue;
+        }
+        if (strcmp (name, "trace") == 0)
+        {
+            options.trace = text;
+            continue;
+        }
+
+        char* end;
+        double value = strtod (text, &end);
+        if (end == text || *end != '\0')
+        {
+            fprintf (stderr, "--%s needs a number, not %s\n", name, text);
+            return false;
+        }
+        bool known = plant_set (plant, name, value);
+#define SIM_SET(field, initial, description) \
+        if (strcmp (name, #field) == 0) { options.field = value; known = true; }
+        SIM_OPTIONS (SIM_SET)
+#undef SIM_SET
+        if (!known)
+        {
+            fprintf (stderr, "Unknown option --%s; try --help\n", name);
+            return false;
+        }
+    }
+
+    if (isnan (options.amplitude))
+    {
+        options.amplitude = base_profile_amplitude (options.profile);
+    }
+    if (isnan (options.frequency))
+    {
+        options.frequency = base_profile_frequency (options.profile);
+    }
+    if (options.duration <= 0 || options.dt_us < 1 || options.latency_us < 0
+        || options.latency_us >= IMU_PERIOD * portTICK_PERIOD_MS * 1000.0 || plant.inertia <= 0)
+    {
+        fprintf (stderr, "Duration, time step and inertia must be positive, and the latency within a cycle\n");
+        return false;
+    }
+    return true;
+}
+
+/** @brief   Move the base and the model on by some time, adding to the totals.
+ *  @param   model The gimbal model
+ *  @param   base The base motion
+ *  @param   options The run options
+ *  @param   setpoint Angle the payload should be at, in degrees
+ *  @param   now_us Simulated time, moved on by @c span_us
+ *  @param   span_us Time to move on by in microseconds
+ *  @param   totals The sums for the summary
+*/
+static void advance (GimbalModel& model, BaseMotion& base, const SimOptions& options, int16_t setpoint,
+                     uint64_t& now_us, uint32_t span_us, RunTotals& totals)
+{
+    while (span_us > 0)
+    {
+        uint32_t step_us = span_us < options.dt_us ? span_us : (uint32_t)options.dt_us;
+        double dt = step_us * 1e-6;
+        model.step (dt, base.get ());
+        base.step (dt);
+        now_us += step_us;
+        span_us -= step_us;
+
+        double error = fabs (model.pitch_deg (base.get ()) - setpoint);
+        double rate = model.pitch_rate_dps (base.get ());
+        double base_deg = base.get ().pitch * 180.0 / M_PI;
+        totals.time += dt;
+        totals.error_sq += error * error * dt;
+        totals.error_max = error > totals.error_max ? error : totals.error_max;
+        totals.rate_sq += rate * rate * dt;
+        totals.base_sq += base_deg * base_deg * dt;
+    }
+    sim_set_time_us (now_us);
+}
+
+/** @brief   Give the sensor the payload's true motion at this instant.
+*/
+static void sense (const GimbalModel& model, const BaseMotion& base, Mpu6050Sim& sensor)
+{
+    const BaseState& state = base.get ();
+    SensorMotion motion;
+    motion.pitch_deg = model.pitch_deg (state);
+    motion.roll_deg = state.roll * 180.0 / M_PI;
+    motion.rate_dps[0] = state.roll_rate * 180.0 / M_PI;
+    motion.rate_dps[1] = model.pitch_rate_dps (state);
+    motion.rate_dps[2] = 0.0;
+    motion.acc_forward = state.acc_forward;
+    motion.acc_up = state.acc_up;
+    sensor.set_motion (motion);
+}
+
+/** @brief   Print the summary of a run.
+ *  @param   options The run options
+ *  @param   totals The sums kept during the run
+ *  @param   model The gimbal model, for its motor totals
+ *  @param   wall_s Real time the run took in seconds
+*/
+static void print_summary (const SimOptions& options, const RunTotals& totals, const GimbalModel& model, double wall_s)
+{
+    QualitySnapshot quality;
+    pitch_quality.get (quality);
+    double error_rms = sqrt (totals.error_sq / totals.time);
+    double rate_rms = sqrt (totals.rate_sq / totals.time);
+    double base_rms = sqrt (totals.base_sq / totals.time);
+    double mean_effort = totals.cycles ? (double)totals.effort_sum / totals.cycles : 0.0;
+    double seconds = totals.time > 0 ? totals.time : 1.0;
+
+    if (options.json)
+    {
+        JsonWriter json (console);
+        json.begin_object ();
+        json.value ("profile", base_profile_name (options.profile));
+        json.value ("seed", (unsigned long)options.seed);
+        json.value ("seconds", (float)totals.time);
+        json.value ("error_rms", (float)error_rms, 4);
+        json.value ("error_max", (float)totals.error_max, 3);
+        json.value ("rate_rms", (float)rate_rms, 3);
+        json.value ("base_rms", (float)base_rms, 3);
+        json.value ("measured_rms", quality.rms_long, 3);
+        json.value ("steps", quality.steps);
+        json.value ("steps_settled", quality.steps_settled);
+        json.value ("mean_rise_ms", quality.mean_rise_ms);
+        json.value ("mean_settle_ms", quality.mean_settle_ms);
+        json.value ("max_overshoot_pct", (unsigned int)quality.max_overshoot_pct);
+        json.value ("saturated_cycles", quality.saturated_cycles);
+        json.value ("mean_effort", (float)mean_effort, 2);
+        json.value ("braked_pct", (float)(100.0 * totals.braked / (totals.cycles ? totals.cycles : 1)), 2);
+        json.value ("reversals_per_s", (float)(totals.reversals / seconds), 3);
+        json.value ("peak_current", (float)model.get_peak_current (), 3);
+        json.value ("energy_j", (float)model.get_energy (), 3);
+        json.value ("failed_reads", totals.failed_reads);
+        json.end_object ();
+        console << endl;
+        return;
+    }
+
+    console << "Profile " << base_profile_name (options.profile) << ", " << options.amplitude << " deg at "
+            << options.frequency << " Hz, seed " << (unsigned long)options.seed << ": " << totals.time
+            << " s in " << wall_s * 1000.0 << " ms, " << totals.time / (wall_s > 0 ? wall_s : 1e-9)
+            << " times real time" << endl;
+    gimbal_config_print (console);
+    console << "True error: " << error_rms << " deg RMS, " << totals.error_max << " deg largest; payload rate "
+            << rate_rms << " deg/s RMS; base " << base_rms << " deg RMS" << endl;
+    console << "Motor: mean effort " << mean_effort << ", braked " << 100.0 * totals.braked / (totals.cycles ? totals.cycles : 1)
+            << " % of cycles, " << totals.reversals / seconds << " reversals/s, peak " << model.get_peak_current ()
+            << " A, " << model.get_energy () << " J" << endl;
+    console << "As measured by the firmware:" << endl;
+    pitch_quality.print (console);
+    if (totals.failed_reads > 0)
+    {
+        console << totals.failed_reads << " IMU reads failed" << endl;
+    }
+}
+
+int main (int argc, char** argv)
+{
+    SimOptions options;
+    PlantParams plant;
+    if (!parse_arguments (argc, argv, options, plant))
+    {
+        return 2;
+    }
+    sim_log_level ((LogLevel)options.log);
+
+    if (options.config)
+    {
+        JsonReader reader (options.config, strlen (options.config));
+        const char* problem = gimbal_config_apply (reader);
+        if (problem)
+        {
+            fprintf (stderr, "--config: %s\n", problem);
+            return 2;
+        }
+    }
+    gimbal_set_mode (MODE_STABILIZE);
+    GimbalConfig config;
+    gimbal_config_get (config);
+
+    FILE* csv = NULL;
+    if (options.csv)
+    {
+        csv = fopen (options.csv, "w");
+        if (!csv)
+        {
+            fprintf (stderr, "Can't write %s\n", options.csv);
+            return 1;
+        }
+        fprintf (csv, "time_s,base_deg,pitch_deg,measured_deg,setpoint_deg,effort,current_a,stuck\n");
+    }
+
+    uint64_t seed = (uint64_t)options.seed;
+    SensorErrors errors = { (float)options.acc_noise, (float)options.gyro_noise,
+                            { (float)options.gyro_bias, (float)-options.gyro_bias, (float)options.gyro_bias }, 30.0f };
+    Mpu6050Sim sensor (errors, seed * 2 + 1);
+    sim_imu = &sensor;
+    BaseMotion base (options.profile, options.amplitude, options.frequency, seed * 2 + 2);
+    GimbalModel model (plant, m1_in1_pin, m1_in2_pin);
+    auto wall_start = std::chrono::steady_clock::now ();
+
+    // Boot, as the acquisition task and setup() do: the payload is held level
+    // on a still base while the IMU is woken and calibrated
+    uint64_t now_us = 0;
+    sim_set_time_us (now_us);
+    sense (model, base, sensor);
+    mpu.IMU_init (I2C_SDA, I2C_SCL, MPU_ADDR, PWR_MGMT_1);
+    if (!mpu.cal_acc (MPU_ADDR, config.cal_samples))
+    {
+        fprintf (stderr, "IMU calibration failed\n");
+        return 1;
+    }
+    pitch_motor.init (m1_in1_pin, m1_in2_pin, m1_freq, pwm_resolution);
+    roll_motor.init (m2_in1_pin, m2_in2_pin, m2_freq, pwm_resolution);
+    yaw_motor.init (m3_in1_pin, m3_in2_pin, m3_freq, pwm_resolution);
+    model.set_joint (options.start);
+
+    AngleFuser fuser;
+    PitchLoop loop (pitch_quality);
+    loop.begin ();
+
+    const uint32_t period_us = IMU_PERIOD * portTICK_PERIOD_MS * 1000UL;
+    const uint32_t latency_us = options.latency_us;
+    const uint64_t end_us = options.duration * 1e6;
+    const uint64_t step_us = options.step_period * 1e6;
+    RunTotals totals = { };
+    ImuRaw raw;
+    int16_t setpoint = config.home;
+    int16_t last_effort = 0;
+
+    while (now_us < end_us)
+    {
+        // Acquire
+        sense (model, base, sensor);
+        uint64_t sampled_us = now_us;
+        bool fresh;
+        {
+            sim_set_task (TASK_IMU);
+            TRACE_SCOPE ("acquire");
+            fresh = mpu.read_raw (MPU_ADDR, raw);
+        }
+        totals.failed_reads += fresh ? 0 : 1;
+
+        // The command reaches the motor after the latency
+        advance (model, base, options, setpoint, now_us, latency_us, totals);
+        if (fresh)
+        {
+            // Fuse and control with the firmware's own steps; the steps in
+            // the setpoint stand in for remote setpoints
+            int16_t pitch;
+            int16_t roll;
+            {
+                sim_set_task (TASK_FUSE);
+                TRACE_SCOPE ("fuse");
+                fuser.fuse (mpu, raw, pitch, roll);
+            }
+            remote_valid = options.step != 0 && step_us > 0 && (sampled_us / step_us) % 2 == 1;
+            remote_pitch = config.home + (int16_t)options.step;
+            PitchCycle cycle;
+            {
+                sim_set_task (TASK_PITCH);
+                TRACE_SCOPE ("control_cycle");
+                cycle = loop.control (pitch, remote_setpoint);
+                if (cycle.command.brake)
+                {
+                    pitch_motor.brake ();
+                }
+                else
+                {
+                    pitch_motor.spin (cycle.command.ch1_dc, cycle.command.ch2_dc);
+                }
+                loop.measure (sampled_us, pitch, cycle);
+            }
+
+            int16_t effort = cycle.effort;
+            setpoint = cycle.setpoint;
+            totals.cycles++;
+            totals.braked += cycle.command.brake ? 1 : 0;
+            totals.reversals += (effort > 0 && last_effort < 0) || (effort < 0 && last_effort > 0) ? 1 : 0;
+            totals.effort_sum += abs (effort);
+            last_effort = effort != 0 ? effort : last_effort;
+
+            if (csv)
+            {
+                fprintf (csv, "%.4f,%.3f,%.3f,%d,%d,%d,%.4f,%d\n", sampled_us * 1e-6,
+                         base.get ().pitch * 180.0 / M_PI, model.pitch_deg (base.get ()), pitch, setpoint,
+                         effort, model.get_current (), model.is_stuck () ? 1 : 0);
+            }
+        }
+        advance (model, base, options, setpoint, now_us, period_us - latency_us, totals);
+    }
+
+    if (csv)
+    {
+        fclose (csv);
+    }
+    if (options.trace && !trace_export_file (options.trace))
+    {
+        fprintf (stderr, "Can't write %s\n", options.trace);
+        return 1;
+    }
+    double wall_s = std::chrono::duration<double> (std::chrono::steady_clock::now () - wall_start).count ();
+    print_summary (options, totals, model, wall_s);
+    return 0;
+}
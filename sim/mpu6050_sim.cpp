@@ -0,0 +1,181 @@
+/** @file mpu6050_sim.cpp
+ * This is the implementation file for the simulated MPU-6050 and the I2C bus
+ * it sits on.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <Wire.h>
+#include "mpu6050_sim.h"
+
+const uint8_t REG_ACCEL_XOUT_H = 0x3B;      ///< First data register
+const uint8_t REG_TEMP_OUT_H = 0x41;        ///< Die temperature
+const uint8_t REG_GYRO_XOUT_H = 0x43;       ///< First gyroscope register
+const uint8_t REG_DATA_END = 0x49;          ///< Register after the last data register
+const uint8_t REG_PWR_MGMT_1 = 0x6B;        ///< Power management; bit 6 is sleep
+const uint8_t REG_WHO_AM_I = 0x75;          ///< Identity register
+
+Mpu6050Sim* sim_imu = NULL;                 ///< The device on the simulated bus
+TwoWire Wire;                               ///< The simulated bus
+
+
+/** @brief   Create the sensor as it is at power-up, asleep.
+ *  @param   sensor_errors Noise and bias added to each conversion
+ *  @param   seed Seed for the noise
+*/
+Mpu6050Sim :: Mpu6050Sim (const SensorErrors& sensor_errors, uint64_t seed)
+    : pointer (0), motion (), errors (sensor_errors), random (seed), reads (0)
+{
+    memset (registers, 0, sizeof (registers));
+    registers[REG_PWR_MGMT_1] = 0x40;
+    registers[REG_WHO_AM_I] = MPU_SIM_ADDRESS;
+}
+
+/** @brief   Put a reading into a pair of data registers, high byte first.
+ *  @param   reg The register holding the high byte
+ *  @param   value The reading in counts
+ *  @param   limit Largest count the register can hold
+*/
+void Mpu6050Sim :: put (uint8_t reg, float value, float limit)
+{
+    value = value > limit ? limit : (value < -limit - 1 ? -limit - 1 : value);
+    int16_t count = (int16_t)lrintf (value);
+    registers[reg] = (uint16_t)count >> 8;
+    registers[reg + 1] = count & 0xFF;
+}
+
+/** @brief   Fill the data registers from the current motion, as one conversion does.
+*/
+void Mpu6050Sim :: convert (void)
+{
+    double pitch = motion.pitch_deg * M_PI / 180.0;
+    double roll = motion.roll_deg * M_PI / 180.0;
+
+    // Specific force in g: gravity plus the base's acceleration, turned by
+    // pitch about Y and then roll about X into the sensor's axes
+    double forward = motion.acc_forward / MPU_SIM_G;
+    double up = 1.0 + motion.acc_up / MPU_SIM_G;
+    double f_x = forward * cos (pitch) - up * sin (pitch);
+    double f_z = forward * sin (pitch) + up * cos (pitch);
+    double acc[3] = { f_x, f_z * sin (roll), f_z * cos (roll) };
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        float g = acc[axis] + errors.acc_noise_g * random.gaussian ();
+        put (REG_ACCEL_XOUT_H + 2 * axis, g * MPU_SIM_ACC_LSB, 32767);
+
+        float dps = motion.rate_dps[axis] + errors.gyro_bias_dps[axis] + errors.gyro_noise_dps * random.gaussian ();
+        put (REG_GYRO_XOUT_H + 2 * axis, dps * MPU_SIM_GYRO_LSB, 32767);
+    }
+    put (REG_TEMP_OUT_H, (errors.temperature_c - 36.53f) * 340.0f, 32767);
+}
+
+/** @brief   Handle a write transaction: a register address, then any data for it.
+ *  @param   data The bytes written
+ *  @param   length Number of bytes written
+*/
+void Mpu6050Sim :: write (const uint8_t* data, uint8_t length)
+{
+    if (length == 0)
+    {
+        return;
+    }
+    pointer = data[0] & 0x7F;
+    for (uint8_t index = 1; index < length; index++)
+    {
+        registers[pointer] = data[index];
+        pointer = (pointer + 1) & 0x7F;
+    }
+}
+
+/** @brief   Handle a read transaction starting at the register pointer.
+ *  @details A read which starts at a data register sees a fresh conversion,
+ *           as the real part updates its data registers at the sample rate.
+ *  @param   data Where the bytes are put
+ *  @param   length Number of bytes asked for
+ *  @returns The number of bytes read
+*/
+uint8_t Mpu6050Sim :: read (uint8_t* data, uint8_t length)
+{
+    if (pointer >= REG_ACCEL_XOUT_H && pointer < REG_DATA_END)
+    {
+        if (awake ())
+        {
+            convert ();
+        }
+        else
+        {
+            memset (registers + REG_ACCEL_XOUT_H, 0, REG_DATA_END - REG_ACCEL_XOUT_H);
+        }
+        reads++;
+    }
+    for (uint8_t index = 0; index < length; index++)
+    {
+        data[index] = registers[pointer];
+        pointer = (pointer + 1) & 0x7F;
+    }
+    return length;
+}
+
+bool TwoWire :: begin (int sda, int scl, uint32_t frequency)
+{
+    return true;
+}
+
+void TwoWire :: beginTransmission (uint16_t device)
+{
+    address = device;
+    tx_length = 0;
+}
+
+size_t TwoWire :: write (uint8_t data)
+{
+    if (tx_length == sizeof (tx))
+    {
+        return 0;
+    }
+    tx[tx_length++] = data;
+    return 1;
+}
+
+/** @brief   Send the transaction built since @c beginTransmission().
+ *  @returns 0 on success or 2 if no device answered, as the Arduino core does
+*/
+uint8_t TwoWire :: endTransmission (bool stop)
+{
+    if (address != MPU_SIM_ADDRESS || sim_imu == NULL)
+    {
+        return 2;
+    }
+    sim_imu->write (tx, tx_length);
+    tx_length = 0;
+    return 0;
+}
+
+/** @brief   Read bytes from a device.
+ *  @returns The number of bytes read, 0 if no device answered
+*/
+uint8_t TwoWire :: requestFrom (uint16_t device, uint8_t length)
+{
+    rx_index = 0;
+    rx_length = 0;
+    if (device != MPU_SIM_ADDRESS || sim_imu == NULL)
+    {
+        return 0;
+    }
+    length = length > sizeof (rx) ? sizeof (rx) : length;
+    rx_length = sim_imu->read (rx, length);
+    return rx_length;
+}
+
+int TwoWire :: available (void)
+{
+    return rx_length - rx_index;
+}
+
+int TwoWire :: read (void)
+{
+    return rx_index < rx_length ? rx[rx_index++] : -1;
+}
@@ -0,0 +1,76 @@
+/** @file mpu6050_sim.h
+ * This is the header file for the simulated MPU-6050. It sits on the
+ * simulated I2C bus at address 0x68 and answers the same register reads as
+ * the real part, so the IMU class runs unchanged. Each burst read is a new
+ * conversion of the payload's true motion: gravity and the base's
+ * acceleration for the accelerometer, the angular rates for the gyroscope,
+ * each with white noise and a fixed bias, quantized and clipped to the
+ * +/-2 g and +/-250 deg/s ranges the firmware uses.
+ * 
+ * The part wakes up asleep, reading all zeros, until @c PWR_MGMT_1 is
+ * cleared, as the real one does.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _MPU6050_SIM_
+#define _MPU6050_SIM_
+
+#include <Arduino.h>
+#include "sim_random.h"
+
+const uint8_t MPU_SIM_ADDRESS = 0x68;       ///< I2C address, with AD0 low
+const float MPU_SIM_ACC_LSB = 16384.0f;     ///< Accelerometer counts per g at +/-2 g
+const float MPU_SIM_GYRO_LSB = 131.0f;      ///< Gyroscope counts per deg/s at +/-250 deg/s
+const float MPU_SIM_G = 9.80665f;           ///< Standard gravity in m/s^2
+
+/** @brief True motion of the sensor, set by the simulator before each read
+*/
+struct SensorMotion
+{
+    double pitch_deg;       ///< Payload pitch, about the sensor's Y axis
+    double roll_deg;        ///< Payload roll, about the sensor's X axis
+    double rate_dps[3];     ///< Angular rate about X, Y and Z in deg/s
+    double acc_forward;     ///< Horizontal acceleration along the pitch plane in m/s^2
+    double acc_up;          ///< Vertical acceleration in m/s^2
+};
+
+/** @brief Imperfections of the sensor
+*/
+struct SensorErrors
+{
+    float acc_noise_g;      ///< Standard deviation of the accelerometer noise in g
+    float gyro_noise_dps;   ///< Standard deviation of the gyroscope noise in deg/s
+    float gyro_bias_dps[3]; ///< Gyroscope reading when still, X, Y and Z
+    float temperature_c;    ///< Die temperature
+};
+
+/** @brief   Class which models the MPU-6050's registers.
+*/
+class Mpu6050Sim
+{
+    protected:
+        uint8_t registers[128];     ///< The register file
+        uint8_t pointer;            ///< Register the next read or write starts at
+        SensorMotion motion;        ///< Motion sensed by the next conversion
+        SensorErrors errors;        ///< Noise and bias added to each conversion
+        SimRandom random;           ///< Source of the noise
+        uint32_t reads;             ///< Burst reads answered
+
+        void convert (void);
+        void put (uint8_t reg, float value, float limit);
+
+    public:
+        Mpu6050Sim (const SensorErrors& sensor_errors, uint64_t seed);
+        void set_motion (const SensorMotion& true_motion) { motion = true_motion; }
+        void write (const uint8_t* data, uint8_t length);
+        uint8_t read (uint8_t* data, uint8_t length);
+        bool awake (void) const { return (registers[0x6B] & 0x40) == 0; }
+        uint32_t read_count (void) const { return reads; }
+};
+
+extern Mpu6050Sim* sim_imu;
+
+#endif
@@ -0,0 +1,92 @@
+/** @file Arduino.h
+ * This file stands in for the ESP32 Arduino core when the gimbal code is
+ * built for the simulator. It gives the firmware the types, math and
+ * @c Print class it expects; time comes from the simulation clock and the
+ * LEDC functions drive the simulated motors. See sim_hal.h.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SIM_ARDUINO_
+#define _SIM_ARDUINO_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+
+using std::min;
+using std::max;
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define LOW     0
+#define HIGH    1
+#define INPUT   0x01
+#define OUTPUT  0x03
+#define INPUT_PULLUP 0x05
+#define RISING  0x01
+#define FALLING 0x02
+
+#define IRAM_ATTR
+
+typedef uint8_t byte;
+
+/** @brief   Class which the firmware's reports print to, as in the Arduino core.
+*/
+class Print
+{
+    public:
+        virtual ~Print (void) { }
+        virtual size_t write (uint8_t ch) = 0;
+        virtual size_t write (const uint8_t* data, size_t length)
+        {
+            size_t done = 0;
+            while (done < length && write (data[done]))
+            {
+                done++;
+            }
+            return done;
+        }
+        size_t write (const char* text) { return write ((const uint8_t*)text, strlen (text)); }
+
+        size_t print (const char* text) { return write (text); }
+        size_t print (char ch) { return write ((uint8_t)ch); }
+        size_t print (long number) { return printf_out ("%ld", number); }
+        size_t print (unsigned long number) { return printf_out ("%lu", number); }
+        size_t print (int number) { return print ((long)number); }
+        size_t print (unsigned int number) { return print ((unsigned long)number); }
+        size_t print (double number, int digits = 2) { return printf_out ("%.*f", digits, number); }
+        size_t println (void) { return write ("\n"); }
+
+    protected:
+        /// Format into a small buffer and write it, as the core's number printing does
+        template <typename... Args>
+        size_t printf_out (const char* format, Args... args)
+        {
+            char text[40];
+            snprintf (text, sizeof (text), format, args...);
+            return write (text);
+        }
+};
+
+uint32_t micros (void);
+uint32_t millis (void);
+void delay (uint32_t ms);
+void pinMode (uint8_t pin, uint8_t mode);
+void digitalWrite (uint8_t pin, uint8_t value);
+double ledcSetup (uint8_t channel, double freq, uint8_t resolution);
+void ledcAttachPin (uint8_t pin, uint8_t channel);
+void ledcWrite (uint8_t channel, uint32_t duty);
+
+#endif
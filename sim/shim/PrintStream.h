@@ -0,0 +1,41 @@
+/** @file PrintStream.h
+ * This file stands in for the PrintStream library when the gimbal code is
+ * built for the simulator, giving @c Print the @c << operator.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SIM_PRINTSTREAM_
+#define _SIM_PRINTSTREAM_
+
+#include <type_traits>
+#include <Arduino.h>
+
+/// Manipulator which ends a line, as in the PrintStream library
+enum PrintStreamEndl { endl };
+
+inline Print& operator << (Print& out, PrintStreamEndl) { out.println (); return out; }
+inline Print& operator << (Print& out, const char* text) { out.print (text); return out; }
+inline Print& operator << (Print& out, char ch) { out.print (ch); return out; }
+inline Print& operator << (Print& out, bool flag) { out.print (flag ? "true" : "false"); return out; }
+inline Print& operator << (Print& out, float number) { out.print (number); return out; }
+inline Print& operator << (Print& out, double number) { out.print (number); return out; }
+
+/// Every integer type prints as a signed or unsigned long
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, Print&>::type operator << (Print& out, T number)
+{
+    if (std::is_signed<T>::value)
+    {
+        out.print ((long)number);
+    }
+    else
+    {
+        out.print ((unsigned long)number);
+    }
+    return out;
+}
+
+#endif
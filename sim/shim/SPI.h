@@ -0,0 +1,8 @@
+/** @file SPI.h
+ * This file stands in for the ESP32 Arduino core's SPI library, which IMU.h
+ * includes but doesn't use, when the gimbal code is built for the simulator.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
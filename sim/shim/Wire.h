@@ -0,0 +1,41 @@
+/** @file Wire.h
+ * This file stands in for the ESP32 Arduino core's I2C library when the
+ * gimbal code is built for the simulator. The only device on the bus is the
+ * simulated MPU-6050 in mpu6050_sim.h.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SIM_WIRE_
+#define _SIM_WIRE_
+
+#include <Arduino.h>
+
+/** @brief   Class with the parts of the Arduino @c TwoWire interface the IMU code uses.
+*/
+class TwoWire
+{
+    protected:
+        uint8_t address;        ///< Device addressed by the transaction being built
+        uint8_t tx[16];         ///< Bytes written in the transaction being built
+        uint8_t tx_length;      ///< Number of bytes in @c tx
+        uint8_t rx[32];         ///< Bytes read by the last @c requestFrom()
+        uint8_t rx_length;      ///< Number of bytes in @c rx
+        uint8_t rx_index;       ///< Next byte of @c rx to be read
+
+    public:
+        TwoWire (void) : address (0), tx_length (0), rx_length (0), rx_index (0) { }
+        bool begin (int sda, int scl, uint32_t frequency);
+        void beginTransmission (uint16_t device);
+        size_t write (uint8_t data);
+        uint8_t endTransmission (bool stop = true);
+        uint8_t requestFrom (uint16_t device, uint8_t length);
+        int available (void);
+        int read (void);
+};
+
+extern TwoWire Wire;
+
+#endif
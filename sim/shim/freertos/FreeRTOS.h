@@ -0,0 +1,41 @@
+/** @file FreeRTOS.h
+ * This file stands in for the FreeRTOS headers when the gimbal code is
+ * built for the simulator. Only the types and tick conversions used by
+ * shared headers are given, plus the task calls the trace recorder makes;
+ * the simulator runs the tasks' work itself, one control cycle at a time,
+ * instead of scheduling tasks, and tells sim_hal.cpp which task it is
+ * standing in for.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SIM_FREERTOS_
+#define _SIM_FREERTOS_
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void* TaskHandle_t;
+
+#define portTICK_PERIOD_MS  1
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms) / portTICK_PERIOD_MS)
+#define pdTRUE              1
+#define pdFALSE             0
+
+/// The simulator runs on one thread, so a critical section has nothing to lock
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+
+TaskHandle_t xTaskGetCurrentTaskHandle (void);
+const char* pcTaskGetName (TaskHandle_t task);
+BaseType_t xPortGetCoreID (void);
+void vTaskDelay (TickType_t ticks);
+
+#endif
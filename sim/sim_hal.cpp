@@ -0,0 +1,246 @@
+/** @file sim_hal.cpp
+ * This is the implementation file for the simulated hardware under the gimbal
+ * code. The LEDC functions keep track of which channel drives each pin, as
+ * the ESP32's output matrix does, so the motor model sees the duty cycle on
+ * the driver's inputs whichever channel the firmware chose. Log messages go
+ * to @c stderr, formatted as the logging task formats them. The task calls
+ * report whichever task from the task table the simulator last said it was
+ * running, so traces show each stage on its own track and core.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "sim_hal.h"
+
+const uint8_t SIM_PINS = 40;                ///< GPIO pins on the ESP32
+const uint8_t SIM_LEDC_CHANNELS = 16;       ///< LEDC channels on the ESP32
+
+static uint64_t now_us = 0;                 ///< Simulated time since boot
+
+/** @brief One LEDC channel
+*/
+struct LedcChannel
+{
+    uint32_t frequency;     ///< PWM frequency in Hz, 0 if the channel isn't set up
+    uint8_t resolution;     ///< Bits of duty cycle resolution
+    uint32_t duty;          ///< Duty cycle in counts of 2^resolution
+};
+
+static LedcChannel channels[SIM_LEDC_CHANNELS]; ///< State of each channel
+static int8_t pin_channel[SIM_PINS];        ///< Channel driving each pin, or -1
+static uint8_t pin_level[SIM_PINS];         ///< Level of pins driven by @c digitalWrite()
+static bool pins_ready = false;             ///< @c true once @c pin_channel has been cleared
+
+static LogLevel log_level = LVL_WARN;       ///< Messages above this level aren't printed
+static uint32_t log_counts[LOG_LEVEL_TRACE + 1];    ///< Messages logged at each level
+
+/** @brief A task from the task table, as far as the trace recorder needs it
+*/
+struct SimTask
+{
+    const char* name;       ///< Name of the task
+    BaseType_t core;        ///< Core the task is pinned to
+};
+
+/// The tasks in @c TASK_TABLE, whose addresses serve as their handles
+static SimTask sim_tasks[NUM_TASKS] =
+{
+#define SIM_TASK(id, function, name, stack, priority, core) { name, core },
+    TASK_TABLE (SIM_TASK)
+#undef SIM_TASK
+};
+
+static SimTask boot_task = { "loopTask", CONTROL_CORE };   ///< Where @c setup() runs, until a task is chosen
+static SimTask* current_task = &boot_task;                  ///< The task the simulator is standing in for
+
+/// Format strings, indexed by @c LogFormat
+static const char* const log_format_text[NUM_LOG_FORMATS] =
+{
+#define LOG_FORMAT_TEXT(id, text) text,
+    LOG_FORMATS (LOG_FORMAT_TEXT)
+#undef LOG_FORMAT_TEXT
+};
+
+
+/** @brief   Set the simulated time.
+ *  @param   time_us Microseconds since boot
+*/
+void sim_set_time_us (uint64_t time_us)
+{
+    now_us = time_us;
+}
+
+/** @brief   Return the simulated time in microseconds since boot.
+*/
+uint64_t sim_time_us (void)
+{
+    return now_us;
+}
+
+uint32_t micros (void)
+{
+    return (uint32_t)now_us;
+}
+
+uint32_t millis (void)
+{
+    return (uint32_t)(now_us / 1000);
+}
+
+/** @brief   Wait by moving the simulated clock on; nothing else happens meanwhile.
+*/
+void delay (uint32_t ms)
+{
+    now_us += ms * 1000ULL;
+}
+
+/** @brief   Detach every pin from the LEDC channels, once.
+*/
+static void clear_pins (void)
+{
+    if (!pins_ready)
+    {
+        memset (pin_channel, -1, sizeof (pin_channel));
+        pins_ready = true;
+    }
+}
+
+void pinMode (uint8_t pin, uint8_t mode)
+{
+    clear_pins ();
+}
+
+void digitalWrite (uint8_t pin, uint8_t value)
+{
+    if (pin < SIM_PINS)
+    {
+        pin_level[pin] = value;
+    }
+}
+
+double ledcSetup (uint8_t channel, double freq, uint8_t resolution)
+{
+    if (channel >= SIM_LEDC_CHANNELS)
+    {
+        return 0;
+    }
+    channels[channel].frequency = freq;
+    channels[channel].resolution = resolution;
+    channels[channel].duty = 0;
+    return freq;
+}
+
+void ledcAttachPin (uint8_t pin, uint8_t channel)
+{
+    clear_pins ();
+    if (pin < SIM_PINS && channel < SIM_LEDC_CHANNELS)
+    {
+        pin_channel[pin] = channel;
+    }
+}
+
+void ledcWrite (uint8_t channel, uint32_t duty)
+{
+    if (channel < SIM_LEDC_CHANNELS)
+    {
+        channels[channel].duty = duty;
+    }
+}
+
+/** @brief   Return the fraction of the time a pin is high.
+ *  @param   pin The GPIO pin
+ *  @returns The PWM duty cycle from 0 to 1, or the pin's level if no channel drives it
+*/
+float sim_pin_duty (uint8_t pin)
+{
+    clear_pins ();
+    if (pin >= SIM_PINS)
+    {
+        return 0.0f;
+    }
+    if (pin_channel[pin] < 0)
+    {
+        return pin_level[pin] ? 1.0f : 0.0f;
+    }
+    const LedcChannel& channel = channels[pin_channel[pin]];
+    float duty = (float)channel.duty / (1UL << channel.resolution);
+    return duty > 1.0f ? 1.0f : duty;
+}
+
+/** @brief   Return the PWM frequency on a pin, or 0 if no LEDC channel drives it.
+*/
+uint32_t sim_pin_frequency (uint8_t pin)
+{
+    clear_pins ();
+    return (pin < SIM_PINS && pin_channel[pin] >= 0) ? channels[pin_channel[pin]].frequency : 0;
+}
+
+/** @brief   Say which task's work the simulator is doing from now on.
+ *  @param   task The task in the task table
+*/
+void sim_set_task (TaskId task)
+{
+    if (task < NUM_TASKS)
+    {
+        current_task = &sim_tasks[task];
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle (void)
+{
+    return current_task;
+}
+
+const char* pcTaskGetName (TaskHandle_t task)
+{
+    return task ? ((SimTask*)task)->name : "?";
+}
+
+BaseType_t xPortGetCoreID (void)
+{
+    return current_task->core;
+}
+
+/** @brief   Sleep by moving the simulated clock on, as @c delay() does.
+*/
+void vTaskDelay (TickType_t ticks)
+{
+    delay (ticks * portTICK_PERIOD_MS);
+}
+
+/** @brief   Set which log messages are printed.
+ *  @param   level Messages at this level or more severe are printed
+*/
+void sim_log_level (LogLevel level)
+{
+    log_level = level;
+}
+
+/** @brief   Return the number of messages logged at a level, printed or not.
+*/
+uint32_t sim_log_count (LogLevel level)
+{
+    return log_counts[level];
+}
+
+/** @brief   Print a log message to @c stderr, stamped with the simulated time.
+ *  @details This takes the place of the logger's queue and task; there are no
+ *           rate limits, as nothing runs at the same time.
+*/
+void log_event (LogModule module, LogLevel level, LogFormat format,
+                int32_t a0, int32_t a1, int32_t a2, int32_t a3)
+{
+    static const char* const module_names[NUM_LOG_MODULES] = { "main", "imu", "motor", "control", "net", "sync" };
+    static const char levels[] = "-EWIDT";
+
+    log_counts[level]++;
+    if (level > log_level || format >= NUM_LOG_FORMATS)
+    {
+        return;
+    }
+    fprintf (stderr, "[%lu] %c %s: ", (unsigned long)millis (), levels[level], module_names[module]);
+    fprintf (stderr, log_format_text[format], a0, a1, a2, a3);
+    fputc ('\n', stderr);
+}
@@ -0,0 +1,29 @@
+/** @file sim_hal.h
+ * This is the header file for the simulated hardware under the gimbal code:
+ * the clock behind @c micros() and @c millis(), the LEDC PWM channels which
+ * @c Motor writes, the logger, and the task which the trace recorder sees
+ * as running. The simulator sets the clock itself, so a
+ * run takes as long as the arithmetic does, not as long as the time it
+ * simulates.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SIM_HAL_
+#define _SIM_HAL_
+
+#include <Arduino.h>
+#include "logger.h"
+#include "task_config.h"
+
+void sim_set_time_us (uint64_t time_us);
+uint64_t sim_time_us (void);
+float sim_pin_duty (uint8_t pin);
+uint32_t sim_pin_frequency (uint8_t pin);
+void sim_log_level (LogLevel level);
+uint32_t sim_log_count (LogLevel level);
+void sim_set_task (TaskId task);
+
+#endif
@@ -0,0 +1,74 @@
+/** @file sim_random.h
+ * This file contains the random number generator used by the simulator. It
+ * is written out here rather than taken from @c <random>, whose
+ * distributions may differ between compilers, so a seed gives the same run
+ * on every machine.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SIM_RANDOM_
+#define _SIM_RANDOM_
+
+#include <stdint.h>
+#include <math.h>
+
+/** @brief   Class which makes a repeatable stream of random numbers from a seed.
+ *  @details Numbers come from xorshift64*; the seed is spread over the state
+ *           with splitmix64, so nearby seeds give unrelated streams.
+*/
+class SimRandom
+{
+    protected:
+        uint64_t state;         ///< Generator state, never zero
+        double spare;           ///< Second normal value from the last Box-Muller pair
+        bool has_spare;         ///< @c true if @c spare hasn't been used yet
+
+    public:
+        SimRandom (uint64_t seed) { reseed (seed); }
+
+        /// Start the stream again from a seed
+        void reseed (uint64_t seed)
+        {
+            uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            state = (z ^ (z >> 31)) | 1;
+            has_spare = false;
+        }
+
+        /// Next 64 random bits
+        uint64_t next (void)
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 0x2545F4914F6CDD1DULL;
+        }
+
+        /// Uniform value in [0, 1)
+        double uniform (void)
+        {
+            return (next () >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        /// Normal value with mean 0 and standard deviation 1
+        double gaussian (void)
+        {
+            if (has_spare)
+            {
+                has_spare = false;
+                return spare;
+            }
+            double u = 1.0 - uniform ();
+            double v = uniform ();
+            double radius = sqrt (-2.0 * log (u));
+            spare = radius * sin (2.0 * M_PI * v);
+            has_spare = true;
+            return radius * cos (2.0 * M_PI * v);
+        }
+};
+
+#endif
@@ -0,0 +1,267 @@
+/** @file stab_metrics.cpp
+ * This is the implementation file for the stabilization quality metrics.
+ * The sliding windows keep running sums of squares, adding the newest
+ * residual and taking off the one which has just left the window, so each
+ * cycle costs the same however long the windows are. The results are
+ * published through a @c Mailbox once per cycle.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include "stab_metrics.h"
+#include "telemetry.h"
+#include "logger.h"
+
+
+/** @brief   Create a set of metrics with nothing measured.
+*/
+StabilityMetrics :: StabilityMetrics (void)
+{
+    min_band = 1;
+    limit_forward = FULL_DUTY;
+    limit_reverse = FULL_DUTY;
+    reset ();
+}
+
+/** @brief   Set the efforts at which the motor counts as saturated.
+ *  @details These are the duty cycles the controller drives with, so pass the
+ *           same @c duty_forward and @c duty_reverse it was given. A limit of
+ *           zero means that direction is never driven and never saturates.
+ *  @param   forward Duty cycle on channel 1, which gives positive effort
+ *  @param   reverse Duty cycle on channel 2, which gives negative effort
+*/
+void StabilityMetrics :: set_limits (uint8_t forward, uint8_t reverse)
+{
+    limit_forward = forward;
+    limit_reverse = reverse;
+}
+
+/** @brief   Throw away everything measured so far.
+ *  @details This is done when the gains change, so the results belong to one tuning.
+*/
+void StabilityMetrics :: reset (void)
+{
+    memset (residuals, 0, sizeof (residuals));
+    samples = 0;
+    sum_short = 0;
+    sum_long = 0;
+    stepping = false;
+    saturated = false;
+    total_rise_ms = 0;
+    risen_steps = 0;
+    total_settle_ms = 0;
+    memset (&results, 0, sizeof (results));
+    published.put (results);
+}
+
+/** @brief   Record the result of the step being measured and stop measuring it.
+ *  @param   settled @c true if the angle settled in the band
+*/
+void StabilityMetrics :: finish_step (bool settled)
+{
+    StepResult& step = results.last_step;
+    step.settle_ms = settled ? (band_entry_us - step_start_us) / 1000 : 0;
+    step.overshoot_pct = (peak_pct > 100) ? peak_pct - 100 : 0;
+
+    results.steps++;
+    if (step.rise_ms > 0)
+    {
+        risen_steps++;
+        total_rise_ms += step.rise_ms;
+        results.mean_rise_ms = total_rise_ms / risen_steps;
+    }
+    if (settled)
+    {
+        results.steps_settled++;
+        total_settle_ms += step.settle_ms;
+        results.mean_settle_ms = total_settle_ms / results.steps_settled;
+    }
+    if (step.overshoot_pct > results.max_overshoot_pct)
+    {
+        results.max_overshoot_pct = step.overshoot_pct;
+    }
+    stepping = false;
+    LOG_INFO (MOD_CONTROL, FMT_STEP_DONE, step.to_deg - step.from_deg, step.rise_ms, step.overshoot_pct, step.settle_ms);
+}
+
+/** @brief   Update the metrics with one control cycle.
+ *  @param   time_us Time at which the IMU was sampled, from @c micros()
+ *  @param   angle Measured angle in degrees
+ *  @param   setpoint Setpoint in degrees
+ *  @param   effort Motor effort
+ *  @returns Telemetry flags: @c TELEM_STEP while a step is being measured and
+ *           @c TELEM_SATURATED if the effort is at its limit
+*/
+uint8_t StabilityMetrics :: record (uint32_t time_us, int16_t angle, int16_t setpoint, int16_t effort)
+{
+    uint8_t flags = 0;
+
+    // Sliding windows of the residual
+    int32_t residual = angle - setpoint;
+    uint32_t square = residual * residual;
+    uint32_t slot = samples % RMS_LONG_SAMPLES;
+    if (samples >= RMS_LONG_SAMPLES)
+    {
+        sum_long -= (int32_t)residuals[slot] * residuals[slot];
+    }
+    if (samples >= RMS_SHORT_SAMPLES)
+    {
+        int16_t leaving = residuals[(samples - RMS_SHORT_SAMPLES) % RMS_LONG_SAMPLES];
+        sum_short -= (int32_t)leaving * leaving;
+    }
+    residuals[slot] = residual;
+    sum_short += square;
+    sum_long += square;
+    samples++;
+    results.rms_short = sqrtf ((float)sum_short / (samples < RMS_SHORT_SAMPLES ? samples : RMS_SHORT_SAMPLES));
+    results.rms_long = sqrtf ((float)sum_long / (samples < RMS_LONG_SAMPLES ? samples : RMS_LONG_SAMPLES));
+
+    // A jump in the setpoint starts a new step, giving up any step under way
+    if (samples > 1 && abs (setpoint - last_setpoint) >= STEP_MIN_DEG)
+    {
+        if (stepping)
+        {
+            finish_step (false);
+        }
+        StepResult& step = results.last_step;
+        step.time_ms = millis ();
+        step.from_deg = last_setpoint;
+        step.to_deg = setpoint;
+        step.rise_ms = 0;
+        step.overshoot_pct = 0;
+        step.settle_ms = 0;
+        stepping = true;
+        step_start_us = time_us;
+        rise_started = false;
+        risen = false;
+        peak_pct = 0;
+        in_band = false;
+    }
+    last_setpoint = setpoint;
+
+    if (stepping)
+    {
+        StepResult& step = results.last_step;
+        int32_t size = step.to_deg - step.from_deg;
+        int16_t percent = (int32_t)(angle - step.from_deg) * 100 / size;
+        if (!rise_started && percent >= 10)
+        {
+            rise_started = true;
+            rise_start_us = time_us;
+        }
+        if (!risen && percent >= 90)
+        {
+            risen = true;
+            step.rise_ms = (time_us - (rise_started ? rise_start_us : step_start_us)) / 1000;
+            step.rise_ms = step.rise_ms ? step.rise_ms : 1;
+        }
+        peak_pct = (percent > peak_pct) ? percent : peak_pct;
+
+        int16_t band = abs (size) * SETTLE_PERCENT / 100;
+        band = (band < min_band) ? min_band : band;
+        if (abs (angle - step.to_deg) <= band)
+        {
+            if (!in_band)
+            {
+                in_band = true;
+                band_entry_us = time_us;
+            }
+        }
+        else
+        {
+            in_band = false;
+        }
+
+        if (in_band && time_us - band_entry_us >= SETTLE_HOLD_MS * 1000)
+        {
+            finish_step (true);
+        }
+        else if (time_us - step_start_us >= STEP_TIMEOUT_MS * 1000)
+        {
+            finish_step (false);
+        }
+        else
+        {
+            flags |= TELEM_STEP;
+        }
+    }
+
+    // Saturation is counted each time the effort reaches its limit
+    bool at_limit = (limit_forward > 0 && effort >= limit_forward)
+                    || (limit_reverse > 0 && -effort >= limit_reverse);
+    if (at_limit)
+    {
+        results.saturated_cycles++;
+        results.saturation_events += saturated ? 0 : 1;
+        flags |= TELEM_SATURATED;
+    }
+    saturated = at_limit;
+
+    published.put (results);
+    return flags;
+}
+
+/** @brief   Get the results measured so far.
+ *  @param   snapshot A reference to where the results are copied
+*/
+void StabilityMetrics :: get (QualitySnapshot& snapshot) const
+{
+    published.get (snapshot);
+}
+
+/** @brief   Write the results as members of the JSON object which is open.
+ *  @param   json The writer, with an object open
+*/
+void StabilityMetrics :: json (JsonWriter& json) const
+{
+    QualitySnapshot snapshot;
+    get (snapshot);
+
+    json.value ("residual_rms_1s", snapshot.rms_short, 2);
+    json.value ("residual_rms_10s", snapshot.rms_long, 2);
+    json.value ("steps", snapshot.steps);
+    json.value ("steps_settled", snapshot.steps_settled);
+    json.value ("mean_rise_ms", snapshot.mean_rise_ms);
+    json.value ("mean_settle_ms", snapshot.mean_settle_ms);
+    json.value ("max_overshoot_pct", snapshot.max_overshoot_pct);
+    json.value ("saturation_events", snapshot.saturation_events);
+    json.value ("saturated_cycles", snapshot.saturated_cycles);
+    if (snapshot.steps > 0)
+    {
+        const StepResult& step = snapshot.last_step;
+        json.begin_object ("last_step");
+        json.value ("time_ms", step.time_ms);
+        json.value ("from_deg", step.from_deg);
+        json.value ("to_deg", step.to_deg);
+        json.value ("rise_ms", step.rise_ms);
+        json.value ("overshoot_pct", step.overshoot_pct);
+        json.value ("settle_ms", step.settle_ms);
+        json.end_object ();
+    }
+}
+
+/** @brief   Print the results measured so far.
+ *  @param   out The device to which the report is printed
+*/
+void StabilityMetrics :: print (Print& out) const
+{
+    QualitySnapshot snapshot;
+    get (snapshot);
+
+    out << "Residual RMS: " << snapshot.rms_short << " deg over 1 s, "
+        << snapshot.rms_long << " deg over 10 s" << endl;
+    out << "Steps: " << snapshot.steps << " measured, " << snapshot.steps_settled << " settled; mean rise "
+        << snapshot.mean_rise_ms << " ms, mean settling " << snapshot.mean_settle_ms << " ms, worst overshoot "
+        << snapshot.max_overshoot_pct << "%" << endl;
+    if (snapshot.steps > 0)
+    {
+        const StepResult& step = snapshot.last_step;
+        out << "Last step: " << step.from_deg << " to " << step.to_deg << " deg at " << step.time_ms
+            << " ms; rise " << step.rise_ms << " ms, overshoot " << step.overshoot_pct << "%, settling "
+            << step.settle_ms << " ms" << endl;
+    }
+    out << "Saturation: " << snapshot.saturation_events << " events, "
+        << snapshot.saturated_cycles << " cycles" << endl;
+}
@@ -0,0 +1,114 @@
+/** @file stab_metrics.h
+ * This is the header file for the stabilization quality metrics, which
+ * measure how well an axis holds its setpoint so that firmware builds and
+ * tunings can be compared on the real gimbal. Next to the controller, each
+ * control cycle updates:
+ * 
+ * - The RMS of the residual (angle minus setpoint) over the last second and
+ *   the last ten seconds, as sliding windows.
+ * - Step responses: when the setpoint jumps by @c STEP_MIN_DEG or more in one
+ *   cycle, the 10-90 % rise time, the overshoot and the settling time are
+ *   measured. Slewed setpoints move in small steps and aren't measured.
+ * - Saturation: cycles in which the motor effort is at its limit, and how
+ *   many times that limit was reached. The limit is the duty cycle the
+ *   controller is set to drive with in each direction, given by
+ *   @c set_limits() whenever the settings change.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _STAB_METRICS_
+#define _STAB_METRICS_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "lockfree.h"
+#include "task_config.h"
+#include "json_writer.h"
+
+const uint16_t RMS_SHORT_SAMPLES = CONTROL_RATE_HZ;         ///< Samples in the short residual window, one second
+const uint16_t RMS_LONG_SAMPLES = 10 * CONTROL_RATE_HZ;     ///< Samples in the long residual window, ten seconds
+const int16_t STEP_MIN_DEG = 2;             ///< Smallest setpoint jump which is measured as a step
+const uint8_t SETTLE_PERCENT = 5;           ///< Settling band as a percentage of the step
+const uint32_t SETTLE_HOLD_MS = 500;        ///< Time the angle must stay in the band to have settled
+const uint32_t STEP_TIMEOUT_MS = 5000;      ///< Steps which haven't settled by now are given up
+const uint8_t FULL_DUTY = 255;              ///< Largest duty cycle with 8-bit PWM; the default effort limit
+
+/** @brief Response to one setpoint step
+*/
+struct StepResult
+{
+    uint32_t time_ms;       ///< Time the step began, from @c millis()
+    int16_t from_deg;       ///< Setpoint before the step
+    int16_t to_deg;         ///< Setpoint after the step
+    uint32_t rise_ms;       ///< Time from 10 % to 90 % of the step, or 0 if 90 % wasn't reached
+    uint16_t overshoot_pct; ///< Largest excursion past the new setpoint, as a percentage of the step
+    uint32_t settle_ms;     ///< Time from the step until the angle stayed in the band, or 0 if it didn't
+};
+
+/** @brief Everything measured so far, as read by other tasks
+*/
+struct QualitySnapshot
+{
+    float rms_short;                ///< Residual RMS over the last second, in degrees
+    float rms_long;                 ///< Residual RMS over the last ten seconds, in degrees
+    uint32_t steps;                 ///< Steps measured
+    uint32_t steps_settled;         ///< Steps which settled before the timeout
+    uint32_t mean_rise_ms;          ///< Mean rise time of the steps which reached 90 %
+    uint32_t mean_settle_ms;        ///< Mean settling time of the steps which settled
+    uint16_t max_overshoot_pct;     ///< Largest overshoot of any step
+    uint32_t saturation_events;     ///< Times the effort reached its limit
+    uint32_t saturated_cycles;      ///< Cycles spent at the limit
+    StepResult last_step;           ///< The most recent step measured
+};
+
+/** @brief   Class which measures the stabilization quality of one axis.
+ *  @details Only the axis's control task may call @c record() and @c reset();
+ *           any task may call the other methods.
+ */
+class StabilityMetrics
+{
+    protected:
+        int16_t residuals[RMS_LONG_SAMPLES];    ///< Most recent residuals, oldest overwritten first
+        uint32_t samples;                       ///< Residuals recorded
+        uint32_t sum_short;                     ///< Sum of squares over the short window
+        uint32_t sum_long;                      ///< Sum of squares over the long window
+
+        int16_t last_setpoint;                  ///< Setpoint in the previous cycle
+        bool stepping;                          ///< @c true while a step response is being measured
+        uint32_t step_start_us;                 ///< Time the step began
+        uint32_t rise_start_us;                 ///< Time the angle passed 10 % of the step
+        bool rise_started;                      ///< @c true once the angle has passed 10 %
+        bool risen;                             ///< @c true once the angle has passed 90 %
+        int16_t peak_pct;                       ///< Furthest the angle has got, as a percentage of the step
+        uint32_t band_entry_us;                 ///< Time the angle last entered the settling band
+        bool in_band;                           ///< @c true while the angle is in the settling band
+        int16_t min_band;                       ///< Narrowest settling band in degrees
+        bool saturated;                         ///< @c true if the last cycle was saturated
+        uint8_t limit_forward;                  ///< Effort at or above which the motor is saturated
+        uint8_t limit_reverse;                  ///< Negative effort at or below minus this is saturated
+
+        uint64_t total_rise_ms;                 ///< Sum of rise times, for the mean
+        uint32_t risen_steps;                   ///< Steps which reached 90 %
+        uint64_t total_settle_ms;               ///< Sum of settling times, for the mean
+
+        QualitySnapshot results;                ///< Results kept by the control task
+        Mailbox<QualitySnapshot> published;     ///< Results as seen by other tasks
+
+        void finish_step (bool settled);
+
+    public:
+        StabilityMetrics (void);
+        void reset (void);
+        void set_min_band (int16_t degrees) { min_band = degrees > 0 ? degrees : 1; }
+        void set_limits (uint8_t forward, uint8_t reverse);
+        uint8_t record (uint32_t time_us, int16_t angle, int16_t setpoint, int16_t effort);
+        void get (QualitySnapshot& snapshot) const;
+        void json (JsonWriter& json) const;
+        void print (Print& out) const;
+};
+
+#endif
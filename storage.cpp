@@ -0,0 +1,70 @@
+/** @file storage.cpp
+ * This is the implementation file for the flash file system. If LittleFS
+ * can't be mounted it is formatted; if that fails too, everything which
+ * writes to flash is disabled and the rest of the gimbal carries on.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include <LittleFS.h>
+#include "storage.h"
+#include "boot_sequence.h"
+#include "logger.h"
+
+static std::atomic<bool> mounted (false);   ///< @c true once LittleFS is usable
+
+
+/** @brief   Mount LittleFS, formatting it if it can't be mounted.
+ *  @details Only the black-box task calls this, once, when it starts.
+*/
+void storage_begin (void)
+{
+    boot_stage_begin (BOOT_STORAGE);
+    if (LittleFS.begin (true))
+    {
+        mounted.store (true);
+    }
+    else
+    {
+        LOG_ERROR (MOD_MAIN, FMT_FS_MOUNT_FAILED);
+    }
+    boot_stage_end (BOOT_STORAGE);
+}
+
+/** @brief   Wait until LittleFS has been mounted, or failed to mount.
+ *  @returns @c true if files may be used
+*/
+bool storage_ready (void)
+{
+    boot_wait (BOOT_STORAGE);
+    return mounted.load ();
+}
+
+/** @brief   Return the number of bytes free in LittleFS, or zero if it isn't mounted.
+*/
+size_t storage_free (void)
+{
+    if (!mounted.load ())
+    {
+        return 0;
+    }
+    size_t total = LittleFS.totalBytes ();
+    size_t used = LittleFS.usedBytes ();
+    return total > used ? total - used : 0;
+}
+
+/** @brief   Print how much of the flash file system is in use.
+ *  @param   out The device to which the report is printed
+*/
+void storage_print (Print& out)
+{
+    if (!mounted.load ())
+    {
+        out << "Flash: not mounted" << endl;
+        return;
+    }
+    out << "Flash: " << LittleFS.usedBytes () << " of " << LittleFS.totalBytes () << " bytes used" << endl;
+}
@@ -0,0 +1,22 @@
+/** @file storage.h
+ * This is the header file for the flash file system. LittleFS is mounted
+ * once, by the black-box task, as the @c BOOT_STORAGE boot stage; the black
+ * box and the flash log each keep their files in their own directory.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _STORAGE_
+#define _STORAGE_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+void storage_begin (void);
+bool storage_ready (void);
+size_t storage_free (void);
+void storage_print (Print& out);
+
+#endif
@@ -0,0 +1,271 @@
+/** @file supervisor.cpp
+ * This is the implementation file for the supervisor. It runs as the
+ * highest priority task on the control core. Each pipeline stage reports a
+ * heartbeat with the trace ID of the sample it handled, and the supervisor
+ * checks every stage against its deadline and checks that control keeps up
+ * with acquisition. A miss escalates in steps:
+ * 
+ * - Degraded: the miss is logged and control carries on.
+ * - Safe: once a fault has lasted @c SAFE_AFTER_US, the supervisor brakes
+ *   (or coasts) every motor itself and stops the controllers from driving them.
+ * - Reset: once a fault has lasted @c RESET_AFTER_US, the cause is saved in
+ *   memory which survives a software reset and the ESP32 is restarted.
+ * 
+ * Leaving the OK state triggers the black box, and before a reset the
+ * supervisor waits up to @c BLACKBOX_FLUSH_MS for its recording to be saved.
+ * 
+ * A fault only ends once every stage has met its deadline for
+ * @c RECOVER_AFTER_US, so a stage which misses now and then, with good checks
+ * in between, still counts as one continuous fault and escalates; when the
+ * fault ends the state goes back to OK. The supervisor task itself is watched
+ * by the ESP-IDF task watchdog, so a hung supervisor also ends in a reset.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include <esp_task_wdt.h>
+#include "supervisor.h"
+#include "task_config.h"
+#include "logger.h"
+#include "boot_sequence.h"
+#include "blackbox.h"
+
+const uint32_t SUPERVISOR_PERIOD_MS = 5;        ///< Time between checks
+const uint32_t SAFE_AFTER_US = 100000;          ///< Length of a fault before the motors are stopped
+const uint32_t RESET_AFTER_US = 2000000;        ///< Length of a fault before a reset
+const uint32_t RECOVER_AFTER_US = 500000;       ///< Time without misses which ends a fault and returns to OK
+const uint32_t MAX_CONTROL_LAG = 5;             ///< Samples control may fall behind acquisition
+const bool SAFE_STATE_BRAKES = true;            ///< Brake the motors in the safe state; coast if false
+const uint32_t BLACKBOX_FLUSH_MS = 1000;        ///< Most time to wait for the black box before a reset
+
+/// Most time allowed between heartbeats from each stage
+static const uint32_t deadline_us[NUM_HEARTBEATS] =
+{
+    3 * IMU_PERIOD * portTICK_PERIOD_MS * 1000,
+    3 * IMU_PERIOD * portTICK_PERIOD_MS * 1000,
+    3 * IMU_PERIOD * portTICK_PERIOD_MS * 1000
+};
+
+static const char* const stage_names[NUM_HEARTBEATS] = { "acquire", "fuse", "control" };
+
+static std::atomic<uint32_t> beat_time[NUM_HEARTBEATS];     ///< Time of each stage's last heartbeat
+static std::atomic<uint32_t> beat_sequence[NUM_HEARTBEATS]; ///< Trace ID handled by each stage's last heartbeat
+static std::atomic<uint8_t> state (SUP_OK);                 ///< Current escalation state
+static std::atomic<bool> motors_enabled (true);             ///< Cleared while in the safe state
+
+static Motor* const* supervised_motors = NULL;  ///< Motors to be stopped in the safe state
+static uint8_t num_supervised_motors = 0;       ///< Number of entries in @c supervised_motors
+static uint32_t misses[NUM_HEARTBEATS];         ///< Deadlines missed by each stage since boot
+
+/// Cause of the last supervisor reset; survives a software reset but not a power cycle
+static RTC_NOINIT_ATTR uint32_t reset_magic;
+static RTC_NOINIT_ATTR uint32_t reset_stage;
+static RTC_NOINIT_ATTR uint32_t reset_age_us;
+const uint32_t RESET_MAGIC = 0x53555052;        ///< Marks @c reset_stage as valid ("SUPR")
+
+
+/** @brief   Get the supervisor ready and report if it caused the last reset.
+ *  @param   motors Array of pointers to the motors to be stopped in the safe state
+ *  @param   num_motors Number of motors in the array
+*/
+void supervisor_begin (Motor* const* motors, uint8_t num_motors)
+{
+    supervised_motors = motors;
+    num_supervised_motors = num_motors;
+
+    if (reset_magic == RESET_MAGIC && esp_reset_reason () == ESP_RST_SW)
+    {
+        LOG_ERROR (MOD_MAIN, FMT_SUP_LAST_RESET, reset_stage, reset_age_us);
+    }
+    reset_magic = 0;
+}
+
+/** @brief   Report that a stage has handled a sample.
+ *  @param   stage The stage sending the heartbeat
+ *  @param   sequence The trace ID of the sample it handled
+*/
+void supervisor_heartbeat (HeartbeatStage stage, uint32_t sequence)
+{
+    beat_sequence[stage].store (sequence, std::memory_order_relaxed);
+    beat_time[stage].store (micros (), std::memory_order_release);
+}
+
+/** @brief   Return @c false if the controllers must leave the motors alone.
+*/
+bool supervisor_motors_enabled (void)
+{
+    return motors_enabled.load (std::memory_order_acquire);
+}
+
+/** @brief   Return how far the supervisor has escalated.
+*/
+SupervisorState supervisor_state (void)
+{
+    return (SupervisorState)state.load ();
+}
+
+/** @brief   Return the name of a supervisor state, for reports.
+ *  @param   which The state
+*/
+const char* supervisor_state_name (SupervisorState which)
+{
+    static const char* const state_names[] = { "OK", "degraded", "safe", "reset" };
+    return state_names[which];
+}
+
+/** @brief   Put every supervised motor into the safe state.
+*/
+static void stop_motors (void)
+{
+    for (uint8_t index = 0; index < num_supervised_motors; index++)
+    {
+        if (SAFE_STATE_BRAKES)
+        {
+            supervised_motors[index]->brake ();
+        }
+        else
+        {
+            supervised_motors[index]->coast ();
+        }
+    }
+}
+
+/** @brief   Move to a new escalation state and log why.
+ *  @param   new_state The state to move to
+ *  @param   cause The stage which caused the change, or @c NUM_HEARTBEATS if none
+*/
+static void change_state (SupervisorState new_state, uint8_t cause)
+{
+    LOG_WARN (MOD_MAIN, FMT_SUP_STATE, state.load (), new_state, cause);
+    state.store (new_state);
+}
+
+/** @brief   Print the state of the supervisor and each stage's heartbeat.
+ *  @param   out The device to which the report is printed
+*/
+void supervisor_print (Print& out)
+{
+    uint32_t now = micros ();
+
+    out << "Supervisor: " << supervisor_state_name (supervisor_state ())
+        << (motors_enabled.load () ? ", motors enabled" : ", motors stopped") << endl;
+    for (uint8_t stage = 0; stage < NUM_HEARTBEATS; stage++)
+    {
+        out << stage_names[stage] << ": last beat " << (now - beat_time[stage].load ())
+            << " us ago (deadline " << deadline_us[stage] << " us), trace ID "
+            << beat_sequence[stage].load () << ", " << misses[stage] << " misses" << endl;
+    }
+}
+
+/** @brief   Task which checks the heartbeats and escalates on missed deadlines.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_SUPERVISOR (void* p_params)
+{
+    uint32_t fault_start = 0;       // When the current fault began
+    uint32_t last_miss = 0;         // When a deadline was last missed
+    bool faulted = false;           // Set from a miss until RECOVER_AFTER_US passes without one
+    bool missing = false;           // Set while the latest check found a miss
+
+    // The pipeline doesn't run until the IMU is calibrated and the motors set
+    // up; stages then get one full deadline to send their first heartbeat
+    boot_wait (BOOT_CALIBRATE);
+    boot_wait (BOOT_PWM);
+    uint32_t start = micros ();
+    for (uint8_t stage = 0; stage < NUM_HEARTBEATS; stage++)
+    {
+        beat_time[stage].store (start);
+    }
+
+    esp_task_wdt_add (NULL);
+    TickType_t last_wake = xTaskGetTickCount ();
+
+    while (true)
+    {
+        vTaskDelayUntil (&last_wake, pdMS_TO_TICKS (SUPERVISOR_PERIOD_MS));
+        task_woke (TASK_SUPERVISOR);
+        esp_task_wdt_reset ();
+
+        // Find the stage which is most overdue, if any
+        uint32_t now = micros ();
+        uint8_t cause = NUM_HEARTBEATS;
+        uint32_t worst_age = 0;
+        for (uint8_t stage = 0; stage < NUM_HEARTBEATS; stage++)
+        {
+            uint32_t age = now - beat_time[stage].load (std::memory_order_acquire);
+            if (age > deadline_us[stage] && age > worst_age)
+            {
+                cause = stage;
+                worst_age = age;
+            }
+        }
+        if (beat_sequence[HB_ACQUIRE].load () - beat_sequence[HB_CONTROL].load () > MAX_CONTROL_LAG
+            && cause == NUM_HEARTBEATS)
+        {
+            cause = HB_CONTROL;
+            worst_age = now - beat_time[HB_CONTROL].load ();
+        }
+
+        if (cause != NUM_HEARTBEATS)
+        {
+            if (!missing)
+            {
+                missing = true;
+                misses[cause]++;
+                LOG_ERROR (MOD_MAIN, FMT_SUP_MISS, cause, worst_age);
+            }
+            if (!faulted)
+            {
+                faulted = true;
+                fault_start = now;
+            }
+            last_miss = now;
+            uint32_t fault_time = now - fault_start;
+
+            if (state.load () == SUP_OK)
+            {
+                change_state (SUP_DEGRADED, cause);
+                blackbox_trigger (BB_FAULT);
+            }
+            if (fault_time > SAFE_AFTER_US && state.load () == SUP_DEGRADED)
+            {
+                motors_enabled.store (false, std::memory_order_release);
+                change_state (SUP_SAFE, cause);
+            }
+            if (fault_time > RESET_AFTER_US && state.load () == SUP_SAFE)
+            {
+                change_state (SUP_RESET, cause);
+                stop_motors ();
+                reset_stage = cause;
+                reset_age_us = worst_age;
+                reset_magic = RESET_MAGIC;
+                blackbox_flush (BLACKBOX_FLUSH_MS);
+                vTaskDelay (pdMS_TO_TICKS (50));    // Give the log task a moment to print
+                esp_restart ();
+            }
+        }
+        else
+        {
+            missing = false;
+            if (faulted && now - last_miss > RECOVER_AFTER_US)
+            {
+                faulted = false;
+                if (state.load () != SUP_OK)
+                {
+                    change_state (SUP_OK, NUM_HEARTBEATS);
+                    motors_enabled.store (true, std::memory_order_release);
+                }
+            }
+        }
+
+        // Keep asserting the safe state, in case a controller wrote the motors
+        // between its check of motors_enabled and the supervisor clearing it
+        if (!motors_enabled.load ())
+        {
+            stop_motors ();
+        }
+    }
+}
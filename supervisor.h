@@ -0,0 +1,45 @@
+/** @file supervisor.h
+ * This is the header file for the supervisor, which watches the heartbeats
+ * of the acquisition, fusion and control stages and puts the gimbal into a
+ * safe state if any of them misses its deadline.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _SUPERVISOR_
+#define _SUPERVISOR_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "motor_obj.h"
+
+/// Stages of the pipeline which send heartbeats
+enum HeartbeatStage
+{
+    HB_ACQUIRE,             ///< IMU acquisition
+    HB_FUSE,                ///< Angle estimation
+    HB_CONTROL,             ///< Control and actuation
+    NUM_HEARTBEATS
+};
+
+/// How far the supervisor has escalated
+enum SupervisorState
+{
+    SUP_OK,                 ///< Every stage is meeting its deadline
+    SUP_DEGRADED,           ///< A deadline was missed; control continues but the fault is logged
+    SUP_SAFE,               ///< Misses persisted, so the motors are held in the safe state
+    SUP_RESET               ///< Misses persisted in the safe state; the ESP32 is restarting
+};
+
+void supervisor_begin (Motor* const* motors, uint8_t num_motors);
+void supervisor_heartbeat (HeartbeatStage stage, uint32_t sequence);
+bool supervisor_motors_enabled (void);
+SupervisorState supervisor_state (void);
+const char* supervisor_state_name (SupervisorState state);
+void supervisor_print (Print& out);
+void task_SUPERVISOR (void* p_params);
+
+#endif
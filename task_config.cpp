@@ -0,0 +1,121 @@
+/** @file task_config.cpp
+ * This file creates the tasks listed in the task table, using statically
+ * allocated stacks and control blocks, and reports how much of each stack
+ * has ever been used.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <esp_heap_caps.h>
+#include "task_config.h"
+
+/// Everything needed to create one task
+struct TaskSpec
+{
+    TaskFunction_t function;    ///< The function which runs the task
+    const char* name;           ///< Task name shown in FreeRTOS listings
+    uint32_t stack_size;        ///< Stack size in bytes
+    UBaseType_t priority;       ///< FreeRTOS priority, higher numbers run first
+    BaseType_t core;            ///< Core the task is pinned to
+    StackType_t* stack;         ///< Statically allocated stack
+    StaticTask_t* tcb;          ///< Statically allocated task control block
+};
+
+// One stack and one control block for each task in the table
+#define TASK_STORAGE(id, function, name, stack, priority, core) \
+    static StackType_t id##_stack[stack]; \
+    static StaticTask_t id##_tcb;
+TASK_TABLE (TASK_STORAGE)
+#undef TASK_STORAGE
+
+static const TaskSpec task_specs[NUM_TASKS] =
+{
+#define TASK_SPEC(id, function, name, stack, priority, core) \
+    { function, name, stack, priority, core, id##_stack, &id##_tcb },
+    TASK_TABLE (TASK_SPEC)
+#undef TASK_SPEC
+};
+
+static TaskHandle_t task_handles[NUM_TASKS];    ///< Handles of the tasks once started
+static volatile uint32_t wake_counts[NUM_TASKS]; ///< Times each task has woken up
+
+
+/** @brief   Start one task from the task table.
+ *  @param   id The task to be started
+ *  @returns @c true if the task is running, @c false if it could not be created
+*/
+bool task_start (TaskId id)
+{
+    if (task_handles[id] == NULL)
+    {
+        const TaskSpec& spec = task_specs[id];
+        task_handles[id] = xTaskCreateStaticPinnedToCore (spec.function, spec.name, spec.stack_size,
+                                                          NULL, spec.priority, spec.stack, spec.tcb,
+                                                          spec.core);
+    }
+    return task_handles[id] != NULL;
+}
+
+/** @brief   Start every task in the task table which isn't running yet, in table order.
+*/
+void tasks_start (void)
+{
+    for (uint8_t id = 0; id < NUM_TASKS; id++)
+    {
+        task_start ((TaskId)id);
+    }
+}
+
+/** @brief   Return the handle of a task, or NULL if it hasn't been started.
+ *  @param   id The task whose handle is wanted
+*/
+TaskHandle_t task_handle (TaskId id)
+{
+    return task_handles[id];
+}
+
+/** @brief   Count one wake-up of a task.
+ *  @details Each task calls this once per pass through its loop. FreeRTOS keeps
+ *           no count of context switches, so the profiler reports these counts
+ *           as the number of times each of our tasks was switched in.
+ *  @param   id The task which woke up
+*/
+void task_woke (TaskId id)
+{
+    wake_counts[id]++;
+}
+
+/** @brief   Return how many times a task has woken up since it started.
+ *  @param   id The task whose count is wanted
+*/
+uint32_t task_wake_count (TaskId id)
+{
+    return wake_counts[id];
+}
+
+/** @brief   Print the stack high-water mark of every task and the state of the heap.
+ *  @details The high-water mark is the least free stack a task has ever had, so a
+ *           small number here is a stack overflow waiting to happen.
+ *  @param   out The device to which the report is printed
+*/
+void task_report_memory (Print& out)
+{
+    for (uint8_t id = 0; id < NUM_TASKS; id++)
+    {
+        out << task_specs[id].name << ": ";
+        if (task_handles[id] == NULL)
+        {
+            out << "not started" << endl;
+        }
+        else
+        {
+            out << uxTaskGetStackHighWaterMark (task_handles[id]) << " of "
+                << task_specs[id].stack_size << " bytes of stack never used" << endl;
+        }
+    }
+    out << "Heap free: " << esp_get_free_heap_size () << " bytes, minimum ever free: "
+        << esp_get_minimum_free_heap_size () << " bytes, largest block: "
+        << heap_caps_get_largest_free_block (MALLOC_CAP_8BIT) << " bytes" << endl;
+}
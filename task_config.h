@@ -0,0 +1,78 @@
+/** @file task_config.h
+ * This file holds the task table used by the gimbal project: which core
+ * each task is pinned to, its priority and its stack size.
+ * 
+ * The ESP32 has two cores. The WiFi stack, lwIP and the web server live on
+ * core 0 (PRO), so the acquisition, estimation and control chain is pinned to
+ * core 1 (APP) where WiFi interrupt storms can't preempt it.
+ * 
+ * Every task's stack and control block are allocated statically from this
+ * table, so the memory used by tasks is fixed at link time and never comes
+ * from the heap.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _TASK_CONFIG_
+#define _TASK_CONFIG_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+const BaseType_t NETWORK_CORE = 0; ///< PRO core: WiFi, web server, logging and telemetry
+const BaseType_t CONTROL_CORE = 1; ///< APP core: acquisition, estimation and control
+
+const TickType_t IMU_PERIOD = pdMS_TO_TICKS (10); ///< Time between IMU samples
+
+/// Number of control cycles per second
+const uint16_t CONTROL_RATE_HZ = 1000 / (IMU_PERIOD * portTICK_PERIOD_MS);
+
+/** @brief   The table of all tasks.
+ *  @details Each line gives an ID, the task function, its name, its stack size
+ *           in bytes, its priority and its core. Tasks are started in the order
+ *           listed; each pipeline stage notifies the next, so later stages are
+ *           listed first and their handles exist before anything notifies them.
+ *           Tasks on the control core which write a @c Mailbox must have a
+ *           higher priority than the tasks on that core which read it, so a
+ *           reader can never preempt a half-finished write.
+*/
+#define TASK_TABLE(X) \
+    X (TASK_LOG,    task_LOG,      "Logging",            3072, 1, NETWORK_CORE) \
+    X (TASK_BLACKBOX, task_BLACKBOX, "Black box",        4096, 1, NETWORK_CORE) \
+    X (TASK_FLASH_LOG, task_FLASH_LOG, "Flash log",      4096, 1, NETWORK_CORE) \
+    X (TASK_GYRO_LOG, task_GYRO_LOG, "Gyro log",         4096, 1, NETWORK_CORE) \
+    X (TASK_FRAME_SYNC, task_FRAME_SYNC, "Frame sync",   2048, 2, NETWORK_CORE) \
+    X (TASK_SUPERVISOR, task_SUPERVISOR, "Supervisor",   2048, 7, CONTROL_CORE) \
+    X (TASK_PITCH,  task_PITCH,    "Testing Pitch Axis", 2048, 4, CONTROL_CORE) \
+    X (TASK_FUSE,   task_FUSE,     "Fusing",             2048, 5, CONTROL_CORE) \
+    X (TASK_IMU,    task_read_IMU, "Reading",            2048, 6, CONTROL_CORE) \
+    X (TASK_WIFI,   task_WIFI,     "WiFi link",          3072, 1, NETWORK_CORE) \
+    X (TASK_SERVER, task_SERVER,   "Web server",         3072, 1, NETWORK_CORE) \
+    X (TASK_STREAM, task_STREAM,   "Streaming",          4096, 2, NETWORK_CORE) \
+    X (TASK_UDP,    task_UDP,      "UDP link",           3072, 3, NETWORK_CORE) \
+    X (TASK_CMD,    task_SERIAL_CMD, "Commands",         3072, 1, NETWORK_CORE)
+
+/// Identifiers of the tasks in @c TASK_TABLE
+enum TaskId
+{
+#define TASK_ID(id, function, name, stack, priority, core) id,
+    TASK_TABLE (TASK_ID)
+#undef TASK_ID
+    NUM_TASKS
+};
+
+// The task functions themselves live in the files which own each task
+#define TASK_FUNCTION(id, function, name, stack, priority, core) void function (void* p_params);
+TASK_TABLE (TASK_FUNCTION)
+#undef TASK_FUNCTION
+
+bool task_start (TaskId id);
+void tasks_start (void);
+TaskHandle_t task_handle (TaskId id);
+void task_woke (TaskId id);
+uint32_t task_wake_count (TaskId id);
+void task_report_memory (Print& out);
+
+#endif
@@ -0,0 +1,186 @@
+/** @file telemetry.cpp
+ * This is the implementation file for the telemetry recorder. The control
+ * task is the only writer. It fills the slot after the newest one and then
+ * publishes the new count, so it never waits for a reader. Readers copy a
+ * record out and then check that the writer hasn't come round the ring and
+ * started overwriting it in the meantime.
+ * 
+ * @c micros() wraps about every 71 minutes, so time windows are looked up
+ * by a time in milliseconds kept beside each record. It is worked out from
+ * the 64-bit system timer when the record is stored, and matches @c millis().
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include <esp_timer.h>
+#include "telemetry.h"
+
+static TelemetryRecord ring[TELEMETRY_RING_SIZE];   ///< The records, oldest overwritten first
+static uint32_t ring_ms[TELEMETRY_RING_SIZE];       ///< When each record was sampled, in milliseconds since boot
+static std::atomic<uint32_t> written (0);           ///< Number of records ever written
+
+
+/** @brief   Add a record to the ring, overwriting the oldest if it is full.
+ *  @details Only the control task may call this function.
+ *  @param   record The record to be added
+*/
+void telemetry_record (const TelemetryRecord& record)
+{
+    uint32_t index = written.load (std::memory_order_relaxed);
+    ring[index % TELEMETRY_RING_SIZE] = record;
+
+    // The sample was taken less than one wrap of micros() ago, so the full
+    // time is the 64-bit timer now less the 32-bit age of the sample
+    int64_t now_us = esp_timer_get_time ();
+    ring_ms[index % TELEMETRY_RING_SIZE] = (now_us - (uint32_t)((uint32_t)now_us - record.time_us)) / 1000;
+    written.store (index + 1, std::memory_order_release);
+}
+
+/** @brief   Return the number of records written since boot.
+ *  @details This is one more than the index of the newest record.
+*/
+uint32_t telemetry_count (void)
+{
+    return written.load (std::memory_order_acquire);
+}
+
+/** @brief   Return the index of the oldest record still in the ring.
+*/
+uint32_t telemetry_oldest (void)
+{
+    uint32_t count = telemetry_count ();
+    return count > TELEMETRY_RING_SIZE ? count - TELEMETRY_RING_SIZE : 0;
+}
+
+/** @brief   Copy a record and its time in milliseconds out of the ring.
+ *  @param   index Index of the record, counted from the first record since boot
+ *  @param   record A reference to where the record is copied
+ *  @param   time_ms Where the time it was sampled, in milliseconds since boot, is put
+ *  @returns @c true if the record was copied, @c false if it hasn't been
+ *           written yet or has already been overwritten
+*/
+static bool get_record (uint32_t index, TelemetryRecord& record, uint32_t& time_ms)
+{
+    uint32_t count = telemetry_count ();
+    if (index >= count || count - index > TELEMETRY_RING_SIZE)
+    {
+        return false;
+    }
+
+    record = ring[index % TELEMETRY_RING_SIZE];
+    time_ms = ring_ms[index % TELEMETRY_RING_SIZE];
+
+    // The slot is reused when record index + TELEMETRY_RING_SIZE is written
+    std::atomic_thread_fence (std::memory_order_acquire);
+    return written.load (std::memory_order_relaxed) - index < TELEMETRY_RING_SIZE;
+}
+
+/** @brief   Copy a record out of the ring.
+ *  @param   index Index of the record, counted from the first record since boot
+ *  @param   record A reference to where the record is copied
+ *  @returns @c true if the record was copied, @c false if it hasn't been
+ *           written yet or has already been overwritten
+*/
+bool telemetry_get (uint32_t index, TelemetryRecord& record)
+{
+    uint32_t time_ms;
+    return get_record (index, record, time_ms);
+}
+
+/** @brief   Find the first record sampled at or after a given time.
+ *  @details Records are in time order, so this is a binary search.
+ *  @param   time_ms The time in milliseconds since boot
+ *  @returns The index of the record, or @c telemetry_count() if there is none
+*/
+uint32_t telemetry_find (uint32_t time_ms)
+{
+    uint32_t low = telemetry_oldest ();
+    uint32_t high = telemetry_count ();
+    TelemetryRecord record;
+    uint32_t record_ms;
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+        // A record overwritten during the search is older than any still there
+        if (!get_record (middle, record, record_ms) || record_ms < time_ms)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/** @brief   Start a CSV export of the records in a time window.
+ *  @param   cursor The cursor which keeps track of the export
+ *  @param   from_ms Records sampled before this time, in milliseconds since boot, are skipped
+ *  @param   to_ms Records sampled after this time are skipped
+ *  @param   points Most records to write, or zero to write them all; see @c downsample.h
+ *  @param   method How records are chosen when there are more than @c points
+ *  @param   field The value which is looked at to choose records
+*/
+void telemetry_csv_begin (TelemetryCsvCursor& cursor, uint32_t from_ms, uint32_t to_ms, uint16_t points,
+                          DownsampleMethod method, TelemetryField field)
+{
+    uint32_t first = telemetry_find (from_ms);
+    uint32_t end = (to_ms == UINT32_MAX) ? telemetry_count () : telemetry_find (to_ms + 1);
+    downsample_begin (cursor.records, first, end, points, method, field);
+    cursor.from_ms = from_ms;
+    cursor.to_ms = to_ms;
+    cursor.header_done = false;
+}
+
+/** @brief   Write as many CSV lines as fit, straight out of the ring.
+ *  @details Records which are overwritten while the export is under way are
+ *           skipped; records added after it began are left out. When the
+ *           export is downsampled, the work of choosing the records is done
+ *           here too, a bucket at a time.
+ *  @param   cursor The cursor from @c telemetry_csv_begin()
+ *  @param   out The buffer into which lines are written
+ *  @returns @c true if there is more to write, @c false once the export is done
+*/
+bool telemetry_csv_chunk (TelemetryCsvCursor& cursor, BufferPrint& out)
+{
+    const size_t LINE_MAX = 96;
+    char line[LINE_MAX];
+
+    if (!cursor.header_done)
+    {
+        out << "time_ms,sequence,angle_deg,rate_dps,setpoint_deg,error_deg,effort,flags\n";
+        cursor.header_done = true;
+    }
+
+    TelemetryRecord record;
+    uint32_t time_ms;
+    uint32_t index;
+    while (out.room () >= LINE_MAX)
+    {
+        if (!downsample_next (cursor.records, index))
+        {
+            return false;
+        }
+        if (!get_record (index, record, time_ms))
+        {
+            continue;
+        }
+        if (time_ms < cursor.from_ms || time_ms > cursor.to_ms)
+        {
+            continue;
+        }
+
+        // The microseconds past the millisecond survive the wrap of both clocks
+        uint32_t micro = record.time_us - time_ms * 1000;
+        snprintf (line, sizeof (line), "%u.%03u,%u,%d,%.2f,%d,%d,%d,%u\n",
+                  (unsigned)time_ms, (unsigned)micro, (unsigned)record.sequence, record.angle,
+                  record.rate / 131.0, record.setpoint, record.error, record.effort,
+                  (unsigned)record.flags);
+        out.print (line);
+    }
+    return true;
+}
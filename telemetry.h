@@ -0,0 +1,62 @@
+/** @file telemetry.h
+ * This is the header file for the telemetry recorder, which keeps the most
+ * recent control cycles of the pitch axis in a fixed-size ring in RAM so
+ * that real step responses can be pulled off the gimbal for tuning.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _TELEMETRY_
+#define _TELEMETRY_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "buffer_print.h"
+#include "downsample.h"
+
+/// Number of records kept; at the 100 Hz control rate this is about 20 seconds
+const uint32_t TELEMETRY_RING_SIZE = 2048;
+
+const uint8_t TELEM_BRAKE = 0x01;       ///< Flag: the controller asked for the brake
+const uint8_t TELEM_HELD = 0x02;        ///< Flag: the supervisor was holding the motors
+const uint8_t TELEM_IDLE = 0x04;        ///< Flag: the motor was braked by the mode or a calibration
+const uint8_t TELEM_STEP = 0x08;        ///< Flag: a setpoint step response was being measured
+const uint8_t TELEM_SATURATED = 0x10;   ///< Flag: the motor effort was at its limit
+
+/** @brief Record of one control cycle
+*/
+struct TelemetryRecord
+{
+    uint32_t time_us;       ///< Time at which the IMU was sampled, from @c micros()
+    uint32_t sequence;      ///< Trace ID of the sample
+    int16_t angle;          ///< Measured pitch angle in degrees
+    int16_t rate;           ///< Raw pitch rate from the gyroscope, 131 counts per degree per second
+    int16_t setpoint;       ///< Desired pitch angle in degrees
+    int16_t error;          ///< Control error in degrees
+    int16_t effort;         ///< Motor effort: channel 1 duty minus channel 2 duty
+    uint8_t flags;          ///< The @c TELEM_ flags
+};
+
+/** @brief Position in a CSV export of the telemetry ring, so it can be sent a piece at a time
+*/
+struct TelemetryCsvCursor
+{
+    DownsampleCursor records;   ///< Chooses which records in the window are written
+    uint32_t from_ms;       ///< Records sampled before this time are skipped
+    uint32_t to_ms;         ///< Records sampled after this time are skipped
+    bool header_done;       ///< @c true once the column headers have been written
+};
+
+void telemetry_record (const TelemetryRecord& record);
+uint32_t telemetry_count (void);
+uint32_t telemetry_oldest (void);
+bool telemetry_get (uint32_t index, TelemetryRecord& record);
+uint32_t telemetry_find (uint32_t time_ms);
+void telemetry_csv_begin (TelemetryCsvCursor& cursor, uint32_t from_ms, uint32_t to_ms, uint16_t points = 0,
+                          DownsampleMethod method = DS_ALL, TelemetryField field = FIELD_ANGLE);
+bool telemetry_csv_chunk (TelemetryCsvCursor& cursor, BufferPrint& out);
+
+#endif
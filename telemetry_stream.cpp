@@ -0,0 +1,287 @@
+/** @file telemetry_stream.cpp
+ * This is the implementation file for live telemetry streaming. The
+ * WebSocket is served by the async web server at @c /ws. Every
+ * @c STREAM_PERIOD_MS the streaming task reads the records each client
+ * hasn't seen from the telemetry ring and sends them as one frame.
+ * 
+ * A client whose send queue is full gets no new frame; the records it misses
+ * are counted as dropped and it carries on from the newest record. A slow
+ * browser therefore loses records but never holds up the task or other
+ * clients.
+ * 
+ * WebSocket events arrive in the AsyncTCP task. They are passed to the
+ * streaming task through a queue, so only the streaming task ever changes
+ * the client table and neither task waits for the other. If the queue is
+ * full an event is lost and counted; a client whose disconnection was lost
+ * has its slot freed once the socket no longer knows its ID.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "telemetry_stream.h"
+#include "task_config.h"
+#include "logger.h"
+
+/// Largest frame sent: our header and a full batch
+const size_t MAX_FRAME = sizeof (StreamFrameHeader) + STREAM_MAX_BATCH * sizeof (TelemetryRecord);
+
+static_assert (sizeof (TelemetryRecord) == 20, "Telemetry record layout has changed");
+
+/** @brief Connection, disconnection or rate change, passed from the AsyncTCP task
+*/
+struct StreamEvent
+{
+    uint8_t type;           ///< @c WS_EVT_CONNECT, @c WS_EVT_DISCONNECT or @c WS_EVT_DATA
+    uint32_t id;            ///< WebSocket client ID
+    uint16_t decimation;    ///< New decimation, for @c WS_EVT_DATA
+};
+
+const uint8_t STREAM_EVENT_QUEUE = 8;       ///< Events which can wait for the streaming task
+
+/** @brief State of one streaming client
+*/
+struct StreamClient
+{
+    uint32_t id;            ///< WebSocket client ID, or zero if the slot is free
+    uint32_t cursor;        ///< Index of the next telemetry record to look at
+    uint16_t decimation;    ///< Send only records whose index is a multiple of this
+    uint32_t dropped;       ///< Records skipped because the client was too slow
+    uint32_t frames;        ///< Frames sent
+};
+
+static AsyncWebSocket socket ("/ws");                   ///< The WebSocket endpoint
+static StreamClient clients[STREAM_MAX_CLIENTS];        ///< Clients being streamed to
+static uint8_t events_storage[STREAM_EVENT_QUEUE * sizeof (StreamEvent)];   ///< Storage for the queue
+static StaticQueue_t events_queue;                      ///< The queue's control block
+static QueueHandle_t events = xQueueCreateStatic (STREAM_EVENT_QUEUE, sizeof (StreamEvent),
+                                                  events_storage, &events_queue);
+static std::atomic<uint32_t> events_lost (0);           ///< Events dropped because the queue was full
+
+
+/** @brief   Turn a requested rate into a decimation factor.
+ *  @param   rate_hz The rate in records per second asked for by the client
+*/
+static uint16_t rate_to_decimation (long rate_hz)
+{
+    if (rate_hz <= 0)
+    {
+        rate_hz = 1;
+    }
+    if (rate_hz > STREAM_MAX_RATE_HZ)
+    {
+        rate_hz = STREAM_MAX_RATE_HZ;
+    }
+    uint16_t decimation = (CONTROL_RATE_HZ + rate_hz - 1) / rate_hz;
+    return decimation < 1 ? 1 : decimation;
+}
+
+/** @brief   Find the slot of a client.
+ *  @param   id The client's ID, or zero to find a free slot
+ *  @returns The slot, or NULL if there is none
+*/
+static StreamClient* find_client (uint32_t id)
+{
+    for (uint8_t index = 0; index < STREAM_MAX_CLIENTS; index++)
+    {
+        if (clients[index].id == id)
+        {
+            return &clients[index];
+        }
+    }
+    return NULL;
+}
+
+/** @brief   Pass WebSocket connections, disconnections and rate changes to the streaming task.
+ *  @details This runs in the AsyncTCP task. It never waits; if the queue is
+ *           full the event is lost and counted. A lost rate change leaves a
+ *           client at its old rate and a lost connection leaves it unserved;
+ *           a lost disconnection is caught by @c send_batch().
+*/
+static void on_event (AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type,
+                      void* arg, uint8_t* data, size_t length)
+{
+    StreamEvent event = { (uint8_t)type, client->id (), 1 };
+    if (type == WS_EVT_DATA)
+    {
+        // Only short, whole text messages are understood
+        AwsFrameInfo* info = (AwsFrameInfo*)arg;
+        char text[32];
+        if (!info->final || info->index != 0 || info->len != length
+            || info->opcode != WS_TEXT || length >= sizeof (text))
+        {
+            return;
+        }
+        memcpy (text, data, length);
+        text[length] = '\0';
+        const char* rate = strstr (text, "rate=");
+        if (rate == NULL)
+        {
+            return;
+        }
+        event.decimation = rate_to_decimation (atol (rate + 5));
+    }
+    else if (type != WS_EVT_CONNECT && type != WS_EVT_DISCONNECT)
+    {
+        return;
+    }
+    if (xQueueSend (events, &event, 0) != pdTRUE)
+    {
+        events_lost.fetch_add (1, std::memory_order_relaxed);
+    }
+}
+
+/** @brief   Apply one event from the AsyncTCP task to the client table.
+ *  @param   event The event
+*/
+static void apply_event (const StreamEvent& event)
+{
+    if (event.type == WS_EVT_CONNECT)
+    {
+        StreamClient* sc = find_client (0);
+        if (sc)
+        {
+            sc->id = event.id;
+            sc->cursor = telemetry_count ();
+            sc->decimation = 1;
+            sc->dropped = 0;
+            sc->frames = 0;
+        }
+    }
+    else
+    {
+        StreamClient* sc = find_client (event.id);
+        if (sc && event.type == WS_EVT_DISCONNECT)
+        {
+            sc->id = 0;
+        }
+        else if (sc)
+        {
+            sc->decimation = event.decimation;
+        }
+    }
+}
+
+/** @brief   Send a client a frame of the records it hasn't seen yet.
+ *  @details If the client's send queue is full, nothing is sent; the records
+ *           it misses are counted as dropped. If the socket no longer knows
+ *           the client, its disconnection was lost and the slot is freed.
+ *  @param   sc The client to which the frame is sent
+*/
+static void send_batch (StreamClient& sc)
+{
+    static uint8_t frame[MAX_FRAME];
+    uint32_t newest = telemetry_count ();
+
+    AsyncWebSocketClient* client = socket.client (sc.id);
+    if (client == NULL)
+    {
+        sc.id = 0;
+        return;
+    }
+    if (!client->canSend ())
+    {
+        if (newest > sc.cursor)
+        {
+            sc.dropped += (newest - sc.cursor) / sc.decimation;
+            sc.cursor = newest;
+        }
+        return;
+    }
+
+    // A client too far behind skips ahead to the newest records
+    uint32_t behind = (newest - sc.cursor) / sc.decimation;
+    if (behind > STREAM_MAX_BATCH)
+    {
+        sc.dropped += behind - STREAM_MAX_BATCH;
+        sc.cursor = newest - STREAM_MAX_BATCH * sc.decimation;
+    }
+
+    StreamFrameHeader header;
+    uint8_t* records = frame + sizeof (header);
+    uint8_t count = 0;
+    TelemetryRecord record;
+    for ( ; sc.cursor < newest && count < STREAM_MAX_BATCH; sc.cursor++)
+    {
+        if (sc.cursor % sc.decimation == 0 && telemetry_get (sc.cursor, record))
+        {
+            memcpy (records + count * sizeof (record), &record, sizeof (record));
+            count++;
+        }
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    header.version = STREAM_VERSION;
+    header.count = count;
+    header.decimation = sc.decimation;
+    header.dropped = sc.dropped;
+    memcpy (frame, &header, sizeof (header));
+
+    client->binary (frame, sizeof (header) + count * sizeof (TelemetryRecord));
+    sc.frames++;
+}
+
+/** @brief   Add the WebSocket endpoint to the web server.
+ *  @param   server The web server which serves @c /ws
+*/
+void stream_attach (AsyncWebServer& server)
+{
+    socket.onEvent (on_event);
+    server.addHandler (&socket);
+}
+
+/** @brief   Print the state of each streaming client.
+ *  @param   out The device to which the report is printed
+*/
+void stream_print (Print& out)
+{
+    uint8_t open = 0;
+    for (uint8_t index = 0; index < STREAM_MAX_CLIENTS; index++)
+    {
+        const StreamClient& sc = clients[index];
+        if (sc.id != 0)
+        {
+            open++;
+            out << "Stream client " << sc.id << ": " << CONTROL_RATE_HZ / sc.decimation << " Hz, "
+                << sc.frames << " frames sent, " << sc.dropped << " records dropped" << endl;
+        }
+    }
+    if (open == 0)
+    {
+        out << "No stream clients; connect to ws://<address>/ws and send rate=<Hz>" << endl;
+    }
+    out << "Stream events lost: " << events_lost.load () << endl;
+}
+
+/** @brief   Task which streams telemetry to the WebSocket clients.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_STREAM (void* p_params)
+{
+    TickType_t last_wake = xTaskGetTickCount ();
+    while (true)
+    {
+        vTaskDelayUntil (&last_wake, pdMS_TO_TICKS (STREAM_PERIOD_MS));
+        task_woke (TASK_STREAM);
+
+        StreamEvent event;
+        while (xQueueReceive (events, &event, 0) == pdTRUE)
+        {
+            apply_event (event);
+        }
+
+        for (uint8_t index = 0; index < STREAM_MAX_CLIENTS; index++)
+        {
+            if (clients[index].id != 0)
+            {
+                send_batch (clients[index]);
+            }
+        }
+        socket.cleanupClients (STREAM_MAX_CLIENTS);
+    }
+}
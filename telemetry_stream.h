@@ -0,0 +1,45 @@
+/** @file telemetry_stream.h
+ * This is the header file for live telemetry streaming. Browsers connect by
+ * WebSocket and are pushed batches of telemetry records in binary frames,
+ * so plots can be drawn live during tuning without a serial cable.
+ * 
+ * Each binary message is a @c StreamFrameHeader followed by @c count
+ * @c TelemetryRecord structures, 20 bytes each, little-endian with one byte
+ * of padding at the end. A client connects to @c ws://gimbal/ws and picks
+ * its rate by sending the text message @c rate=50.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _TELEMETRY_STREAM_
+#define _TELEMETRY_STREAM_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#include <ESPAsyncWebServer.h>
+
+#include "telemetry.h"
+
+const uint8_t STREAM_MAX_CLIENTS = 4;       ///< Most clients streamed to at once
+const uint16_t STREAM_MAX_RATE_HZ = 200;    ///< Highest record rate a client may ask for
+const uint32_t STREAM_PERIOD_MS = 20;       ///< Time between batches sent to each client
+const uint8_t STREAM_MAX_BATCH = 16;        ///< Most records in one batch; a client further behind skips ahead
+const uint8_t STREAM_VERSION = 1;           ///< Version of the frame layout
+
+/** @brief Header at the start of every binary telemetry message
+*/
+struct StreamFrameHeader
+{
+    uint8_t version;        ///< @c STREAM_VERSION
+    uint8_t count;          ///< Number of records after the header
+    uint16_t decimation;    ///< Only every this many control cycles is sent
+    uint32_t dropped;       ///< Records this client has missed because it was too slow
+};
+
+void stream_attach (AsyncWebServer& server);
+void stream_print (Print& out);
+void task_STREAM (void* p_params);
+
+#endif
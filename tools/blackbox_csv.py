@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Turn black-box recordings from the gimbal into CSV.
+
+Each recording is a BlackboxHeader followed by BlackboxRecord structures, as
+laid out in blackbox.h. Times in the CSV are in milliseconds from the
+trigger, so the lead-up to the problem has negative times. Recordings are
+listed at GET /api/v1/blackbox and downloaded from /api/v1/blackbox?id=N.
+
+Usage:
+    blackbox_csv.py 00012.bbx                   write CSV to standard output
+    blackbox_csv.py 00012.bbx -o run.csv        write CSV to a file
+    blackbox_csv.py --fetch 192.168.1.50 12     download recording 12 and convert it
+"""
+
+import argparse
+import struct
+import sys
+import urllib.request
+
+HEADER = struct.Struct("<4sHHHHHBBI")   # Must match BlackboxHeader in blackbox.h
+RECORD = struct.Struct("<II7h4hBB")     # Must match BlackboxRecord in blackbox.h
+VERSION = 1
+CAUSES = ["manual", "error", "fault", "watchdog"]
+STATES = ["OK", "degraded", "safe", "reset"]
+COLUMNS = ["t_ms", "sequence", "ax", "ay", "az", "temperature", "gx", "gy", "gz",
+           "pitch", "roll", "setpoint", "effort", "flags", "state"]
+
+
+def decode(data, out):
+    """Write a recording as CSV; return the header fields for the summary."""
+    if len(data) < HEADER.size:
+        raise ValueError("too short for a header")
+    magic, version, record_size, count, trigger_index, rate_hz, cause, _, trigger_ms = \
+        HEADER.unpack_from(data)
+    if magic != b"GSBB":
+        raise ValueError("not a black-box recording")
+    if version != VERSION or record_size != RECORD.size:
+        raise ValueError("recording is version %d with %d byte records; expected version %d, %d bytes"
+                         % (version, record_size, VERSION, RECORD.size))
+    if len(data) < HEADER.size + count * RECORD.size:
+        count = (len(data) - HEADER.size) // RECORD.size
+        print("warning: recording is truncated; decoding %d records" % count, file=sys.stderr)
+
+    records = [RECORD.unpack_from(data, HEADER.size + index * RECORD.size) for index in range(count)]
+    trigger_us = records[trigger_index][0] if trigger_index < count else records[-1][0]
+    out.write(",".join(COLUMNS) + "\n")
+    for record in records:
+        time_us = (record[0] - trigger_us + 2**31) % 2**32 - 2**31
+        fields = ["%.2f" % (time_us / 1000.0)] + [str(value) for value in record[1:-1]]
+        fields.append(STATES[record[-1]] if record[-1] < len(STATES) else str(record[-1]))
+        out.write(",".join(fields) + "\n")
+    return count, trigger_index, rate_hz, cause, trigger_ms
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="recording file, or the gimbal's address with --fetch")
+    parser.add_argument("id", nargs="?", type=int, help="recording number, with --fetch")
+    parser.add_argument("--fetch", action="store_true", help="download the recording from the gimbal")
+    parser.add_argument("-o", "--output", help="CSV file to write; standard output if not given")
+    args = parser.parse_args()
+
+    if args.fetch:
+        if args.id is None:
+            parser.error("--fetch needs a recording number")
+        url = "http://%s/api/v1/blackbox?id=%d" % (args.source, args.id)
+        with urllib.request.urlopen(url, timeout=10) as reply:
+            data = reply.read()
+    else:
+        with open(args.source, "rb") as source:
+            data = source.read()
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        count, trigger_index, rate_hz, cause, trigger_ms = decode(data, out)
+    except ValueError as problem:
+        sys.exit("%s: %s" % (args.source, problem))
+    finally:
+        if args.output:
+            out.close()
+    print("%d records at %d Hz, %d before the trigger; cause %s at %d ms after boot"
+          % (count, rate_hz, trigger_index, CAUSES[cause] if cause < len(CAUSES) else cause, trigger_ms),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Turn flash log segments from the gimbal into one CSV file.
+
+Each segment is a run of 4096 byte blocks, each a FlashBlockHeader followed
+by TelemetryRecord structures, as laid out in flash_log.h and telemetry.h.
+Segments are decoded in the order given, so list them oldest first; records
+the gimbal had to drop show up as jumps in the index column, and a summary
+of the gaps is printed at the end. Blocks which are incomplete or damaged
+are skipped. Segments are listed at GET /api/v1/log and downloaded from
+/api/v1/log?segment=N.
+
+Usage:
+    flash_log_csv.py 00003.tlm 00004.tlm        write CSV to standard output
+    flash_log_csv.py log/*.tlm -o shoot.csv     write CSV to a file
+    flash_log_csv.py --fetch 192.168.1.50       download every complete segment and convert them
+"""
+
+import argparse
+import json
+import struct
+import sys
+import urllib.request
+
+BLOCK_BYTES = 4096
+HEADER = struct.Struct("<4sBBHII")      # Must match FlashBlockHeader in flash_log.h
+RECORD = struct.Struct("<II5hBx")       # Must match TelemetryRecord in telemetry.h
+VERSION = 1
+COLUMNS = ["index", "t_us", "sequence", "angle", "rate", "setpoint", "error", "effort", "flags"]
+
+
+def blocks(data):
+    """Yield (first_index, decimation, dropped, records) for each good block in a segment."""
+    for offset in range(0, len(data) - BLOCK_BYTES + 1, BLOCK_BYTES):
+        magic, version, decimation, count, first_index, dropped = HEADER.unpack_from(data, offset)
+        if magic != b"GSLB" or version != VERSION \
+                or HEADER.size + count * RECORD.size > BLOCK_BYTES:
+            print("warning: skipping a damaged block", file=sys.stderr)
+            continue
+        records = [RECORD.unpack_from(data, offset + HEADER.size + n * RECORD.size) for n in range(count)]
+        yield first_index, decimation, dropped, records
+
+
+def convert(segments, out):
+    out.write(",".join(COLUMNS) + "\n")
+    total = gaps = 0
+    last_index = None
+    for data in segments:
+        for first_index, decimation, _, records in blocks(data):
+            index = first_index
+            for record in records:
+                if last_index is not None and index != last_index + decimation:
+                    gaps += 1
+                out.write("%d,%s\n" % (index, ",".join(str(value) for value in record)))
+                last_index = index
+                index += decimation
+                total += 1
+    print("%d records, %d gaps" % (total, gaps), file=sys.stderr)
+
+
+def fetch(address):
+    """Download every complete segment from the gimbal, oldest first."""
+    with urllib.request.urlopen("http://%s/api/v1/log" % address, timeout=10) as reply:
+        listing = json.load(reply)
+    segments = []
+    for segment in sorted(listing["segments"], key=lambda entry: entry["id"]):
+        if segment["open"]:
+            continue
+        url = "http://%s/api/v1/log?segment=%d" % (address, segment["id"])
+        with urllib.request.urlopen(url, timeout=30) as reply:
+            segments.append(reply.read())
+    return segments
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("sources", nargs="+", help="segment files, or the gimbal's address with --fetch")
+    parser.add_argument("--fetch", action="store_true", help="download the segments from the gimbal")
+    parser.add_argument("-o", "--output", help="CSV file to write; standard output if not given")
+    args = parser.parse_args()
+
+    if args.fetch:
+        segments = fetch(args.sources[0])
+    else:
+        segments = []
+        for name in args.sources:
+            with open(name, "rb") as source:
+                segments.append(source.read())
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        convert(segments, out)
+    finally:
+        if args.output:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Generate web_pages.h from the static files in web/.
+
+Each file is gzip-compressed and written into the header as a const byte
+array, so the pages are served straight out of flash with no heap use and
+no file system. Run this after editing anything in web/ and commit the
+regenerated header with the change; the output doesn't depend on file
+times, so it only changes when the pages do.
+
+Usage:
+    gen_web_pages.py            regenerate web_pages.h
+    gen_web_pages.py --check    exit with an error if web_pages.h is out of date
+"""
+
+import gzip
+import os
+import sys
+
+SRC_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+WEB_DIR = os.path.join(SRC_DIR, "web")
+OUTPUT = os.path.join(SRC_DIR, "web_pages.h")
+
+TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+
+def url_for(name):
+    """Return the URL a file is served at; index.html is also the root page."""
+    return "/" if name == "index.html" else "/" + name
+
+
+def symbol_for(name):
+    return "page_" + "".join(c if c.isalnum() else "_" for c in name)
+
+
+def generate():
+    lines = [
+        "/** @file web_pages.h",
+        " * This file holds the static web pages, gzip-compressed, so they can be",
+        " * served straight from flash. It is generated by tools/gen_web_pages.py",
+        " * from the files in web/; edit those and regenerate, don't edit this file.",
+        " * ",
+        " * @author agent",
+        " * @date 2026-Oct-17 ",
+        " * ",
+        "*/",
+        "",
+        "#ifndef _WEB_PAGES_",
+        "#define _WEB_PAGES_",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "/** @brief A static file served by the web server",
+        "*/",
+        "struct WebPage",
+        "{",
+        "    const char* path;       ///< URL of the file",
+        "    const char* type;       ///< MIME type of the file",
+        "    const uint8_t* data;    ///< The file, gzip-compressed",
+        "    size_t length;          ///< Length of @c data",
+        "};",
+        "",
+    ]
+
+    entries = []
+    for name in sorted(os.listdir(WEB_DIR)):
+        path = os.path.join(WEB_DIR, name)
+        extension = os.path.splitext(name)[1]
+        if not os.path.isfile(path) or extension not in TYPES:
+            continue
+        with open(path, "rb") as source:
+            raw = source.read()
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        symbol = symbol_for(name)
+        lines.append("/// %s: %d bytes, %d gzipped" % (name, len(raw), len(packed)))
+        lines.append("static const uint8_t %s[] PROGMEM =" % symbol)
+        lines.append("{")
+        for start in range(0, len(packed), 16):
+            lines.append("    " + ", ".join("0x%02X" % b for b in packed[start:start + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        entries.append('    { "%s", "%s", %s, sizeof (%s) }' % (url_for(name), TYPES[extension], symbol, symbol))
+
+    lines.append("/// Every static file, in the order they are registered")
+    lines.append("static const WebPage web_pages[] =")
+    lines.append("{")
+    lines.append(",\n".join(entries))
+    lines.append("};")
+    lines.append("")
+    lines.append("const size_t NUM_WEB_PAGES = sizeof (web_pages) / sizeof (web_pages[0]);")
+    lines.append("")
+    lines.append("#endif")
+    lines.append("")
+    # The C++ sources in this tree use CRLF line ends
+    return "\n".join(lines).replace("\n", "\r\n").encode()
+
+
+def main():
+    text = generate()
+    if "--check" in sys.argv[1:]:
+        with open(OUTPUT, "rb") as current:
+            if current.read() != text:
+                sys.exit("web_pages.h is out of date; run tools/gen_web_pages.py")
+        return
+    with open(OUTPUT, "wb") as output:
+        output.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""Convert gyro log takes from the gimbal into Gyroflow's GCSV format.
+
+A take is a GyroLogHeader followed by GyroSample structures, as laid out in
+gyro_log.h: the gyroscope with its bias taken off and the raw accelerometer,
+each stamped with the gimbal's microsecond clock. The GCSV file keeps the raw
+counts and gives Gyroflow the scales to turn them into rad/s and g. Camera
+frame sync edges recorded during the take are mixed in with the samples as
+GyroEdge records; they are left out of the GCSV and read by sync_align.py.
+
+Gyroflow also needs the orientation of the IMU relative to the camera, as
+three letters giving the IMU axis which lies along each of the camera's X,
+Y and Z axes; a lower-case letter means the axis points the other way. It
+depends on how the board is mounted, so check it once in Gyroflow with a
+test clip and pass the same value for every take.
+
+Times are written relative to the first sample. If the gimbal's time of the
+first video frame is known, pass it with --start-us and times are written
+relative to that instead; with the camera's frame sync output wired to the
+gimbal, sync_align.py works it out from the take itself.
+
+Usage:
+    gyroflow_export.py 00002.gyr                          write 00002.gcsv
+    gyroflow_export.py 00002.gyr --orientation yXZ        set the IMU orientation
+    gyroflow_export.py --fetch 192.168.1.50 2 -o clip.gcsv
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+import urllib.request
+
+HEADER = struct.Struct("<4sBBHHHI")     # Must match GyroLogHeader in gyro_log.h
+SAMPLE = struct.Struct("<I3h3h")        # Must match GyroSample in gyro_log.h
+EDGE = struct.Struct("<Ih6xI")          # Must match GyroEdge in gyro_log.h
+EDGE_MARK = -32768                      # GYRO_EDGE_MARK: gyroscope X of an edge record
+VERSIONS = (1, 2)                       # Version 1 takes have no edges
+
+
+def read_take(data):
+    """Return the header fields, the list of samples and the (number, time_us) edges in a take."""
+    if len(data) < HEADER.size:
+        raise ValueError("too short for a header")
+    magic, version, sample_size, rate_hz, gyro_lsb, acc_lsb, start_ms = HEADER.unpack_from(data)
+    if magic != b"GSGY":
+        raise ValueError("not a gyro log take")
+    if version not in VERSIONS or sample_size != SAMPLE.size:
+        raise ValueError("take is version %d with %d byte samples; expected version %d, %d bytes"
+                         % (version, sample_size, VERSIONS[-1], SAMPLE.size))
+    samples = []
+    edges = []
+    for offset in range(HEADER.size, len(data) - SAMPLE.size + 1, SAMPLE.size):
+        record = SAMPLE.unpack_from(data, offset)
+        if version >= 2 and record[1] == EDGE_MARK:
+            time_us, _, number = EDGE.unpack_from(data, offset)
+            edges.append((number, time_us))
+        else:
+            samples.append(record)
+    return rate_hz, gyro_lsb, acc_lsb, start_ms, samples, edges
+
+
+def write_gcsv(out, samples, gyro_lsb, acc_lsb, args):
+    """Write the samples as GCSV; return the number of gaps in the timestamps."""
+    out.write("GYROFLOW IMU LOG\n")
+    out.write("version,1.3\n")
+    out.write("id,%s\n" % args.id)
+    out.write("orientation,%s\n" % args.orientation)
+    if args.note:
+        out.write("note,%s\n" % args.note)
+    if args.video:
+        out.write("videofilename,%s\n" % args.video)
+    out.write("tscale,0.000001\n")
+    out.write("gscale,%.10g\n" % (math.pi / 180.0 / gyro_lsb))
+    out.write("ascale,%.10g\n" % (1.0 / acc_lsb))
+    out.write("t,gx,gy,gz,ax,ay,az\n")
+
+    start_us = samples[0][0] if args.start_us is None else args.start_us
+    elapsed = 0
+    previous = samples[0][0]
+    gaps = 0
+    period = None
+    for time_us, gx, gy, gz, ax, ay, az in samples:
+        # The gimbal's clock wraps every 71 minutes; count time up from the start
+        step = (time_us - previous) % 2**32
+        if period is not None and step > 1.5 * period:
+            gaps += 1
+        if step > 0 and (period is None or step < period):
+            period = step
+        elapsed += step
+        previous = time_us
+        t = elapsed + (samples[0][0] - start_us + 2**31) % 2**32 - 2**31
+        out.write("%d,%d,%d,%d,%d,%d,%d\n" % (t, gx, gy, gz, ax, ay, az))
+    return gaps
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="take file, or the gimbal's address with --fetch")
+    parser.add_argument("take", nargs="?", type=int, help="take number, with --fetch")
+    parser.add_argument("--fetch", action="store_true", help="download the take from the gimbal")
+    parser.add_argument("-o", "--output", help="GCSV file to write; the take's name with .gcsv if not given")
+    parser.add_argument("--orientation", default="XYZ", help="IMU axes along the camera's X, Y and Z (default XYZ)")
+    parser.add_argument("--id", default="me507_gimbal", help="logger name written in the header")
+    parser.add_argument("--note", help="note written in the header")
+    parser.add_argument("--video", help="name of the video file the log belongs to")
+    parser.add_argument("--start-us", type=int, help="gimbal time of the first video frame, in microseconds")
+    args = parser.parse_args()
+
+    if len(args.orientation) != 3 or sorted(args.orientation.upper()) != ["X", "Y", "Z"]:
+        parser.error("--orientation needs each of X, Y and Z once, e.g. XYZ or yXz")
+
+    if args.fetch:
+        if args.take is None:
+            parser.error("--fetch needs a take number")
+        url = "http://%s/api/v1/gyro?take=%d" % (args.source, args.take)
+        with urllib.request.urlopen(url, timeout=30) as reply:
+            data = reply.read()
+        output = args.output or "take%05d.gcsv" % args.take
+    else:
+        with open(args.source, "rb") as source:
+            data = source.read()
+        output = args.output or os.path.splitext(args.source)[0] + ".gcsv"
+
+    try:
+        rate_hz, gyro_lsb, acc_lsb, start_ms, samples, edges = read_take(data)
+    except ValueError as problem:
+        sys.exit("%s: %s" % (args.source, problem))
+    if not samples:
+        sys.exit("%s: take has no samples" % args.source)
+
+    with open(output, "w") as out:
+        gaps = write_gcsv(out, samples, gyro_lsb, acc_lsb, args)
+    seconds = ((samples[-1][0] - samples[0][0]) % 2**32) / 1e6
+    print("%s: %d samples over %.1f s at %d Hz nominal, %d gaps; take began %d ms after boot"
+          % (output, len(samples), seconds, rate_hz, gaps, start_ms), file=sys.stderr)
+    if edges:
+        print("%d frame sync edges in the take; give the take to sync_align.py to find --start-us"
+              % len(edges), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
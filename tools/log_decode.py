@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Decode binary log frames from firmware built with LOG_DEFERRED_FORMAT.
+
+The firmware sends each log record as the two sync bytes 0xA5 0x5A, the raw
+LogRecord structure and an 8-bit checksum. The format strings are not in the
+firmware; they are read here from log_formats.h, and module names from the
+LogModule enum in logger.h, so this script must be run against the same
+source tree the firmware was built from.
+
+Anything between frames (boot messages, panics) is passed through as text.
+
+Usage:
+    log_decode.py capture.bin            decode a saved capture
+    log_decode.py /dev/ttyUSB0           decode live from a serial port (needs pyserial)
+    some_command | log_decode.py -       decode standard input
+"""
+
+import os
+import re
+import struct
+import sys
+
+SRC_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+SYNC = b"\xa5\x5a"
+RECORD = struct.Struct("<IHBB4i")   # Must match LogRecord in logger.h
+LEVELS = "-EWIDT"
+
+
+def load_formats():
+    """Return the list of format strings from log_formats.h, indexed by ID."""
+    with open(os.path.join(SRC_DIR, "log_formats.h")) as header:
+        text = header.read()
+    entries = re.findall(r'X \((\w+),\s*"((?:[^"\\]|\\.)*)"\)', text)
+    # Drop C length modifiers, which Python's % operator doesn't understand
+    return [re.sub(r"%([-+ #0]*\d*)(?:hh|h|ll|l|z|j|t)?([diouxXc])", r"%\1\2", fmt)
+            for _, fmt in entries]
+
+
+def load_modules():
+    """Return the module names from the LogModule enum in logger.h."""
+    with open(os.path.join(SRC_DIR, "logger.h")) as header:
+        text = header.read()
+    body = re.search(r"enum LogModule\s*\{(.*?)\}", text, re.S).group(1)
+    return [name.lower() for name in re.findall(r"\bMOD_(\w+)", body)]
+
+
+def decode(stream, out):
+    formats = load_formats()
+    modules = load_modules()
+    buffer = b""
+    frame_size = len(SYNC) + RECORD.size + 1
+
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buffer += chunk
+
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                # Keep a trailing 0xA5 in case it is the start of a frame
+                keep = 1 if buffer.endswith(SYNC[:1]) else 0
+                out.write(buffer[:len(buffer) - keep].decode("utf-8", "replace"))
+                buffer = buffer[len(buffer) - keep:]
+                break
+            if start > 0:
+                out.write(buffer[:start].decode("utf-8", "replace"))
+                buffer = buffer[start:]
+            if len(buffer) < frame_size:
+                break
+
+            body = buffer[len(SYNC):len(SYNC) + RECORD.size]
+            if sum(body) & 0xFF != buffer[frame_size - 1]:
+                # Not a real frame; print the sync bytes as text and move on
+                out.write(buffer[:1].decode("utf-8", "replace"))
+                buffer = buffer[1:]
+                continue
+
+            time_ms, fmt_id, module, level, *args = RECORD.unpack(body)
+            if fmt_id < len(formats):
+                fmt = formats[fmt_id]
+                message = fmt % tuple(args[:fmt.count("%") - 2 * fmt.count("%%")])
+            else:
+                message = "<unknown format %d> %s" % (fmt_id, args)
+            module_name = modules[module] if module < len(modules) else str(module)
+            level_letter = LEVELS[level] if level < len(LEVELS) else "?"
+            out.write("[%d] %s %s: %s\n" % (time_ms, level_letter, module_name, message))
+            buffer = buffer[frame_size:]
+        out.flush()
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    source = sys.argv[1]
+    if source == "-":
+        decode(sys.stdin.buffer, sys.stdout)
+    elif os.path.isfile(source):
+        with open(source, "rb") as capture:
+            decode(capture, sys.stdout)
+    else:
+        import serial
+        with serial.Serial(source, 115200, timeout=0.1) as port:
+            class PortReader:
+                def read(self, size):
+                    data = b""
+                    while not data:
+                        data = port.read(size)
+                    return data
+            decode(PortReader(), sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
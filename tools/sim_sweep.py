@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Run the gimbal simulator over a grid of settings and rank the results.
+
+Each --grid NAME=V1,V2,... adds a dimension to the grid. Names of settings
+in CONFIG_FIELDS in gimbal_config.h go into the --config object, as they
+would be PUT to /api/v1/config; any other name, such as a plant parameter
+or a run option, is passed to sim/gimbal_sim as --NAME. Every combination is
+run with each seed, in parallel, and the results for each combination are
+averaged over the seeds and ranked by one of the summary's metrics, smallest
+first. Everything after -- is passed to every run unchanged.
+
+Build the simulator first with make in sim/.
+
+Usage:
+    sim_sweep.py --grid kp=5,10,20 --grid accept=1,2,4 -- --profile walk
+    sim_sweep.py --grid duty_forward=40,80,120 --tie duty_reverse=duty_forward \\
+                 --seeds 5 --rank rate_rms -o sweep.csv -- --profile shake
+"""
+
+import argparse
+import concurrent.futures
+import itertools
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+SRC_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+SIM = os.path.join(SRC_DIR, "sim", "gimbal_sim")
+SHOWN = ["error_rms", "error_max", "rate_rms", "reversals_per_s", "energy_j"]
+
+
+def load_settings():
+    """Return the names of the settings from CONFIG_FIELDS in gimbal_config.h."""
+    with open(os.path.join(SRC_DIR, "gimbal_config.h")) as header:
+        return set(re.findall(r"X \((\w+),", header.read()))
+
+
+def parse_pairs(items, what):
+    """Split NAME=VALUE items into a list of (name, value) pairs."""
+    pairs = []
+    for item in items:
+        name, sep, value = item.partition("=")
+        if not sep or not name or not value:
+            sys.exit("%s must be NAME=VALUE, not %s" % (what, item))
+        pairs.append((name, value))
+    return pairs
+
+
+def command(values, seed, settings, extra):
+    """Return the simulator's command line for one combination and seed."""
+    config = {name: int(value) for name, value in values.items() if name in settings}
+    line = [SIM, "--json", "--seed", str(seed)]
+    if config:
+        line += ["--config", json.dumps(config, separators=(",", ":"))]
+    for name, value in values.items():
+        if name not in settings:
+            line += ["--" + name, value]
+    return line + extra
+
+
+def run(line):
+    """Run the simulator once and return its summary."""
+    result = subprocess.run(line, capture_output=True, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(result.stderr.strip() or "exit code %d" % result.returncode)
+    return json.loads(result.stdout)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--grid", action="append", default=[], help="NAME=V1,V2,... values to try")
+    parser.add_argument("--tie", action="append", default=[], help="NAME=OTHER gives NAME the value of grid entry OTHER")
+    parser.add_argument("--seeds", type=int, default=3, help="seeds run for each combination (default 3)")
+    parser.add_argument("--rank", default="error_rms", help="metric ranked on, smallest first (default error_rms)")
+    parser.add_argument("--top", type=int, default=10, help="combinations printed (default 10)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="runs at once (default one per CPU)")
+    parser.add_argument("-o", "--output", help="CSV file for every combination's averaged results")
+    parser.add_argument("extra", nargs="*", help="options passed to every run, after --")
+    args = parser.parse_args()
+
+    if not os.path.exists(SIM):
+        sys.exit("%s not found; run make in sim/ first" % SIM)
+    settings = load_settings()
+    grid = [(name, value.split(",")) for name, value in parse_pairs(args.grid, "--grid")]
+    ties = parse_pairs(args.tie, "--tie")
+    names = [name for name, _ in grid]
+    for name, other in ties:
+        if other not in names:
+            sys.exit("--tie %s=%s: %s is not in the grid" % (name, other, other))
+
+    combinations = []
+    for choice in itertools.product(*(values for _, values in grid)):
+        values = dict(zip(names, choice))
+        for name, other in ties:
+            values[name] = values[other]
+        combinations.append(values)
+
+    start = time.monotonic()
+    results = [[] for _ in combinations]
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = {pool.submit(run, command(values, seed, settings, args.extra)): index
+                   for index, values in enumerate(combinations) for seed in range(1, args.seeds + 1)}
+        for future in concurrent.futures.as_completed(futures):
+            try:
+                results[futures[future]].append(future.result())
+            except (RuntimeError, ValueError) as problem:
+                sys.exit("%s: %s" % (combinations[futures[future]], problem))
+    elapsed = time.monotonic() - start
+
+    averaged = []
+    for values, summaries in zip(combinations, results):
+        metrics = {key: sum(summary[key] for summary in summaries) / len(summaries)
+                   for key, value in summaries[0].items() if isinstance(value, (int, float)) and key != "seed"}
+        if args.rank not in metrics:
+            sys.exit("no metric %s; the summary has %s" % (args.rank, ", ".join(sorted(metrics))))
+        averaged.append((values, metrics))
+    averaged.sort(key=lambda entry: entry[1][args.rank])
+
+    shown = [args.rank] + [key for key in SHOWN if key != args.rank]
+    print("%-40s %s" % ("settings", " ".join("%15s" % key for key in shown)))
+    for values, metrics in averaged[:args.top]:
+        label = " ".join("%s=%s" % item for item in values.items()) or "(defaults)"
+        print("%-40s %s" % (label, " ".join("%15.4f" % metrics[key] for key in shown)))
+    runs = len(combinations) * args.seeds
+    print("%d runs in %.1f s, %.0f runs per minute" % (runs, elapsed, runs * 60 / elapsed if elapsed else 0),
+          file=sys.stderr)
+
+    if args.output:
+        columns = list(combinations[0])
+        keys = sorted(averaged[0][1])
+        with open(args.output, "w") as out:
+            out.write(",".join(columns + keys) + "\n")
+            for values, metrics in averaged:
+                out.write(",".join([values[name] for name in columns] + ["%g" % metrics[key] for key in keys]) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Estimate the offset and drift between the gimbal's clock and a camera's.
+
+The gimbal timestamps each edge of the camera's frame sync output with the
+same microsecond clock as its IMU samples (see frame_sync.h). Given those
+edge times and the camera's own time of each frame, a straight line fitted
+through the pairs gives
+
+    gimbal_us = offset_us + (1 + drift_ppm / 1e6) * camera_us
+
+so the offset is the gimbal time of the camera's time zero, the first frame
+when frame times start at zero, and can be passed to gyroflow_export.py as
+--start-us. Drift is how much faster the gimbal's clock runs than the
+camera's, in parts per million.
+
+Edges are read from a gyro log take (a .gyr file, which keeps every edge
+seen while it was recorded), from decoded log text (log_decode.py output,
+or the text log) with lines such as "Frame sync edge 12 at 34567890 us",
+or fetched from GET /api/v1/sync, which holds only the last hundred edges. Camera
+times are either one frame every 1/fps seconds, or read from a CSV file of
+"frame,time_s" rows, such as frame times exported from the video. Edge N is
+paired with frame N counted from the first edge; --first-frame shifts that
+if the camera started before the sync input was wired up.
+
+Usage:
+    sync_align.py 00002.gyr --fps 29.97
+    log_decode.py capture.bin | sync_align.py - --fps 29.97
+    sync_align.py session.txt --frames frame_times.csv
+    sync_align.py --fetch 192.168.1.50 --fps 25
+"""
+
+import argparse
+import csv
+import json
+import math
+import re
+import sys
+import urllib.request
+
+from gyroflow_export import read_take
+
+EDGE = re.compile(r"Frame sync edge (-?\d+) at (-?\d+) us")
+WRAP = 1 << 32          # micros() wraps after about 71 minutes
+OUTLIER_US = 2000       # Residuals bigger than this are dropped from the fit
+
+
+def read_edges_text(lines):
+    """Return (edge number, time in us) pairs from decoded log lines, unwrapped."""
+    edges = {}
+    for line in lines:
+        match = EDGE.search(line)
+        if match:
+            # The decoder prints 32-bit arguments as signed numbers
+            number, time_us = (int(group) % WRAP for group in match.groups())
+            edges[number] = time_us
+    return unwrap(sorted(edges.items()))
+
+
+def read_edges_take(data):
+    """Return (edge number, time in us) pairs from a gyro log take, unwrapped."""
+    return unwrap(sorted(read_take(data)[5]))
+
+
+def read_edges_json(reply):
+    """Return (edge number, time in us) pairs from the /api/v1/sync reply."""
+    return unwrap(sorted((number, time_us) for number, time_us in reply["recent"]))
+
+
+def unwrap(edges):
+    """Add whole wraps of the 32-bit clock so times keep increasing."""
+    result = []
+    offset = 0
+    previous = None
+    for number, time_us in edges:
+        if previous is not None and time_us + offset < previous:
+            offset += WRAP
+        previous = time_us + offset
+        result.append((number, previous))
+    return result
+
+
+def read_frames(path):
+    """Return a dictionary of camera frame times in us from a frame,time_s CSV file."""
+    frames = {}
+    with open(path, newline="") as file:
+        for row in csv.reader(file):
+            try:
+                frames[int(row[0])] = float(row[1]) * 1e6
+            except (ValueError, IndexError):
+                continue        # Header or blank line
+    return frames
+
+
+def fit(pairs):
+    """Return the offset, slope and residuals of a least-squares line through (x, y) pairs."""
+    count = len(pairs)
+    mean_x = sum(x for x, _ in pairs) / count
+    mean_y = sum(y for _, y in pairs) / count
+    sxx = sum((x - mean_x) ** 2 for x, _ in pairs)
+    sxy = sum((x - mean_x) * (y - mean_y) for x, y in pairs)
+    slope = sxy / sxx if sxx else 1.0
+    offset = mean_y - slope * mean_x
+    return offset, slope, [y - (offset + slope * x) for x, y in pairs]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="gyro log take, decoded log text, - for standard input, "
+                        "or the gimbal's address with --fetch")
+    parser.add_argument("--fetch", action="store_true", help="read the recent edges from the gimbal")
+    timing = parser.add_mutually_exclusive_group(required=True)
+    timing.add_argument("--fps", type=float, help="camera frame rate; frame N is at N / fps seconds")
+    timing.add_argument("--frames", help="CSV file of frame,time_s from the camera")
+    parser.add_argument("--first-frame", type=int, default=0, help="camera frame of the first edge (default 0)")
+    args = parser.parse_args()
+
+    if args.fetch:
+        url = "http://%s/api/v1/sync" % args.source
+        with urllib.request.urlopen(url, timeout=10) as reply:
+            edges = read_edges_json(json.load(reply))
+    elif args.source == "-":
+        edges = read_edges_text(sys.stdin)
+    else:
+        with open(args.source, "rb") as file:
+            data = file.read()
+        try:
+            edges = read_edges_take(data) if data.startswith(b"GSGY") \
+                else read_edges_text(data.decode(errors="replace").splitlines())
+        except ValueError as problem:
+            sys.exit("%s: %s" % (args.source, problem))
+    if len(edges) < 2:
+        sys.exit("need at least two frame sync edges, found %d" % len(edges))
+
+    frames = read_frames(args.frames) if args.frames else None
+    first_edge = edges[0][0]
+    pairs = []
+    for number, time_us in edges:
+        frame = number - first_edge + args.first_frame
+        if frames is None:
+            pairs.append((frame * 1e6 / args.fps, time_us))
+        elif frame in frames:
+            pairs.append((frames[frame], time_us))
+    if len(pairs) < 2:
+        sys.exit("fewer than two edges have a camera frame time")
+
+    # Fit once, drop glitches and doubled edges, then fit again
+    offset, slope, residuals = fit(pairs)
+    kept = [pair for pair, residual in zip(pairs, residuals) if abs(residual) <= OUTLIER_US]
+    if len(kept) >= 2:
+        offset, slope, residuals = fit(kept)
+
+    rms = math.sqrt(sum(r * r for r in residuals) / len(residuals))
+    missing = edges[-1][0] - first_edge + 1 - len(edges)
+    print("Edges %d to %d: %d used, %d outliers, %d missing from the log"
+          % (first_edge, edges[-1][0], len(kept), len(pairs) - len(kept), missing))
+    print("Offset     %.0f us (gimbal time of camera time zero)" % offset)
+    print("Drift      %+.1f ppm (gimbal clock relative to the camera's)" % ((slope - 1) * 1e6))
+    print("Residuals  %.1f us RMS, %.1f us largest" % (rms, max(abs(r) for r in residuals)))
+    print("For gyroflow_export.py: --start-us %d" % (round(offset) % WRAP))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Reference client for the gimbal's UDP telemetry and command channel.
+
+Subscribes to telemetry, answers the gimbal's pings, pings the gimbal to
+measure the round-trip time, and can send pitch setpoints as a joystick
+would. Once a second it prints the packet rate, losses and round-trip times.
+The packet layouts must match udp_protocol.h.
+
+Usage:
+    udp_client.py 192.168.1.50                      watch telemetry at 100 Hz
+    udp_client.py 192.168.1.50 --rate 20            watch at 20 Hz
+    udp_client.py 192.168.1.50 --sweep 15           swing the pitch setpoint +/-15 degrees
+    udp_client.py 127.0.0.1 --seconds 5             talk to udp_standin (see udp_link.cpp)
+    udp_client.py 192.168.1.50 --csv run.csv        also save every telemetry packet
+"""
+
+import argparse
+import math
+import socket
+import struct
+import sys
+import time
+
+PORT = 4210
+MAGIC = 0x4753
+VERSION = 1
+
+PKT_TELEMETRY, PKT_SETPOINT, PKT_COMMAND, PKT_PING, PKT_PONG = 1, 2, 3, 4, 5
+CMD_SUBSCRIBE, CMD_UNSUBSCRIBE, CMD_HOME = 1, 2, 3
+
+HEADER = struct.Struct("<HBBII")            # UdpHeader
+TELEMETRY = struct.Struct("<IIhhhhhBBI")    # UdpTelemetry after the header
+SETPOINT = struct.Struct("<hh")             # UdpSetpoint after the header
+COMMAND = struct.Struct("<BBH")             # UdpCommandPacket after the header
+PING = struct.Struct("<II")                 # UdpPing after the header
+
+
+class Channel:
+    """One end of the UDP channel, talking to a single gimbal."""
+
+    def __init__(self, host, port):
+        self.address = (host, port)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.settimeout(0.01)
+        self.start = time.monotonic()
+        self.sequence = 0
+
+    def now_us(self):
+        return int((time.monotonic() - self.start) * 1e6) & 0xFFFFFFFF
+
+    def send(self, kind, body=b""):
+        self.sequence += 1
+        self.sock.sendto(HEADER.pack(MAGIC, VERSION, kind, self.sequence, self.now_us()) + body,
+                         self.address)
+
+    def receive(self):
+        """Return (header fields, body) of the next packet, or None on timeout."""
+        try:
+            data, _ = self.sock.recvfrom(256)
+        except socket.timeout:
+            return None
+        if len(data) < HEADER.size:
+            return None
+        header = HEADER.unpack_from(data)
+        if header[0] != MAGIC or header[1] != VERSION:
+            return None
+        return header, data[HEADER.size:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host", help="address of the gimbal")
+    parser.add_argument("--port", type=int, default=PORT)
+    parser.add_argument("--rate", type=int, default=100, help="telemetry packets per second")
+    parser.add_argument("--seconds", type=float, default=0, help="stop after this long (0: run until ^C)")
+    parser.add_argument("--setpoint", type=int, help="hold this pitch setpoint in degrees")
+    parser.add_argument("--sweep", type=float, help="swing the pitch setpoint this many degrees each way")
+    parser.add_argument("--csv", help="save telemetry to this CSV file")
+    args = parser.parse_args()
+
+    channel = Channel(args.host, args.port)
+    csv = open(args.csv, "w") if args.csv else None
+    if csv:
+        csv.write("time_ms,sequence,angle_deg,rate_dps,setpoint_deg,error_deg,effort,flags,state,rtt_us\n")
+
+    channel.send(PKT_COMMAND, COMMAND.pack(CMD_SUBSCRIBE, 0, args.rate))
+    last_sequence = None
+    received = lost = late = 0
+    rtts = []
+    device_rtt = 0
+    last = None
+    next_report = next_ping = next_setpoint = time.monotonic()
+
+    try:
+        while not args.seconds or time.monotonic() - channel.start < args.seconds:
+            now = time.monotonic()
+
+            if now >= next_ping:
+                channel.send(PKT_PING, PING.pack(0, 0))
+                next_ping = now + 0.5
+
+            if (args.setpoint is not None or args.sweep) and now >= next_setpoint:
+                pitch = args.setpoint or 0
+                if args.sweep:
+                    pitch += round(args.sweep * math.sin(2 * math.pi * 0.2 * (now - channel.start)))
+                channel.send(PKT_SETPOINT, SETPOINT.pack(pitch, 0))
+                next_setpoint = now + 0.02
+
+            packet = channel.receive()
+            if packet:
+                (_, _, kind, sequence, time_us), body = packet
+                # Every packet from the gimbal is numbered, so gaps are losses
+                if last_sequence is not None:
+                    step = (sequence - last_sequence) & 0xFFFFFFFF
+                    if step == 0 or step > 0x80000000:
+                        late += 1
+                    else:
+                        lost += step - 1
+                if last_sequence is None or (sequence - last_sequence) & 0xFFFFFFFF < 0x80000000:
+                    last_sequence = sequence
+
+                if kind == PKT_TELEMETRY and len(body) >= TELEMETRY.size:
+                    received += 1
+                    last = TELEMETRY.unpack_from(body)
+                    device_rtt = last[9]
+                    if csv:
+                        s_seq, s_time, angle, rate, setpoint, error, effort, flags, state, rtt = last
+                        csv.write("%.3f,%d,%d,%.2f,%d,%d,%d,%d,%d,%d\n" % (
+                            s_time / 1000.0, s_seq, angle, rate / 131.0, setpoint, error,
+                            effort, flags, state, rtt))
+                elif kind == PKT_PING and len(body) >= PING.size:
+                    channel.send(PKT_PONG, PING.pack(sequence, time_us))
+                elif kind == PKT_PONG and len(body) >= PING.size:
+                    _, origin_time = PING.unpack_from(body)
+                    rtts.append(((channel.now_us() - origin_time) & 0xFFFFFFFF) / 1000.0)
+
+            if now >= next_report:
+                rtt = "rtt %.2f/%.2f/%.2f ms" % (min(rtts), sum(rtts) / len(rtts), max(rtts)) if rtts else "rtt -"
+                state = ("pitch %d setpoint %d" % (last[2], last[4])) if last else "no telemetry"
+                print("%d telemetry/s, %d lost, %d late, %s, gimbal rtt %.2f ms, %s"
+                      % (received, lost, late, rtt, device_rtt / 1000.0, state))
+                sys.stdout.flush()
+                received = 0
+                rtts = []
+                next_report = now + 1.0
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.setpoint is not None or args.sweep:
+            channel.send(PKT_COMMAND, COMMAND.pack(CMD_HOME, 0, 0))
+        channel.send(PKT_COMMAND, COMMAND.pack(CMD_UNSUBSCRIBE, 0, 0))
+        if csv:
+            csv.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,310 @@
+/** @file trace_recorder.cpp
+ * This is the implementation file for the trace recorder. The ring is
+ * overwritten from the oldest event once it fills, so it always holds the
+ * most recent @c TRACE_RING_SIZE events. Recording pauses while the ring is
+ * exported so the export sees a consistent picture; writers count themselves
+ * in and out so that pausing can wait for any event still being filled in.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <atomic>
+#include "trace_recorder.h"
+
+/// One event as stored in the ring
+struct TraceEvent
+{
+    uint32_t time_us;       ///< Time of the event from @c micros()
+    const char* name;       ///< Name of the event; always a string constant
+    TaskHandle_t task;      ///< Task which recorded the event, or NULL for an interrupt
+    uint8_t phase;          ///< One of the @c TracePhase letters
+    uint8_t core;           ///< Core on which the event was recorded
+};
+
+static TraceEvent events[TRACE_RING_SIZE];      ///< The ring of recorded events
+static std::atomic<uint32_t> next_event (0);    ///< Number of events ever recorded
+static std::atomic<bool> paused (false);        ///< Set while the ring is being exported
+static std::atomic<bool> exporting (false);     ///< Set while an export holds the ring
+static std::atomic<uint32_t> writers (0);       ///< Number of events being filled in right now
+
+const uint8_t MAX_TRACE_THREADS = 32;           ///< Most distinct tasks named in one export
+const size_t TRACE_ITEM_MAX = 160;              ///< Longest line written for one event or track
+
+/// Parts of the exported document, in the order they are written
+enum TraceExportStage
+{
+    EXPORT_HEADER,
+    EXPORT_EVENTS,
+    EXPORT_NAMES,
+    EXPORT_DONE
+};
+
+static TaskHandle_t threads[MAX_TRACE_THREADS];     ///< Tasks given a track in the current export
+static uint8_t thread_cores[MAX_TRACE_THREADS];     ///< Core each of those tasks ran on
+static uint8_t num_threads = 0;                     ///< Number of entries in @c threads
+
+
+/** @brief   Store one event in the ring.
+ *  @param   name The name of the event
+ *  @param   phase Whether this begins or ends a duration, or is an instant
+ *  @param   task The task recording the event, or NULL in an interrupt
+*/
+static inline void store_event (const char* name, TracePhase phase, TaskHandle_t task)
+{
+    // Count in before looking at the flag, so pause_recording() either sees
+    // this writer or this writer sees the pause
+    writers.fetch_add (1);
+    if (paused.load ())
+    {
+        writers.fetch_sub (1, std::memory_order_release);
+        return;
+    }
+    uint32_t index = next_event.fetch_add (1, std::memory_order_relaxed) & (TRACE_RING_SIZE - 1);
+    TraceEvent& event = events[index];
+    event.time_us = micros ();
+    event.name = name;
+    event.task = task;
+    event.phase = phase;
+    event.core = xPortGetCoreID ();
+    writers.fetch_sub (1, std::memory_order_release);
+}
+
+/** @brief   Stop recording and wait for events already being stored to finish.
+ *  @details A writer can be preempted part way through an event by the
+ *           task which pauses, so this sleeps rather than spins while waiting.
+*/
+static void pause_recording (void)
+{
+    paused.store (true);
+    while (writers.load (std::memory_order_acquire) != 0)
+    {
+        vTaskDelay (1);
+    }
+}
+
+/** @brief   Record an event from a task.
+ *  @param   name The name of the event; must be a string constant
+ *  @param   phase Whether this begins or ends a duration, or is an instant
+*/
+void trace_record (const char* name, TracePhase phase)
+{
+    store_event (name, phase, xTaskGetCurrentTaskHandle ());
+}
+
+/** @brief   Record an event from an interrupt handler.
+ *  @details Interrupt events are shown on their own track for each core.
+ *  @param   name The name of the event; must be a string constant
+ *  @param   phase Whether this begins or ends a duration, or is an instant
+*/
+void trace_record_from_isr (const char* name, TracePhase phase)
+{
+    store_event (name, phase, NULL);
+}
+
+/** @brief   Throw away every event in the ring.
+*/
+void trace_clear (void)
+{
+    pause_recording ();
+    next_event.store (0);
+    paused.store (exporting.load ());
+}
+
+/** @brief   Find the thread ID used for a task in the exported trace.
+ *  @param   task The task, or NULL for interrupts
+ *  @param   threads Table of tasks which have been given IDs so far
+ *  @param   p_count Number of entries in @c threads, updated if one is added
+ *  @returns The thread ID, starting from 1; 0 is used for interrupts
+*/
+static uint8_t thread_id (TaskHandle_t task, TaskHandle_t* threads, uint8_t* p_count)
+{
+    if (task == NULL)
+    {
+        return 0;
+    }
+    for (uint8_t index = 0; index < *p_count; index++)
+    {
+        if (threads[index] == task)
+        {
+            return index + 1;
+        }
+    }
+    if (*p_count < MAX_TRACE_THREADS)
+    {
+        threads[(*p_count)++] = task;
+        return *p_count;
+    }
+    return MAX_TRACE_THREADS;
+}
+
+/** @brief   Return @c true while an export holds the ring.
+*/
+bool trace_export_running (void)
+{
+    return exporting.load ();
+}
+
+/** @brief   Start exporting the ring as a Chrome trace-event JSON document.
+ *  @details Recording is paused until the export ends. Only one export can
+ *           run at a time.
+ *  @param   cursor The cursor which keeps track of the export
+ *  @returns @c true if the export was started, @c false if another is running
+*/
+bool trace_export_begin (TraceExportCursor& cursor)
+{
+    bool expected = false;
+    if (!exporting.compare_exchange_strong (expected, true))
+    {
+        cursor.stage = EXPORT_DONE;
+        return false;
+    }
+    pause_recording ();
+
+    cursor.stage = EXPORT_HEADER;
+    cursor.end = next_event.load ();
+    cursor.next = cursor.end > TRACE_RING_SIZE ? cursor.end - TRACE_RING_SIZE : 0;
+    cursor.name_index = 0;
+    num_threads = 0;
+    return true;
+}
+
+/** @brief   Write as much of the exported document as fits.
+ *  @details Each core is shown as a process and each task as a thread within
+ *           it. The export ends by itself once the whole document is written.
+ *  @param   cursor The cursor from @c trace_export_begin()
+ *  @param   out The buffer into which the document is written
+ *  @returns @c true if there is more to write, @c false once the export is done
+*/
+bool trace_export_chunk (TraceExportCursor& cursor, BufferPrint& out)
+{
+    while (cursor.stage != EXPORT_DONE && out.room () >= TRACE_ITEM_MAX)
+    {
+        if (cursor.stage == EXPORT_HEADER)
+        {
+            out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << endl;
+            for (uint8_t core = 0; core < 2; core++)
+            {
+                out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << core
+                    << ",\"args\":{\"name\":\"Core " << core << "\"}}," << endl;
+                out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << core
+                    << ",\"tid\":0,\"args\":{\"name\":\"Interrupts\"}}," << endl;
+            }
+            cursor.stage = EXPORT_EVENTS;
+        }
+        else if (cursor.stage == EXPORT_EVENTS)
+        {
+            if (cursor.next == cursor.end)
+            {
+                cursor.stage = EXPORT_NAMES;
+                continue;
+            }
+            const TraceEvent& event = events[cursor.next++ & (TRACE_RING_SIZE - 1)];
+            uint8_t tid = thread_id (event.task, threads, &num_threads);
+            if (tid != 0)
+            {
+                thread_cores[tid - 1] = event.core;
+            }
+            out << "{\"name\":\"" << event.name << "\",\"ph\":\"" << (char)event.phase
+                << "\",\"ts\":" << event.time_us << ",\"pid\":" << event.core << ",\"tid\":" << tid;
+            if (event.phase == TRACE_INSTANT)
+            {
+                out << ",\"s\":\"t\"";
+            }
+            out << "}," << endl;
+        }
+        else
+        {
+            // Name each task's track; this comes last so only tasks seen in the trace are named
+            uint8_t index = cursor.name_index++;
+            if (index < num_threads)
+            {
+                out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << thread_cores[index]
+                    << ",\"tid\":" << index + 1 << ",\"args\":{\"name\":\""
+                    << pcTaskGetName (threads[index]) << "\"}}" << (index + 1 < num_threads ? "," : "") << endl;
+                continue;
+            }
+            if (num_threads == 0)
+            {
+                out << "{\"ph\":\"M\",\"name\":\"trace_empty\",\"pid\":0}" << endl;
+            }
+            out << "]}" << endl;
+            trace_export_end (cursor);
+        }
+    }
+    return cursor.stage != EXPORT_DONE;
+}
+
+/** @brief   Finish an export and resume recording.
+ *  @details This is called by @c trace_export_chunk() when the document is
+ *           complete; call it directly to abandon an export part way through,
+ *           for example when the client goes away.
+ *  @param   cursor The cursor from @c trace_export_begin()
+*/
+void trace_export_end (TraceExportCursor& cursor)
+{
+    if (cursor.stage != EXPORT_DONE)
+    {
+        cursor.stage = EXPORT_DONE;
+        paused.store (false);
+        exporting.store (false);
+    }
+}
+
+/** @brief   Write every event in the ring as a Chrome trace-event JSON document.
+ *  @param   out The device to which the JSON is written
+*/
+void trace_export_json (Print& out)
+{
+    TraceExportCursor cursor;
+    if (!trace_export_begin (cursor))
+    {
+        out << "Another trace export is running" << endl;
+        return;
+    }
+
+    uint8_t buffer[512];
+    BufferPrint chunk (buffer, sizeof (buffer));
+    bool more;
+    do
+    {
+        chunk.clear ();
+        more = trace_export_chunk (cursor, chunk);
+        out.write (buffer, chunk.length ());
+    }
+    while (more);
+}
+
+#ifndef ARDUINO
+/// Adapter which lets the JSON exporter write straight into a file
+class FilePrint : public Print
+{
+    protected:
+        FILE* p_file;
+
+    public:
+        FilePrint (FILE* file) : p_file (file) { }
+        size_t write (uint8_t ch) override { return fputc (ch, p_file) == EOF ? 0 : 1; }
+        size_t write (const uint8_t* buffer, size_t size) override
+        {
+            return fwrite (buffer, 1, size, p_file);
+        }
+};
+
+/** @brief   Write the trace to a JSON file, for host and simulator builds.
+ *  @param   path The name of the file to be written
+ *  @returns @c true if the file was written
+*/
+bool trace_export_file (const char* path)
+{
+    FILE* p_file = fopen (path, "w");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    FilePrint file_out (p_file);
+    trace_export_json (file_out);
+    return fclose (p_file) == 0;
+}
+#endif
@@ -0,0 +1,90 @@
+/** @file trace_recorder.h
+ * This is the header file for the trace recorder, which logs begin and end
+ * events for tasks, interrupts, I2C transfers and control cycles into a RAM
+ * ring. The ring can be exported in Chrome's trace-event JSON format and
+ * opened in Perfetto (ui.perfetto.dev) or chrome://tracing to see exactly
+ * how the tasks on each core interleave.
+ * 
+ * Events are recorded with one atomic add and a 16 byte copy, so the macros
+ * below may be used in tasks on either core and in interrupt handlers.
+ * Building with @c -DTRACE_ENABLED=0 removes them all.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _TRACE_RECORDER_
+#define _TRACE_RECORDER_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+#include "buffer_print.h"
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+const uint16_t TRACE_RING_SIZE = 1024;      ///< Number of events kept; must be a power of two
+
+/// Kinds of trace event, using Chrome's phase letters
+enum TracePhase
+{
+    TRACE_BEGIN = 'B',      ///< Start of a duration
+    TRACE_END = 'E',        ///< End of a duration
+    TRACE_INSTANT = 'i'     ///< Something which happened at one moment
+};
+
+void trace_record (const char* name, TracePhase phase);
+void trace_record_from_isr (const char* name, TracePhase phase);
+void trace_clear (void);
+/** @brief Position in an export of the trace ring, so it can be sent a piece at a time
+*/
+struct TraceExportCursor
+{
+    uint8_t stage;          ///< Which part of the document is being written
+    uint32_t next;          ///< Count of the next event to write
+    uint32_t end;           ///< One past the last event to write
+    uint8_t name_index;     ///< Next task track to name
+};
+
+bool trace_export_running (void);
+bool trace_export_begin (TraceExportCursor& cursor);
+bool trace_export_chunk (TraceExportCursor& cursor, BufferPrint& out);
+void trace_export_end (TraceExportCursor& cursor);
+void trace_export_json (Print& out);
+#ifndef ARDUINO
+bool trace_export_file (const char* path);
+#endif
+
+/** @brief   Class which records begin and end events around the block it is declared in.
+ *  @details Don't use this directly; use the @c TRACE_SCOPE() macro.
+*/
+class TraceScope
+{
+    protected:
+        const char* name;       ///< Name of the duration being traced
+
+    public:
+        TraceScope (const char* scope_name) : name (scope_name) { trace_record (name, TRACE_BEGIN); }
+        ~TraceScope (void) { trace_record (name, TRACE_END); }
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2 (a, b)
+
+// Names must be string constants, as only the pointer is stored
+#if TRACE_ENABLED
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT (trace_scope_, __LINE__) (name)
+#define TRACE_EVENT(name) trace_record (name, TRACE_INSTANT)
+#define TRACE_ISR_BEGIN(name) trace_record_from_isr (name, TRACE_BEGIN)
+#define TRACE_ISR_END(name) trace_record_from_isr (name, TRACE_END)
+#else
+#define TRACE_SCOPE(name) do { } while (0)
+#define TRACE_EVENT(name) do { } while (0)
+#define TRACE_ISR_BEGIN(name) do { } while (0)
+#define TRACE_ISR_END(name) do { } while (0)
+#endif
+
+#endif
@@ -0,0 +1,456 @@
+/** @file udp_link.cpp
+ * This is the implementation file for the UDP telemetry and command channel.
+ * Packets are only ever read and written by one task, which polls the
+ * socket without blocking; the control task reads remote setpoints through
+ * a @c Mailbox.
+ * 
+ * Packets carry sequence numbers, so a setpoint which arrives after a newer
+ * one is thrown away, and gaps in a sender's sequence are counted as lost. A setpoint which isn't
+ * refreshed within @c UDP_SETPOINT_TIMEOUT_MS is ignored, so the gimbal goes
+ * back to its home angle if the operator's link drops. The gimbal pings its
+ * subscriber every @c UDP_PING_INTERVAL_MS and reports the round-trip time.
+ * 
+ * To run the channel on a PC with a stand-in for the gimbal which sends
+ * made-up telemetry:
+ * 
+ *     g++ -std=c++17 -DUDP_LINK_STANDIN -I. udp_link.cpp -o udp_standin
+ *     ./udp_standin &
+ *     tools/udp_client.py 127.0.0.1
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <string.h>
+#include "udp_link.h"
+#include "lockfree.h"
+
+#ifdef ARDUINO
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "task_config.h"
+#include "telemetry.h"
+#include "supervisor.h"
+#include "wifi_link.h"
+
+/// Telemetry records per second produced by the control task
+const uint16_t SOURCE_RATE_HZ = 1000 / (IMU_PERIOD * portTICK_PERIOD_MS);
+
+static WiFiUDP udp;                 ///< The socket
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+const uint16_t SOURCE_RATE_HZ = 100;    ///< Telemetry records per second from the stand-in
+
+static int udp_socket = -1;         ///< The socket
+#endif
+
+/** @brief A setpoint received from a client, as handed to the control task
+*/
+struct RemoteSetpoint
+{
+    int16_t pitch;          ///< Pitch setpoint in degrees
+    int16_t roll;           ///< Roll setpoint in degrees
+    uint32_t time_ms;       ///< When it arrived, on our clock
+    bool valid;             ///< @c false after a home command
+};
+
+static Mailbox<RemoteSetpoint> remote_setpoint;     ///< Latest setpoint, for the control task
+
+static uint32_t tx_sequence = 0;        ///< Sequence number of the last packet sent
+static bool subscribed = false;         ///< @c true while a client wants telemetry
+static uint32_t subscriber_address;     ///< Subscriber's IPv4 address, in network byte order
+static uint16_t subscriber_port;        ///< Subscriber's UDP port
+static uint16_t decimation = 1;         ///< Send every this many telemetry records
+static uint32_t publish_count = 0;      ///< Records offered since the client subscribed
+static uint32_t last_ping_ms = 0;       ///< When the last ping was sent
+
+static uint32_t setpoint_sequence = 0;  ///< Sequence number of the newest setpoint used
+static uint32_t rx_sequence = 0;        ///< Sequence number of the newest packet from the last sender
+static uint32_t rx_address = 0;         ///< Address of the last sender
+static uint16_t rx_port = 0;            ///< Port of the last sender
+static uint32_t packets_received = 0;   ///< Good packets received
+static uint32_t packets_bad = 0;        ///< Packets thrown away as malformed
+static uint32_t packets_lost = 0;       ///< Packets missing from the sender's sequence
+static uint32_t setpoints_late = 0;     ///< Setpoint packets which arrived after a newer one
+static uint32_t rtt_last_us = 0;        ///< Last round-trip time to the subscriber
+static uint32_t rtt_min_us = UINT32_MAX;///< Shortest round-trip time seen
+static uint32_t rtt_max_us = 0;         ///< Longest round-trip time seen
+
+
+/** @brief   Return the time in microseconds, on the clock stamped into packets.
+*/
+uint32_t udp_time_us (void)
+{
+#ifdef ARDUINO
+    return micros ();
+#else
+    timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000ULL + now.tv_nsec / 1000);
+#endif
+}
+
+/** @brief   Open the socket.
+ *  @param   port The UDP port to listen on
+ *  @returns @c true if the socket was opened, @c false if not
+*/
+bool udp_begin (uint16_t port)
+{
+#ifdef ARDUINO
+    return udp.begin (port) == 1;
+#else
+    udp_socket = socket (AF_INET, SOCK_DGRAM, 0);
+    if (udp_socket < 0)
+    {
+        return false;
+    }
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl (INADDR_ANY);
+    local.sin_port = htons (port);
+    fcntl (udp_socket, F_SETFL, O_NONBLOCK);
+    return bind (udp_socket, (sockaddr*)&local, sizeof (local)) == 0;
+#endif
+}
+
+/** @brief   Take the next packet from the socket if there is one, without waiting.
+ *  @param   buffer Where the packet is copied
+ *  @param   size Size of @c buffer; longer packets are cut short
+ *  @param   address A reference to where the sender's address is put
+ *  @param   port A reference to where the sender's port is put
+ *  @returns The length of the packet, or zero if none was waiting
+*/
+static size_t receive (uint8_t* buffer, size_t size, uint32_t& address, uint16_t& port)
+{
+#ifdef ARDUINO
+    int length = udp.parsePacket ();
+    if (length <= 0)
+    {
+        return 0;
+    }
+    address = (uint32_t)udp.remoteIP ();
+    port = udp.remotePort ();
+    return udp.read (buffer, size);
+#else
+    sockaddr_in from;
+    socklen_t from_length = sizeof (from);
+    ssize_t length = recvfrom (udp_socket, buffer, size, 0, (sockaddr*)&from, &from_length);
+    if (length <= 0)
+    {
+        return 0;
+    }
+    address = from.sin_addr.s_addr;
+    port = ntohs (from.sin_port);
+    return length;
+#endif
+}
+
+/** @brief   Stamp a packet's header and send it.
+ *  @param   address Destination IPv4 address, in network byte order
+ *  @param   port Destination UDP port
+ *  @param   header The header at the start of the packet to be sent
+ *  @param   type Type of the packet
+ *  @param   length Length of the whole packet
+*/
+static void send_packet (uint32_t address, uint16_t port, UdpHeader& header, uint8_t type, size_t length)
+{
+    header.magic = UDP_MAGIC;
+    header.version = UDP_VERSION;
+    header.type = type;
+    header.sequence = ++tx_sequence;
+    header.time_us = udp_time_us ();
+
+#ifdef ARDUINO
+    udp.beginPacket (IPAddress (address), port);
+    udp.write ((const uint8_t*)&header, length);
+    udp.endPacket ();
+#else
+    sockaddr_in to = {};
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = address;
+    to.sin_port = htons (port);
+    sendto (udp_socket, &header, length, 0, (sockaddr*)&to, sizeof (to));
+#endif
+}
+
+/** @brief   Use a setpoint packet unless a newer one has already arrived.
+ *  @param   packet The setpoint packet
+*/
+static void handle_setpoint (const UdpSetpoint& packet)
+{
+    int32_t ahead = (int32_t)(packet.header.sequence - setpoint_sequence);
+    if (setpoint_sequence != 0 && ahead <= 0)
+    {
+        setpoints_late++;
+        return;
+    }
+    setpoint_sequence = packet.header.sequence;
+
+    RemoteSetpoint setpoint = { packet.pitch, packet.roll, udp_time_us () / 1000, true };
+    remote_setpoint.put (setpoint);
+}
+
+/** @brief   Carry out a command packet.
+ *  @param   packet The command packet
+ *  @param   address Sender's IPv4 address, in network byte order
+ *  @param   port Sender's UDP port
+*/
+static void handle_command (const UdpCommandPacket& packet, uint32_t address, uint16_t port)
+{
+    if (packet.command == UDP_CMD_SUBSCRIBE)
+    {
+        subscribed = true;
+        subscriber_address = address;
+        subscriber_port = port;
+        decimation = (packet.arg == 0 || packet.arg >= SOURCE_RATE_HZ) ? 1 : SOURCE_RATE_HZ / packet.arg;
+        publish_count = 0;
+        rtt_min_us = UINT32_MAX;
+        rtt_max_us = 0;
+    }
+    else if (packet.command == UDP_CMD_UNSUBSCRIBE)
+    {
+        subscribed = false;
+    }
+    else if (packet.command == UDP_CMD_HOME)
+    {
+        RemoteSetpoint setpoint = { 0, 0, 0, false };
+        remote_setpoint.put (setpoint);
+    }
+}
+
+/** @brief   Handle every packet waiting on the socket and ping the subscriber when due.
+ *  @details This must be called often, from the one task which owns the channel.
+*/
+void udp_poll (void)
+{
+    uint8_t buffer[64];
+    uint32_t address;
+    uint16_t port;
+    size_t length;
+
+    while ((length = receive (buffer, sizeof (buffer), address, port)) > 0)
+    {
+        const UdpHeader* header = (const UdpHeader*)buffer;
+        if (length < sizeof (UdpHeader) || header->magic != UDP_MAGIC || header->version != UDP_VERSION)
+        {
+            packets_bad++;
+            continue;
+        }
+
+        // Count gaps in the sequence; a new sender starts a new sequence
+        if (address != rx_address || port != rx_port)
+        {
+            rx_address = address;
+            rx_port = port;
+            rx_sequence = 0;
+            setpoint_sequence = 0;
+        }
+        int32_t ahead = (int32_t)(header->sequence - rx_sequence);
+        if (rx_sequence != 0 && ahead > 1)
+        {
+            packets_lost += ahead - 1;
+        }
+        if (rx_sequence == 0 || ahead > 0)
+        {
+            rx_sequence = header->sequence;
+        }
+
+        if (header->type == PKT_SETPOINT && length >= sizeof (UdpSetpoint))
+        {
+            handle_setpoint (*(const UdpSetpoint*)buffer);
+        }
+        else if (header->type == PKT_COMMAND && length >= sizeof (UdpCommandPacket))
+        {
+            handle_command (*(const UdpCommandPacket*)buffer, address, port);
+        }
+        else if (header->type == PKT_PING && length >= sizeof (UdpPing))
+        {
+            UdpPing pong;
+            pong.origin_sequence = header->sequence;
+            pong.origin_time_us = header->time_us;
+            send_packet (address, port, pong.header, PKT_PONG, sizeof (pong));
+        }
+        else if (header->type == PKT_PONG && length >= sizeof (UdpPing))
+        {
+            // The pong carries the time of our own ping, so no clock sync is needed
+            rtt_last_us = udp_time_us () - ((const UdpPing*)buffer)->origin_time_us;
+            rtt_min_us = rtt_last_us < rtt_min_us ? rtt_last_us : rtt_min_us;
+            rtt_max_us = rtt_last_us > rtt_max_us ? rtt_last_us : rtt_max_us;
+        }
+        else
+        {
+            packets_bad++;
+            continue;
+        }
+        packets_received++;
+    }
+
+    uint32_t now_ms = udp_time_us () / 1000;
+    if (subscribed && now_ms - last_ping_ms >= UDP_PING_INTERVAL_MS)
+    {
+        last_ping_ms = now_ms;
+        UdpPing ping;
+        ping.origin_sequence = 0;
+        ping.origin_time_us = 0;
+        send_packet (subscriber_address, subscriber_port, ping.header, PKT_PING, sizeof (ping));
+    }
+}
+
+/** @brief   Send one control cycle's telemetry to the subscriber, if it wants this one.
+ *  @details Call this once for every telemetry record; the subscriber's rate
+ *           decides which are sent. The header and round-trip time are filled in here.
+ *  @param   packet The telemetry packet with its data filled in
+*/
+void udp_publish (UdpTelemetry& packet)
+{
+    if (!subscribed || publish_count++ % decimation != 0)
+    {
+        return;
+    }
+    packet.rtt_us = rtt_last_us;
+    send_packet (subscriber_address, subscriber_port, packet.header, PKT_TELEMETRY, sizeof (packet));
+}
+
+/** @brief   Get the pitch setpoint sent by a client, if there is a fresh one.
+ *  @details This may be called from any task.
+ *  @param   setpoint A reference to where the setpoint is put; unchanged if there is none
+ *  @returns @c true if a setpoint newer than @c UDP_SETPOINT_TIMEOUT_MS was found
+*/
+bool udp_pitch_setpoint (int16_t& setpoint)
+{
+    RemoteSetpoint remote;
+    if (!remote_setpoint.get (remote) || !remote.valid
+        || udp_time_us () / 1000 - remote.time_ms > UDP_SETPOINT_TIMEOUT_MS)
+    {
+        return false;
+    }
+    setpoint = remote.pitch;
+    return true;
+}
+
+#ifdef ARDUINO
+/** @brief   Print the state of the UDP channel.
+ *  @param   out The device to which the report is printed
+*/
+void udp_print (Print& out)
+{
+    out << "UDP port " << UDP_PORT << ": " << packets_received << " packets received, "
+        << packets_bad << " bad, " << tx_sequence << " sent" << endl;
+    if (subscribed)
+    {
+        out << "Subscriber " << IPAddress (subscriber_address) << ":" << subscriber_port
+            << " at " << SOURCE_RATE_HZ / decimation << " Hz" << endl;
+    }
+    else
+    {
+        out << "No telemetry subscriber" << endl;
+    }
+    out << packets_lost << " packets lost, " << setpoints_late << " setpoints arrived late" << endl;
+    if (rtt_max_us > 0)
+    {
+        out << "Round trip: last " << rtt_last_us << " us, min " << rtt_min_us
+            << " us, max " << rtt_max_us << " us" << endl;
+    }
+}
+
+/** @brief   Task which runs the UDP channel.
+ *  @details Every control period this task handles incoming packets and
+ *           sends the new telemetry records to the subscriber.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_UDP (void* p_params)
+{
+    wifi_wait_started ();
+    udp_begin (UDP_PORT);
+
+    uint32_t cursor = telemetry_count ();
+    TelemetryRecord record;
+    UdpTelemetry packet;
+
+    TickType_t last_wake = xTaskGetTickCount ();
+    while (true)
+    {
+        vTaskDelayUntil (&last_wake, IMU_PERIOD);
+        task_woke (TASK_UDP);
+        udp_poll ();
+
+        uint32_t newest = telemetry_count ();
+        if (newest - cursor > TELEMETRY_RING_SIZE)
+        {
+            cursor = newest - TELEMETRY_RING_SIZE;
+        }
+        for ( ; cursor < newest; cursor++)
+        {
+            if (telemetry_get (cursor, record))
+            {
+                packet.sample_sequence = record.sequence;
+                packet.sample_time_us = record.time_us;
+                packet.angle = record.angle;
+                packet.rate = record.rate;
+                packet.setpoint = record.setpoint;
+                packet.error = record.error;
+                packet.effort = record.effort;
+                packet.flags = record.flags;
+                packet.state = supervisor_state ();
+                udp_publish (packet);
+            }
+        }
+    }
+}
+#endif
+
+#if !defined (ARDUINO) && defined (UDP_LINK_STANDIN)
+/** @brief   Stand-in for the gimbal which runs the UDP channel on a PC.
+ *  @details The "gimbal" swings its pitch angle slowly and steers toward any
+ *           setpoint the client sends, so the whole protocol can be tried out
+ *           over the loopback interface.
+ *  @param   argc Number of arguments
+ *  @param   argv Arguments; the first, if given, is how many seconds to run
+*/
+int main (int argc, char** argv)
+{
+    double seconds = argc > 1 ? atof (argv[1]) : 0;
+    if (!udp_begin (UDP_PORT))
+    {
+        perror ("udp_begin");
+        return 1;
+    }
+    printf ("UDP stand-in listening on port %u\n", UDP_PORT);
+
+    UdpTelemetry packet;
+    for (uint32_t cycle = 1; seconds <= 0 || cycle <= seconds * SOURCE_RATE_HZ; cycle++)
+    {
+        udp_poll ();
+
+        int16_t setpoint = 0;
+        udp_pitch_setpoint (setpoint);
+        int16_t angle = setpoint + 5 * sin (cycle / 50.0);
+        packet.sample_sequence = cycle;
+        packet.sample_time_us = udp_time_us ();
+        packet.angle = angle;
+        packet.rate = 131 * 5 * cos (cycle / 50.0) * 2;
+        packet.setpoint = setpoint;
+        packet.error = setpoint - angle;
+        packet.effort = packet.error * 10;
+        packet.flags = 0;
+        packet.state = 0;
+        udp_publish (packet);
+
+        usleep (1000000 / SOURCE_RATE_HZ);
+    }
+
+    printf ("%u packets received, %u bad, %u lost, %u late setpoints, last RTT %u us\n",
+            packets_received, packets_bad, packets_lost, setpoints_late, rtt_last_us);
+    return 0;
+}
+#endif
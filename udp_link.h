@@ -0,0 +1,40 @@
+/** @file udp_link.h
+ * This is the header file for the UDP telemetry and command channel. One
+ * client at a time subscribes to telemetry; any client may send setpoints,
+ * commands and pings. The packets are defined in udp_protocol.h.
+ * 
+ * On the ESP32 the channel uses @c WiFiUDP. Built anywhere else it uses
+ * POSIX sockets, so the same code can be run on a PC against
+ * @c tools/udp_client.py over the loopback interface.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _UDP_LINK_
+#define _UDP_LINK_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "udp_protocol.h"
+
+const uint32_t UDP_PING_INTERVAL_MS = 1000;     ///< Time between pings to the subscriber
+const uint32_t UDP_SETPOINT_TIMEOUT_MS = 1000;  ///< Remote setpoints older than this are ignored
+
+bool udp_begin (uint16_t port);
+void udp_poll (void);
+void udp_publish (UdpTelemetry& packet);
+bool udp_pitch_setpoint (int16_t& setpoint);
+uint32_t udp_time_us (void);
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <PrintStream.h>
+
+void udp_print (Print& out);
+void task_UDP (void* p_params);
+#endif
+
+#endif
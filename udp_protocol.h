@@ -0,0 +1,103 @@
+/** @file udp_protocol.h
+ * This file defines the packets of the UDP telemetry and command channel.
+ * Every packet has a fixed layout, little-endian with no padding, and starts
+ * with a @c UdpHeader carrying a sequence number and the sender's time, so
+ * the receiver can spot lost, late and repeated packets. The file only
+ * needs the standard integer types, so host programs can include it too;
+ * @c tools/udp_client.py must be kept in step with it.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _UDP_PROTOCOL_
+#define _UDP_PROTOCOL_
+
+#include <stdint.h>
+
+const uint16_t UDP_PORT = 4210;             ///< Port the gimbal listens on
+const uint16_t UDP_MAGIC = 0x4753;          ///< "GS", first two bytes of every packet
+const uint8_t UDP_VERSION = 1;              ///< Version of the packet layouts
+
+/// Types of packet
+enum UdpPacketType : uint8_t
+{
+    PKT_TELEMETRY = 1,      ///< Gimbal to client: one control cycle
+    PKT_SETPOINT = 2,       ///< Client to gimbal: new axis setpoints
+    PKT_COMMAND = 3,        ///< Client to gimbal: one of @c UdpCommand
+    PKT_PING = 4,           ///< Either way: asks for a pong
+    PKT_PONG = 5            ///< Either way: answers a ping
+};
+
+/// Commands carried by a @c PKT_COMMAND packet
+enum UdpCommand : uint8_t
+{
+    UDP_CMD_SUBSCRIBE = 1,  ///< Send telemetry to the sender at @c arg records per second
+    UDP_CMD_UNSUBSCRIBE = 2,///< Stop sending telemetry
+    UDP_CMD_HOME = 3        ///< Drop remote setpoints and go back to the home angles
+};
+
+/** @brief Header at the start of every packet
+*/
+struct __attribute__ ((packed)) UdpHeader
+{
+    uint16_t magic;         ///< Always @c UDP_MAGIC
+    uint8_t version;        ///< Always @c UDP_VERSION
+    uint8_t type;           ///< One of @c UdpPacketType
+    uint32_t sequence;      ///< Counts packets from this sender, starting at 1
+    uint32_t time_us;       ///< Sender's clock when the packet was sent, in microseconds
+};
+
+/** @brief Telemetry from one control cycle
+*/
+struct __attribute__ ((packed)) UdpTelemetry
+{
+    UdpHeader header;
+    uint32_t sample_sequence;   ///< Trace ID of the IMU sample
+    uint32_t sample_time_us;    ///< Time the IMU was sampled on the gimbal's clock
+    int16_t angle;          ///< Measured pitch angle in degrees
+    int16_t rate;           ///< Raw pitch rate, 131 counts per degree per second
+    int16_t setpoint;       ///< Pitch setpoint in degrees
+    int16_t error;          ///< Control error in degrees
+    int16_t effort;         ///< Motor effort: channel 1 duty minus channel 2 duty
+    uint8_t flags;          ///< Telemetry flags, as in @c TelemetryRecord
+    uint8_t state;          ///< Supervisor state
+    uint32_t rtt_us;        ///< Last round-trip time the gimbal measured to this client
+};
+
+/** @brief New setpoints for the axes
+*/
+struct __attribute__ ((packed)) UdpSetpoint
+{
+    UdpHeader header;
+    int16_t pitch;          ///< Pitch setpoint in degrees
+    int16_t roll;           ///< Roll setpoint in degrees
+};
+
+/** @brief A command to the gimbal
+*/
+struct __attribute__ ((packed)) UdpCommandPacket
+{
+    UdpHeader header;
+    uint8_t command;        ///< One of @c UdpCommand
+    uint8_t reserved;       ///< Zero
+    uint16_t arg;           ///< Argument of the command
+};
+
+/** @brief A ping, or the pong which answers it
+*/
+struct __attribute__ ((packed)) UdpPing
+{
+    UdpHeader header;
+    uint32_t origin_sequence;   ///< In a pong, the ping's sequence number; zero in a ping
+    uint32_t origin_time_us;    ///< In a pong, the ping's time; zero in a ping
+};
+
+static_assert (sizeof (UdpHeader) == 12, "UDP header layout has changed");
+static_assert (sizeof (UdpTelemetry) == 36, "UDP telemetry layout has changed");
+static_assert (sizeof (UdpSetpoint) == 16, "UDP setpoint layout has changed");
+static_assert (sizeof (UdpCommandPacket) == 16, "UDP command layout has changed");
+static_assert (sizeof (UdpPing) == 20, "UDP ping layout has changed");
+
+#endif
@@ -0,0 +1,444 @@
+/** @file web_api.cpp
+ * This is the implementation file for the REST API. Everything here runs in
+ * the AsyncTCP task, one callback at a time, so the table of bodies being
+ * received needs no lock.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <LittleFS.h>
+#include "web_api.h"
+#include "web_server.h"
+#include "gimbal_config.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "lockfree.h"
+#include "IMU.h"
+#include "pipeline.h"
+#include "supervisor.h"
+#include "core_load.h"
+#include "rolling_stats.h"
+#include "stab_metrics.h"
+#include "blackbox.h"
+#include "flash_log.h"
+#include "gyro_log.h"
+#include "frame_sync.h"
+#include "task_config.h"
+
+/// A constant error reply
+#define API_ERROR(text) "{\"error\":\"" text "\"}"
+
+extern Mailbox<AttitudeSample> attitude;    ///< Latest attitude, from main.cpp
+extern PipelineStats pipeline_stats;        ///< Latency of each pipeline stage, from main.cpp
+extern StabilityMetrics pitch_quality;      ///< Stabilization quality of the pitch axis, from main.cpp
+
+/** @brief A request body being received into a reply slot
+*/
+struct PendingBody
+{
+    AsyncWebServerRequest* request;     ///< The request, or @c NULL if this entry is free
+    ResponseSlot* slot;                 ///< Where the body is being put
+};
+
+static PendingBody pending[RESPONSE_SLOTS];     ///< Bodies which haven't been handled yet
+
+
+/** @brief   Send a reply whose text is a constant.
+ *  @param   request The request being answered
+ *  @param   code HTTP status code of the reply
+ *  @param   json The reply
+ */
+static void send_const (AsyncWebServerRequest* request, int code, const char* json)
+{
+    request->send (request->beginResponse_P (code, "application/json", (const uint8_t*)json, strlen (json)));
+}
+
+/** @brief   Find the entry for a request's body.
+ *  @param   request The request, or @c NULL to find a free entry
+ *  @returns The entry, or @c NULL if there is none
+ */
+static PendingBody* find_body (AsyncWebServerRequest* request)
+{
+    for (uint8_t index = 0; index < RESPONSE_SLOTS; index++)
+    {
+        if (pending[index].request == request)
+        {
+            return &pending[index];
+        }
+    }
+    return NULL;
+}
+
+/** @brief   Free the entry for a body, if it is still in the table.
+ *  @param   slot The slot the body was put in
+ */
+static void forget_body (ResponseSlot* slot)
+{
+    for (uint8_t index = 0; index < RESPONSE_SLOTS; index++)
+    {
+        if (pending[index].slot == slot)
+        {
+            pending[index].request = NULL;
+            pending[index].slot = NULL;
+        }
+    }
+}
+
+/** @brief   Callback which puts each piece of a request body into a reply slot.
+ *  @details Bodies which are too long, or which arrive when no slot is free,
+ *           are dropped here; the request handler then replies with the error.
+ *  @param   request The request
+ *  @param   data The piece of the body
+ *  @param   length Number of bytes in the piece
+ *  @param   index Offset of the piece within the body
+ *  @param   total Length of the whole body
+ */
+static void collect_body (AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total)
+{
+    if (total > API_BODY_MAX)
+    {
+        return;
+    }
+    PendingBody* entry = find_body (request);
+    if (entry == NULL && index == 0)
+    {
+        entry = find_body (NULL);
+        ResponseSlot* slot = entry ? response_acquire () : NULL;
+        if (slot == NULL)
+        {
+            return;
+        }
+        entry->request = request;
+        entry->slot = slot;
+        request->onDisconnect ([slot] () { forget_body (slot); response_release (slot); });
+    }
+    if (entry && index + length <= API_BODY_MAX)
+    {
+        memcpy (entry->slot->data + index, data, length);
+    }
+}
+
+/** @brief   Take the body of a request from the table, or reply with the error.
+ *  @details The slot stays claimed until the client goes away, so the reply
+ *           can be rendered into it once the body has been read.
+ *  @param   request The request
+ *  @returns The slot holding the body, or @c NULL if the request has been answered
+ */
+static ResponseSlot* take_body (AsyncWebServerRequest* request)
+{
+    size_t length = request->contentLength ();
+    PendingBody* entry = find_body (request);
+    if (length == 0)
+    {
+        send_const (request, 400, API_ERROR ("Body required"));
+        return NULL;
+    }
+    if (length > API_BODY_MAX)
+    {
+        send_const (request, 413, API_ERROR ("Body too long"));
+        return NULL;
+    }
+    if (entry == NULL)
+    {
+        send_const (request, 503, API_ERROR ("Busy"));
+        return NULL;
+    }
+    ResponseSlot* slot = entry->slot;
+    entry->request = NULL;
+    entry->slot = NULL;
+    return slot;
+}
+
+/** @brief   Write the status of the gimbal as a JSON object.
+ *  @param   out The device to which the object is written
+ */
+static void status_json (Print& out)
+{
+    JsonWriter json (out);
+    json.begin_object ();
+    json.value ("uptime_ms", millis ());
+    json.value ("mode", gimbal_mode_name (gimbal_mode ()));
+    json.value ("calibrating", gimbal_calibrating ());
+
+    AttitudeSample sample;
+    json.begin_object ("attitude");
+    if (attitude.get (sample))
+    {
+        json.value ("pitch", sample.pitch);
+        json.value ("roll", sample.roll);
+        json.value ("sequence", sample.sequence);
+        json.value ("age_us", micros () - sample.time_us);
+    }
+    json.end_object ();
+
+    json.begin_object ("health");
+    json.value ("state", supervisor_state_name (supervisor_state ()));
+    json.value ("motors_enabled", supervisor_motors_enabled ());
+    json.end_object ();
+
+    const LatencyHistogram& total = pipeline_stats.stage (STAGE_TOTAL);
+    json.begin_object ("loop");
+    json.value ("rate_hz", CONTROL_RATE_HZ);
+    json.value ("samples", total.get_count ());
+    json.value ("latency_mean_us", total.get_mean ());
+    json.value ("latency_p99_us", total.percentile (99));
+    json.value ("latency_max_us", total.get_max ());
+    json.value ("dropped", pipeline_stats.get_dropped ());
+    json.end_object ();
+
+    json.begin_object ("quality");
+    pitch_quality.json (json);
+    json.end_object ();
+
+    json.begin_array ("cpu_load");
+    for (uint8_t core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        json.value (NULL, core_load_percent (core));
+    }
+    json.end_array ();
+    json.end_object ();
+}
+
+/** @brief   Write the operating mode and the modes to choose from as a JSON object.
+ *  @param   out The device to which the object is written
+ */
+static void mode_json (Print& out)
+{
+    JsonWriter json (out);
+    json.begin_object ();
+    json.value ("mode", gimbal_mode_name (gimbal_mode ()));
+    json.begin_array ("modes");
+    for (uint8_t index = 0; index < NUM_MODES; index++)
+    {
+        json.value (NULL, gimbal_mode_name ((GimbalMode)index));
+    }
+    json.end_array ();
+    json.end_object ();
+}
+
+/** @brief   Callback function which changes some of the settings.
+ *  @param   request The request being answered
+ */
+static void handle_config_put (AsyncWebServerRequest* request)
+{
+    ResponseSlot* slot = take_body (request);
+    if (slot == NULL)
+    {
+        return;
+    }
+    JsonReader body ((const char*)slot->data, request->contentLength ());
+    const char* problem = gimbal_config_apply (body);
+
+    // The body has been read, so the reply can overwrite it
+    BufferPrint out (slot->data, sizeof (slot->data));
+    if (problem)
+    {
+        JsonWriter (out).begin_object ().value ("error", problem).end_object ();
+        send_slot (request, 400, "application/json", out);
+        return;
+    }
+    gimbal_config_json (out);
+    send_slot (request, 200, "application/json", out);
+}
+
+/** @brief   Callback function which changes the operating mode.
+ *  @param   request The request being answered
+ */
+static void handle_mode_put (AsyncWebServerRequest* request)
+{
+    ResponseSlot* slot = take_body (request);
+    if (slot == NULL)
+    {
+        return;
+    }
+    JsonReader body ((const char*)slot->data, request->contentLength ());
+    JsonMember member;
+    GimbalMode mode = NUM_MODES;
+    while (body.next (member))
+    {
+        if (!member.key_is ("mode") || !gimbal_mode_parse (member, mode))
+        {
+            send_const (request, 400, API_ERROR ("Expected one mode; see GET /api/v1/mode"));
+            return;
+        }
+    }
+    if (!body.ok () || mode == NUM_MODES)
+    {
+        send_const (request, 400, API_ERROR ("Expected one mode; see GET /api/v1/mode"));
+        return;
+    }
+    gimbal_set_mode (mode);
+
+    BufferPrint out (slot->data, sizeof (slot->data));
+    mode_json (out);
+    send_slot (request, 200, "application/json", out);
+}
+
+/** @brief   Callback function which asks for the IMU to be recalibrated.
+ *  @param   request The request being answered
+ */
+static void handle_calibrate (AsyncWebServerRequest* request)
+{
+    if (gimbal_calibrate_request ())
+    {
+        send_const (request, 202, "{\"calibrating\":true}");
+    }
+    else
+    {
+        send_const (request, 409, API_ERROR ("Calibration already under way"));
+    }
+}
+
+/** @brief   Callback function which lists the black-box recordings, or downloads one.
+ *  @details With @c ?id=N the recording with that number is sent as a file.
+ *  @param   request The request being answered
+ */
+static void handle_blackbox_get (AsyncWebServerRequest* request)
+{
+    if (!request->hasParam ("id"))
+    {
+        send_report (request, "application/json", blackbox_json);
+        return;
+    }
+    char path[24];
+    uint32_t id = request->getParam ("id")->value ().toInt ();
+    if (!blackbox_file_path (id, path, sizeof (path)))
+    {
+        send_const (request, 404, API_ERROR ("No such recording"));
+        return;
+    }
+    request->send (LittleFS, path, "application/octet-stream", true);
+}
+
+/** @brief   Callback function which starts a black-box recording.
+ *  @param   request The request being answered
+ */
+static void handle_blackbox_post (AsyncWebServerRequest* request)
+{
+    if (blackbox_trigger (BB_MANUAL))
+    {
+        send_const (request, 202, "{\"recording\":true}");
+    }
+    else
+    {
+        send_const (request, 409, API_ERROR ("Black box busy or disabled"));
+    }
+}
+
+/** @brief   Callback function which lists the flash log segments, or downloads one.
+ *  @details With @c ?segment=N that segment is sent as a file, once it is complete.
+ *  @param   request The request being answered
+ */
+static void handle_log_get (AsyncWebServerRequest* request)
+{
+    if (!request->hasParam ("segment"))
+    {
+        send_report (request, "application/json", flash_log_json);
+        return;
+    }
+    char path[24];
+    uint32_t id = request->getParam ("segment")->value ().toInt ();
+    if (!flash_log_segment_path (id, path, sizeof (path)))
+    {
+        send_const (request, 404, API_ERROR ("No such segment"));
+        return;
+    }
+    if (flash_log_segment_open (id))
+    {
+        send_const (request, 409, API_ERROR ("Segment still being written"));
+        return;
+    }
+    request->send (LittleFS, path, "application/octet-stream", true);
+}
+
+/** @brief   Callback function which lists the gyro log takes, or downloads one.
+ *  @details With @c ?take=N that take is sent as a file, once it has stopped.
+ *  @param   request The request being answered
+ */
+static void handle_gyro_get (AsyncWebServerRequest* request)
+{
+    if (!request->hasParam ("take"))
+    {
+        send_report (request, "application/json", gyro_log_json);
+        return;
+    }
+    char path[24];
+    uint32_t id = request->getParam ("take")->value ().toInt ();
+    if (!gyro_log_take_path (id, path, sizeof (path)))
+    {
+        send_const (request, 404, API_ERROR ("No such take"));
+        return;
+    }
+    if (gyro_log_take_open (id))
+    {
+        send_const (request, 409, API_ERROR ("Take still being recorded"));
+        return;
+    }
+    request->send (LittleFS, path, "application/octet-stream", true);
+}
+
+/** @brief   Callback function which starts or stops recording a gyro log take.
+ *  @param   request The request being answered
+ */
+static void handle_gyro_put (AsyncWebServerRequest* request)
+{
+    ResponseSlot* slot = take_body (request);
+    if (slot == NULL)
+    {
+        return;
+    }
+    JsonReader body ((const char*)slot->data, request->contentLength ());
+    JsonMember member;
+    bool found = false;
+    bool recording = false;
+    while (body.next (member))
+    {
+        found = member.key_is ("recording") && member.type == JSON_BOOL;
+        if (!found)
+        {
+            break;
+        }
+        recording = member.flag;
+    }
+    if (!body.ok () || !found)
+    {
+        send_const (request, 400, API_ERROR ("Expected {\"recording\":true} or {\"recording\":false}"));
+        return;
+    }
+    if (!gyro_log_record (recording))
+    {
+        send_const (request, 409, API_ERROR ("Flash is not available"));
+        return;
+    }
+
+    BufferPrint out (slot->data, sizeof (slot->data));
+    JsonWriter (out).begin_object ().value ("recording", recording).end_object ();
+    send_slot (request, 200, "application/json", out);
+}
+
+/** @brief   Register the API's routes with the web server.
+ *  @param   server The web server which will answer API requests
+ */
+void api_attach (AsyncWebServer& server)
+{
+    server.on ("/api/v1/status", HTTP_GET, [] (AsyncWebServerRequest* request)
+        { send_report (request, "application/json", status_json); });
+    server.on ("/api/v1/config", HTTP_GET, [] (AsyncWebServerRequest* request)
+        { send_report (request, "application/json", gimbal_config_json); });
+    server.on ("/api/v1/config", HTTP_PUT, handle_config_put, NULL, collect_body);
+    server.on ("/api/v1/mode", HTTP_GET, [] (AsyncWebServerRequest* request)
+        { send_report (request, "application/json", mode_json); });
+    server.on ("/api/v1/mode", HTTP_PUT, handle_mode_put, NULL, collect_body);
+    server.on ("/api/v1/calibrate", HTTP_POST, handle_calibrate);
+    server.on ("/api/v1/blackbox", HTTP_GET, handle_blackbox_get);
+    server.on ("/api/v1/blackbox", HTTP_POST, handle_blackbox_post);
+    server.on ("/api/v1/log", HTTP_GET, handle_log_get);
+    server.on ("/api/v1/gyro", HTTP_GET, handle_gyro_get);
+    server.on ("/api/v1/gyro", HTTP_PUT, handle_gyro_put, NULL, collect_body);
+    server.on ("/api/v1/sync", HTTP_GET, [] (AsyncWebServerRequest* request)
+        { send_report (request, "application/json", frame_sync_json); });
+    server.on ("/api/v1/trends", HTTP_GET, [] (AsyncWebServerRequest* request)
+        { send_report (request, "application/json", rolling_stats_json); });
+}
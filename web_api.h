@@ -0,0 +1,51 @@
+/** @file web_api.h
+ * This is the header file for the REST API, which lets tools monitor and tune
+ * the gimbal without reflashing it. All replies are JSON:
+ * 
+ * - @c GET @c /api/v1/status: attitude, supervisor health, loop timing,
+ *   stabilization quality and CPU load.
+ * - @c GET @c /api/v1/config: the settings listed in @c CONFIG_FIELDS.
+ * - @c PUT @c /api/v1/config: change the settings named in a flat JSON
+ *   object, e.g. @c {"kp":12,"smoothing":2}; the reply is the new settings.
+ * - @c GET and @c PUT @c /api/v1/mode: the operating mode, e.g.
+ *   @c {"mode":"idle"}; see @c GIMBAL_MODES.
+ * - @c POST @c /api/v1/calibrate: recalibrate the IMU; 202 once started, 409
+ *   if one is already under way.
+ * - @c GET @c /api/v1/trends: the latest finished 1 s, 10 s and 1 min windows
+ *   of the rolling statistics; the history of each level is at
+ *   @c /trends.csv?level=1min and so on.
+ * - @c GET @c /api/v1/blackbox: state of the black-box recorder and the
+ *   recordings in flash; @c ?id=N downloads recording N as a binary file,
+ *   which tools/blackbox_csv.py turns into CSV.
+ * - @c POST @c /api/v1/blackbox: save a black-box recording now; 202 once
+ *   started, 409 if one is already under way.
+ * - @c GET @c /api/v1/log: the flash log's counters and segments;
+ *   @c ?segment=N downloads segment N once it is complete, for
+ *   tools/flash_log_csv.py.
+ * - @c GET @c /api/v1/gyro: the gyro log and its takes; @c ?take=N downloads
+ *   take N once it has stopped, for tools/gyroflow_export.py.
+ * - @c PUT @c /api/v1/gyro: start or stop a take with @c {"recording":true}
+ *   or @c {"recording":false}; 409 if flash isn't available.
+ * - @c GET @c /api/v1/sync: camera frame sync edge counts and the most
+ *   recent edges as @c [number,time_us], for tools/sync_align.py.
+ * 
+ * Errors are replied as @c {"error":"..."} with a 4xx or 5xx code. Request
+ * bodies are collected into a reply slot and the reply is rendered into the
+ * same slot, so the API uses no heap for its content.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _WEB_API_
+#define _WEB_API_
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+const size_t API_BODY_MAX = 512;            ///< Longest request body accepted
+
+void api_attach (AsyncWebServer& server);
+
+#endif
@@ -0,0 +1,176 @@
+/** @file web_pages.h
+ * This file holds the static web pages, gzip-compressed, so they can be
+ * served straight from flash. It is generated by tools/gen_web_pages.py
+ * from the files in web/; edit those and regenerate, don't edit this file.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _WEB_PAGES_
+#define _WEB_PAGES_
+
+#include <Arduino.h>
+
+/** @brief A static file served by the web server
+*/
+struct WebPage
+{
+    const char* path;       ///< URL of the file
+    const char* type;       ///< MIME type of the file
+    const uint8_t* data;    ///< The file, gzip-compressed
+    size_t length;          ///< Length of @c data
+};
+
+/// index.html: 5251 bytes, 2191 gzipped
+static const uint8_t page_index_html[] PROGMEM =
+{
+    0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9D, 0x58, 0x7B, 0x73, 0xDB, 0x36,
+    0x12, 0xFF, 0x5F, 0x9F, 0x02, 0x45, 0x27, 0x57, 0xAA, 0x96, 0x28, 0xC9, 0x4D, 0x72, 0x19, 0xEB,
+    0x91, 0x71, 0x6D, 0xCF, 0x39, 0x9D, 0xB8, 0xF6, 0x58, 0x4A, 0xEF, 0x6E, 0x1C, 0x8F, 0x07, 0x22,
+    0x21, 0x09, 0x67, 0x92, 0xE0, 0x01, 0xA0, 0x64, 0xC5, 0xF5, 0x77, 0xBF, 0x5D, 0x00, 0x7C, 0x98,
+    0x17, 0x37, 0xBD, 0xD3, 0x78, 0x4C, 0x71, 0xB1, 0xBB, 0xD8, 0x5D, 0xFC, 0xF6, 0x01, 0x4D, 0xBE,
+    0x3B, 0xBD, 0x3C, 0x59, 0xFC, 0xF3, 0xEA, 0x8C, 0x6C, 0x4C, 0x9A, 0xCC, 0x3A, 0x93, 0xF2, 0xC1,
+    0x59, 0x0C, 0x8F, 0x94, 0x1B, 0x46, 0x32, 0x96, 0xF2, 0x29, 0xDD, 0x0A, 0xBE, 0xCB, 0xA5, 0x32,
+    0x94, 0x44, 0x32, 0x33, 0x3C, 0x33, 0x53, 0xBA, 0x13, 0xB1, 0xD9, 0x4C, 0x63, 0xBE, 0x15, 0x11,
+    0xEF, 0xDB, 0x97, 0x1E, 0x11, 0x99, 0x30, 0x82, 0x25, 0x7D, 0x1D, 0xB1, 0x84, 0x4F, 0x47, 0xE1,
+    0xB0, 0x47, 0x0A, 0xCD, 0x95, 0x7D, 0x67, 0x4B, 0x20, 0x65, 0x92, 0x82, 0x62, 0x23, 0x4C, 0xC2,
+    0x67, 0x17, 0x67, 0xE4, 0xCD, 0xF0, 0xAF, 0xE4, 0x84, 0xA5, 0x64, 0x6E, 0xD8, 0x52, 0x24, 0xE2,
+    0x0B, 0x57, 0x93, 0x81, 0x5B, 0xEC, 0x4C, 0xB4, 0xD9, 0xE3, 0x13, 0x4D, 0x22, 0x8F, 0x64, 0x05,
+    0xDB, 0xF6, 0x57, 0x2C, 0x15, 0xC9, 0xFE, 0x88, 0x9C, 0xF3, 0x64, 0xCB, 0x8D, 0x88, 0xD8, 0x98,
+    0xC4, 0x42, 0xE7, 0x09, 0x03, 0x9A, 0xC8, 0x12, 0x91, 0xF1, 0xFE, 0x32, 0x91, 0xD1, 0xFD, 0x98,
+    0xA4, 0x4C, 0xAD, 0x45, 0x76, 0x44, 0x86, 0xF9, 0x03, 0x61, 0x85, 0x91, 0x63, 0x62, 0xF8, 0x83,
+    0xE9, 0xB3, 0x44, 0xAC, 0x81, 0x1A, 0x81, 0x03, 0x5C, 0x8D, 0xC9, 0x53, 0x67, 0x29, 0xE3, 0x3D,
+    0x68, 0x77, 0xEC, 0x7D, 0x23, 0xF3, 0x23, 0xB0, 0x29, 0x7F, 0xC0, 0xA5, 0xCD, 0x08, 0x16, 0x22,
+    0x99, 0x48, 0x75, 0x44, 0xBE, 0x7F, 0x0D, 0x9F, 0xE3, 0xE3, 0x5A, 0xEF, 0x9B, 0x52, 0x31, 0xF9,
+    0xC9, 0xB3, 0xE7, 0xA5, 0x91, 0x1A, 0xDC, 0x38, 0x22, 0x87, 0xAF, 0x91, 0x5C, 0x8A, 0x1F, 0xDA,
+    0x4F, 0x29, 0xDE, 0x5F, 0x4A, 0x63, 0x64, 0x7A, 0x44, 0x46, 0x5E, 0x36, 0x62, 0xD9, 0x96, 0x69,
+    0x50, 0xB0, 0x94, 0x2A, 0xE6, 0x20, 0x30, 0x02, 0xED, 0x5A, 0x26, 0x22, 0x26, 0xDF, 0x1F, 0xDB,
+    0x0F, 0x8A, 0x3E, 0xB8, 0x28, 0xA3, 0xD8, 0xF0, 0x15, 0x8A, 0xB1, 0x1E, 0x59, 0x16, 0xA0, 0x29,
+    0xAB, 0x3C, 0x00, 0x87, 0xC9, 0x3B, 0xA7, 0xD3, 0x60, 0xBC, 0x1B, 0x0B, 0xA3, 0x3A, 0x14, 0x4F,
+    0x1D, 0x91, 0xE5, 0x85, 0x81, 0x45, 0xAF, 0xF0, 0x0D, 0x4F, 0x91, 0x3A, 0x19, 0xF8, 0x98, 0x4F,
+    0x06, 0x1E, 0x01, 0x18, 0x1E, 0xC4, 0xC3, 0xE8, 0xA5, 0xC3, 0x82, 0x95, 0xCE, 0x2F, 0xCC, 0x6C,
+    0x8A, 0x8C, 0xCC, 0x65, 0xCA, 0x74, 0x91, 0xC5, 0x4C, 0xB1, 0xB4, 0x33, 0xC9, 0x67, 0x57, 0xC2,
+    0x44, 0xA0, 0x7B, 0xA2, 0x73, 0x96, 0x11, 0x11, 0x4F, 0x69, 0x8E, 0x04, 0x3A, 0xEB, 0xC3, 0x36,
+    0x40, 0x9A, 0x91, 0x98, 0xAF, 0x7B, 0x44, 0x73, 0x93, 0x4B, 0x91, 0x99, 0x06, 0x5F, 0x49, 0x6A,
+    0xB3, 0xF2, 0xD5, 0x0A, 0x10, 0xD8, 0x60, 0x74, 0x84, 0x9A, 0x6D, 0x32, 0xC8, 0x67, 0xB8, 0xF3,
+    0x44, 0xA7, 0x2C, 0x49, 0x2C, 0x0B, 0x60, 0xE2, 0x9E, 0xCE, 0x4E, 0x64, 0x96, 0xF1, 0xC8, 0x88,
+    0x6C, 0x1D, 0x86, 0x21, 0x30, 0xE3, 0xB2, 0xE7, 0xF6, 0xA1, 0xB7, 0xF6, 0x25, 0x12, 0xF0, 0xED,
+    0x60, 0x4D, 0xDF, 0x0E, 0x87, 0x94, 0x6C, 0xB8, 0x58, 0x6F, 0x00, 0xEA, 0x87, 0xF0, 0x02, 0xFC,
+    0x8E, 0xB7, 0xBD, 0x85, 0x36, 0xCC, 0x14, 0xDA, 0x59, 0xD1, 0x50, 0x9C, 0xCF, 0x2E, 0x64, 0xCC,
+    0x9B, 0xFE, 0xA7, 0xF0, 0xAE, 0x51, 0x8F, 0xF3, 0x69, 0xE2, 0xCF, 0x4E, 0x66, 0x51, 0x22, 0xA2,
+    0xFB, 0x29, 0x85, 0x1C, 0x11, 0x4B, 0xC5, 0x0C, 0x0F, 0xBA, 0x60, 0x72, 0xF9, 0x32, 0x19, 0x38,
+    0x3E, 0xAF, 0x16, 0x3C, 0x4E, 0xAD, 0x36, 0xC8, 0xC3, 0x95, 0x58, 0x53, 0x10, 0xD7, 0xC5, 0x32,
+    0x15, 0x60, 0xA5, 0x66, 0x5B, 0x10, 0x1D, 0x13, 0xC5, 0x4D, 0xA1, 0x32, 0xB2, 0x62, 0x89, 0xE6,
+    0x63, 0x9B, 0x6E, 0x16, 0x0A, 0x3E, 0xB4, 0x18, 0x05, 0x6B, 0x85, 0xA5, 0xE2, 0x19, 0x3B, 0x33,
+    0xCC, 0x3E, 0x87, 0x3C, 0x77, 0xBA, 0xE8, 0xEC, 0x38, 0xCF, 0x93, 0x3D, 0x29, 0xD9, 0x2B, 0x1B,
+    0x48, 0xD3, 0x6F, 0xD8, 0x2E, 0xB6, 0xEE, 0x58, 0xAF, 0x01, 0x34, 0x68, 0x9B, 0xF5, 0xBC, 0x33,
+    0x61, 0x64, 0xA3, 0xF8, 0x6A, 0x4A, 0x07, 0x91, 0xDE, 0xD2, 0xD9, 0x82, 0x27, 0x1C, 0x8A, 0x89,
+    0xDA, 0x93, 0x93, 0xF9, 0x6F, 0x93, 0x01, 0x6B, 0x31, 0xBC, 0xB7, 0xC7, 0xAD, 0xA7, 0x10, 0xF3,
+    0xBF, 0xB0, 0x34, 0x1F, 0x03, 0xEB, 0x46, 0xC6, 0xD3, 0x54, 0x64, 0x00, 0xFA, 0xA6, 0x34, 0xCF,
+    0xB6, 0x3C, 0x91, 0x39, 0x6F, 0xA9, 0x30, 0x8A, 0x45, 0x1C, 0xF8, 0xF0, 0xD1, 0x5A, 0x4A, 0x24,
+    0x03, 0x1B, 0x3F, 0xC2, 0xFF, 0xD6, 0x02, 0x9E, 0x1A, 0x84, 0xE1, 0xE4, 0xEA, 0x53, 0x5B, 0x02,
+    0x62, 0x9E, 0x45, 0x7B, 0x10, 0x72, 0x5F, 0x5A, 0xCB, 0x29, 0x4F, 0xA5, 0x82, 0xD5, 0x0B, 0xFB,
+    0x6C, 0x2D, 0x42, 0xD6, 0x24, 0x06, 0x20, 0x7E, 0x6E, 0x9F, 0xAD, 0xC5, 0xA5, 0x04, 0x78, 0xCD,
+    0x7E, 0x86, 0xFF, 0x6E, 0xC1, 0x1E, 0xA7, 0x8E, 0x94, 0xC8, 0xCD, 0xAC, 0x33, 0x18, 0x90, 0x8F,
+    0x62, 0xCB, 0x89, 0xCD, 0x11, 0x82, 0x48, 0x24, 0x2B, 0x25, 0x53, 0x62, 0x36, 0x9C, 0x2C, 0x45,
+    0xC6, 0xC0, 0x79, 0x53, 0x85, 0x41, 0x1B, 0xC5, 0x19, 0x64, 0xAC, 0xE6, 0xBC, 0xA6, 0xDE, 0x39,
+    0x6A, 0xB8, 0xE9, 0x6C, 0x99, 0x22, 0xE7, 0x67, 0xC7, 0xA7, 0x67, 0xD7, 0x64, 0x4A, 0xDE, 0xF5,
+    0xC8, 0xF5, 0xD9, 0xC9, 0xE5, 0xF5, 0x29, 0x7C, 0x3F, 0x84, 0x72, 0x7C, 0x75, 0xF9, 0xE1, 0xD7,
+    0xC5, 0x1C, 0x5E, 0x20, 0xD8, 0x63, 0xCB, 0xCA, 0xB2, 0x75, 0xC2, 0x35, 0x50, 0x6E, 0x6E, 0xEB,
+    0x74, 0x74, 0xEF, 0x8E, 0xC1, 0x5A, 0x33, 0x25, 0xB1, 0x8C, 0x8A, 0x14, 0x0A, 0x67, 0xB8, 0xE6,
+    0xE6, 0x0C, 0x37, 0xCD, 0xCC, 0xCF, 0xFB, 0x0F, 0x71, 0xE0, 0xF2, 0xA6, 0x8B, 0xE4, 0x13, 0xEC,
+    0x0D, 0x0F, 0x26, 0xA0, 0x87, 0x31, 0xED, 0x8E, 0x3B, 0x9D, 0x55, 0x91, 0x41, 0xD6, 0x01, 0xB8,
+    0x62, 0xC5, 0x76, 0x41, 0x97, 0x3C, 0x76, 0x88, 0xD5, 0x16, 0x46, 0x09, 0x67, 0xEA, 0x1A, 0x52,
+    0x32, 0x00, 0x93, 0xE0, 0x0F, 0x8C, 0xE9, 0x81, 0x79, 0x43, 0x10, 0x22, 0xE4, 0xE6, 0xC6, 0x99,
+    0xD4, 0x23, 0xD4, 0xD7, 0x5D, 0x0A, 0x96, 0xDD, 0x54, 0xA6, 0x21, 0xFD, 0xF8, 0x18, 0x57, 0xE8,
+    0xED, 0x6D, 0x08, 0xA0, 0x3B, 0x63, 0xD1, 0x26, 0xA8, 0xF6, 0x0A, 0x2C, 0x1C, 0xDC, 0x66, 0x7E,
+    0x3B, 0x08, 0x8D, 0xBC, 0xE7, 0x73, 0x2C, 0x6E, 0xE0, 0x88, 0x5D, 0xBF, 0x19, 0xDD, 0x8E, 0x6B,
+    0x86, 0x25, 0x87, 0x1A, 0x79, 0x05, 0x75, 0x2C, 0xE8, 0x3A, 0xAA, 0xE3, 0x19, 0x7E, 0x4D, 0xFD,
+    0x16, 0xDA, 0x1C, 0x68, 0x77, 0x82, 0xD8, 0x73, 0x16, 0x32, 0x10, 0x3D, 0x2C, 0xCA, 0xA4, 0x4F,
+    0x0E, 0xC9, 0x8F, 0x64, 0x0B, 0x39, 0xF8, 0xD4, 0x1D, 0xB7, 0xB7, 0x77, 0xAA, 0x71, 0xE1, 0xA9,
+    0x11, 0x99, 0xC8, 0x95, 0x26, 0x1F, 0x1C, 0x0C, 0xF7, 0x0E, 0x63, 0x9F, 0xF1, 0x1D, 0xF9, 0x3B,
+    0x5F, 0xCE, 0xA1, 0x99, 0x71, 0x88, 0xE7, 0x4E, 0x1F, 0x0D, 0x06, 0x94, 0x1C, 0x10, 0xE8, 0x6E,
+    0x0C, 0xE5, 0xC2, 0x8D, 0xD4, 0x06, 0xDE, 0xE9, 0x60, 0xA7, 0xA9, 0x55, 0xBC, 0xD3, 0xA1, 0x03,
+    0xCA, 0x02, 0x12, 0x19, 0x34, 0x50, 0xA6, 0x14, 0xDB, 0x2F, 0x8B, 0xD5, 0x8A, 0x2B, 0xEA, 0x19,
+    0x64, 0x06, 0xC9, 0x93, 0xC1, 0x62, 0xED, 0x0D, 0x7A, 0x02, 0x2B, 0x9A, 0x67, 0x70, 0x92, 0x58,
+    0x6F, 0xA6, 0x6F, 0x86, 0x14, 0x1D, 0xA8, 0x44, 0xA2, 0x44, 0x6A, 0xDE, 0x96, 0xB1, 0xCE, 0xBD,
+    0x88, 0x08, 0x5B, 0x75, 0xBB, 0x21, 0x62, 0xE1, 0xC4, 0x8D, 0x0B, 0x68, 0xD0, 0xA9, 0xD0, 0xDE,
+    0x5B, 0x1E, 0xF7, 0xB0, 0x4A, 0xA9, 0xBD, 0xAB, 0xC8, 0xD4, 0xC5, 0x0A, 0x0E, 0x78, 0x21, 0x52,
+    0x2E, 0x0B, 0x13, 0x78, 0x3E, 0x8B, 0x09, 0x07, 0x8A, 0xDA, 0x9E, 0x94, 0x6B, 0xCD, 0xD6, 0xCF,
+    0x2D, 0xE2, 0x5B, 0xD8, 0xA3, 0x34, 0x0B, 0x83, 0x18, 0x33, 0x18, 0x5D, 0x5C, 0x18, 0x4F, 0xE1,
+    0xEB, 0x6F, 0x30, 0xBE, 0x38, 0xA6, 0x10, 0x57, 0xFC, 0xE1, 0x20, 0x63, 0x24, 0x0B, 0x6B, 0x1D,
+    0x92, 0xD1, 0x8F, 0x4F, 0x80, 0xB0, 0x77, 0xC1, 0xC8, 0x73, 0xC0, 0xE9, 0xC3, 0x81, 0x03, 0x9B,
+    0x00, 0x96, 0xE1, 0x18, 0x1E, 0x13, 0x27, 0x01, 0x5F, 0x0F, 0x0E, 0xCA, 0x0D, 0x9D, 0x26, 0x86,
+    0x6A, 0x7C, 0xDE, 0x1D, 0x00, 0xE7, 0x8F, 0x3E, 0xF1, 0xC6, 0x9E, 0xC7, 0x81, 0x3A, 0xCC, 0x0B,
+    0xBD, 0x09, 0xCA, 0xDD, 0x3E, 0x64, 0x66, 0xF4, 0x36, 0x60, 0x78, 0x92, 0x90, 0xA8, 0x46, 0x15,
+    0xBC, 0xDB, 0x2D, 0xF9, 0x2B, 0xBC, 0xBF, 0x28, 0x32, 0x3A, 0x7C, 0x2E, 0xF3, 0x54, 0x79, 0x95,
+    0x30, 0xFD, 0xCC, 0x9A, 0xC0, 0xB9, 0xD9, 0x27, 0xA3, 0x6E, 0xCB, 0x2E, 0xB1, 0x2A, 0x17, 0x67,
+    0x64, 0x58, 0x3B, 0xF4, 0x72, 0xB2, 0xDB, 0x26, 0xDE, 0x3E, 0xDB, 0xE7, 0xC6, 0xD9, 0xDD, 0x6B,
+    0x8F, 0xC6, 0xDF, 0xD2, 0x59, 0x35, 0xFC, 0x3F, 0xA5, 0xB6, 0xF2, 0xFA, 0x9B, 0x7A, 0xFD, 0x7C,
+    0xF0, 0xE7, 0xB4, 0xBE, 0x7D, 0xA6, 0xD5, 0x85, 0xB2, 0x2A, 0x8D, 0xFE, 0xEC, 0x34, 0x34, 0x6A,
+    0x1E, 0xF4, 0x5D, 0x0D, 0xED, 0x56, 0xA8, 0xAD, 0x2A, 0x66, 0x7D, 0x64, 0x5F, 0xE3, 0xFC, 0x9F,
+    0xD2, 0xC5, 0xFB, 0x46, 0xE7, 0xB6, 0xAA, 0x43, 0x9E, 0x10, 0x80, 0x2F, 0xD4, 0x7E, 0x2C, 0x02,
+    0x4D, 0xAC, 0x82, 0x07, 0x65, 0x3C, 0xB0, 0x1C, 0xD8, 0xF1, 0x5C, 0xC9, 0x84, 0x44, 0xFB, 0xC8,
+    0x95, 0x50, 0x72, 0x50, 0x86, 0xA9, 0x21, 0xF5, 0xD3, 0x61, 0xF0, 0xBA, 0x29, 0xA5, 0x78, 0x04,
+    0x93, 0xA7, 0x86, 0x3A, 0x2D, 0xF3, 0x1C, 0xBA, 0xBA, 0x37, 0xD8, 0x56, 0x6D, 0x9F, 0x7D, 0x30,
+    0xA5, 0x96, 0xA5, 0x0A, 0x2A, 0x3B, 0xF4, 0xAB, 0xB9, 0x9D, 0x7B, 0x7A, 0x04, 0xC7, 0x1A, 0x08,
+    0x50, 0x5C, 0x4D, 0x0B, 0xD0, 0xB4, 0x94, 0x2C, 0xD6, 0x1B, 0xDB, 0xBC, 0xAE, 0xCF, 0xE6, 0x0B,
+    0x72, 0x7C, 0xF5, 0xC1, 0x75, 0xAB, 0x1D, 0x5F, 0xDE, 0xB1, 0x5C, 0x40, 0x93, 0xAA, 0x72, 0x17,
+    0x5E, 0x03, 0xD7, 0xF0, 0x7B, 0x24, 0x67, 0x78, 0x89, 0xC0, 0xA1, 0xB3, 0x07, 0xD1, 0xCA, 0x78,
+    0x5D, 0x14, 0x15, 0xFF, 0x77, 0xC1, 0x2D, 0xA6, 0x31, 0xA5, 0xFF, 0x71, 0xF1, 0xF1, 0xDC, 0x98,
+    0xFC, 0xDA, 0x11, 0x9D, 0x89, 0x9E, 0x23, 0xC4, 0x0A, 0x57, 0x29, 0xA4, 0x03, 0x50, 0x3F, 0xD8,
+    0x8E, 0x6C, 0xED, 0x44, 0xED, 0xCF, 0x59, 0x33, 0x1C, 0x0F, 0xFE, 0xAB, 0x1C, 0xE2, 0xCE, 0xC1,
+    0x2F, 0xF3, 0xCB, 0x5F, 0xC3, 0x9C, 0x29, 0xCD, 0x83, 0x92, 0x5D, 0x71, 0x9D, 0xC3, 0xB4, 0xC5,
+    0x17, 0x70, 0x4E, 0xDD, 0x5E, 0xA5, 0xC5, 0xCD, 0x7F, 0x65, 0xC9, 0xAC, 0xA8, 0x58, 0x50, 0xED,
+    0xED, 0x62, 0x3A, 0x9D, 0x12, 0x18, 0x8B, 0xF9, 0x0A, 0x5A, 0x45, 0x4C, 0xDE, 0x93, 0xAC, 0x80,
+    0x01, 0xEA, 0x88, 0xD8, 0x0D, 0xA0, 0x33, 0x40, 0xC4, 0xC4, 0x6A, 0x6F, 0x59, 0xBB, 0xAD, 0xDE,
+    0x90, 0xCB, 0x24, 0xF1, 0xC5, 0x16, 0xA3, 0x44, 0xFF, 0x76, 0xB6, 0xA0, 0xE0, 0x93, 0x1F, 0x38,
+    0x7B, 0xB5, 0xD6, 0x5E, 0xC3, 0x03, 0xFD, 0xCD, 0xEA, 0xEC, 0xE5, 0x5F, 0x00, 0x1C, 0x4E, 0xAD,
+    0x16, 0x65, 0x3A, 0xB4, 0x27, 0x0B, 0xC5, 0x43, 0x87, 0xE5, 0x68, 0x8A, 0x38, 0x7C, 0x0F, 0xAB,
+    0x41, 0x83, 0xD0, 0xA5, 0xE0, 0x0D, 0xA5, 0x16, 0x48, 0x30, 0x40, 0x14, 0x39, 0x57, 0x5B, 0xA1,
+    0xA1, 0x70, 0x3A, 0x25, 0x6E, 0x26, 0xB2, 0x51, 0xE2, 0x15, 0x16, 0x81, 0x31, 0x91, 0x32, 0xF7,
+    0x2C, 0xF8, 0x35, 0xC4, 0xDE, 0x73, 0xB7, 0xF9, 0x62, 0xE1, 0x78, 0xFE, 0x05, 0xD6, 0xDD, 0xF8,
+    0xD5, 0x64, 0xF1, 0xA4, 0xBB, 0x94, 0xB3, 0xEC, 0xAE, 0xD0, 0x96, 0x15, 0x1E, 0xF8, 0x4A, 0x06,
+    0x0D, 0xA4, 0xB7, 0xD9, 0xD9, 0x43, 0x93, 0x9B, 0x3D, 0xF4, 0x08, 0x8C, 0x7D, 0x5E, 0x71, 0x94,
+    0x17, 0x77, 0x88, 0x82, 0xF0, 0x5F, 0x90, 0xB8, 0x01, 0x7D, 0x85, 0x8A, 0xAC, 0x2B, 0xAF, 0xE8,
+    0xD7, 0xDA, 0xB5, 0xDE, 0xC8, 0xDD, 0x9D, 0x1D, 0xE4, 0x83, 0xB4, 0x46, 0xA7, 0xBD, 0xA3, 0x42,
+    0x87, 0xB3, 0x22, 0xA9, 0x8D, 0x9B, 0xFE, 0xCA, 0xE4, 0x80, 0x57, 0xE9, 0xF2, 0x74, 0xAC, 0xC8,
+    0x01, 0xC8, 0xF8, 0xF9, 0x1B, 0xAD, 0xB1, 0x0C, 0x80, 0x17, 0xAF, 0xC2, 0x46, 0x1A, 0xEE, 0xB7,
+    0x38, 0xA7, 0xC7, 0x55, 0x90, 0xBD, 0x8F, 0x3E, 0x8E, 0xD5, 0xED, 0xE1, 0x33, 0x56, 0x51, 0x6B,
+    0x59, 0xF0, 0x03, 0xEA, 0xB2, 0xAA, 0xC0, 0x8D, 0x1F, 0xBA, 0x9F, 0xE9, 0xAC, 0x49, 0xA8, 0x66,
+    0xF9, 0xCA, 0xBF, 0x3F, 0x80, 0x8A, 0xBB, 0xB2, 0x74, 0x43, 0x01, 0x99, 0xAF, 0xCE, 0x17, 0x17,
+    0x1F, 0xC1, 0x4B, 0xB4, 0xBC, 0x15, 0x94, 0x72, 0x67, 0xEF, 0xA0, 0x43, 0xEB, 0xD5, 0x27, 0x8B,
+    0x56, 0x5C, 0x80, 0xE7, 0xA3, 0xAD, 0x13, 0x47, 0xCE, 0x8C, 0xA7, 0x5E, 0x23, 0x90, 0x98, 0x39,
+    0xCD, 0x81, 0xA8, 0xBE, 0x05, 0xD5, 0xC8, 0xBF, 0xBA, 0x9C, 0x5B, 0x65, 0xD5, 0xE2, 0x4B, 0xE8,
+    0x57, 0xDF, 0x46, 0xBF, 0xBD, 0xB6, 0xB4, 0x7B, 0x82, 0x0A, 0xB9, 0x52, 0x80, 0xD9, 0xDF, 0x7F,
+    0x27, 0xF4, 0xA4, 0xC6, 0xF6, 0x98, 0x6C, 0x64, 0x12, 0xDB, 0x42, 0xB6, 0x16, 0xE9, 0x92, 0x25,
+    0x24, 0x81, 0x32, 0x9C, 0xBC, 0x0C, 0x8D, 0xB2, 0x06, 0x06, 0xD1, 0x0B, 0xE8, 0xA8, 0x26, 0x8A,
+    0x7B, 0xBE, 0x27, 0x02, 0xDC, 0x2D, 0x0D, 0xC6, 0x46, 0x8C, 0xB4, 0xEF, 0x80, 0x13, 0x2A, 0xBD,
+    0x06, 0x95, 0xB4, 0xEE, 0xC7, 0x35, 0x5C, 0x8C, 0x9A, 0x4D, 0x4C, 0x6C, 0x8F, 0x14, 0xD9, 0xED,
+    0x89, 0xC2, 0x3B, 0xD2, 0x26, 0xEE, 0x5A, 0x6F, 0x7F, 0xB1, 0xF9, 0x4C, 0x1B, 0x1C, 0x9F, 0x29,
+    0x18, 0x92, 0x14, 0x25, 0x35, 0xBA, 0x01, 0xFA, 0xAD, 0x5B, 0x98, 0x39, 0x69, 0xB8, 0x43, 0xCD,
+    0x68, 0xDD, 0xFA, 0x9E, 0x3A, 0x7F, 0xDC, 0xAE, 0xDD, 0x25, 0xF2, 0x9B, 0xB8, 0xB0, 0x17, 0xD2,
+    0x2A, 0x0E, 0xAE, 0x1A, 0x92, 0x47, 0x5B, 0x27, 0x8F, 0x71, 0x3A, 0x0D, 0x73, 0x25, 0x8D, 0xC4,
+    0x9B, 0x67, 0x99, 0x2D, 0x58, 0x69, 0x92, 0xE0, 0xC5, 0xAD, 0xFD, 0xA5, 0xB7, 0x1B, 0x72, 0x47,
+    0xD5, 0xCD, 0xB3, 0xE7, 0xCD, 0x50, 0xF2, 0xB0, 0x04, 0x23, 0x6E, 0x7B, 0xE3, 0x5E, 0x6F, 0x61,
+    0x7B, 0x5B, 0xD3, 0xA1, 0xF5, 0x03, 0x87, 0x8D, 0x09, 0x4E, 0xEE, 0x16, 0x82, 0x65, 0x32, 0x34,
+    0xC1, 0xEB, 0xF7, 0x2B, 0x7B, 0x52, 0x03, 0x67, 0x80, 0x60, 0x57, 0xF7, 0xFF, 0x3F, 0xBC, 0x05,
+    0x4E, 0x1A, 0x93, 0x1D, 0xAF, 0x3D, 0x98, 0xEA, 0x73, 0x64, 0x24, 0x4C, 0x13, 0x7F, 0xFA, 0xB6,
+    0x40, 0xA9, 0xB0, 0x7C, 0x3B, 0x2A, 0x31, 0x5A, 0xCF, 0x6D, 0x2D, 0x1D, 0x8F, 0x2D, 0x08, 0xAA,
+    0x86, 0x5B, 0x70, 0x2C, 0xCD, 0x16, 0xE2, 0x93, 0xB2, 0x91, 0x42, 0xCD, 0x7C, 0x7C, 0xC6, 0x5A,
+    0x85, 0xA0, 0xCD, 0x5C, 0xEE, 0x03, 0xFC, 0xAE, 0x51, 0x8D, 0x3B, 0xDA, 0x0E, 0x55, 0x50, 0xFF,
+    0x59, 0x12, 0x20, 0xCD, 0xDE, 0x8A, 0x70, 0x7E, 0x9F, 0x0C, 0xCA, 0x8B, 0x2E, 0x94, 0x1F, 0xF7,
+    0x9B, 0xD2, 0xC0, 0xFD, 0xD6, 0xF8, 0x1F, 0x1C, 0xC4, 0x8E, 0xB9, 0x83, 0x14, 0x00, 0x00,
+};
+
+/// Every static file, in the order they are registered
+static const WebPage web_pages[] =
+{
+    { "/", "text/html", page_index_html, sizeof (page_index_html) }
+};
+
+const size_t NUM_WEB_PAGES = sizeof (web_pages) / sizeof (web_pages[0]);
+
+#endif
@@ -0,0 +1,410 @@
+/** @file web_server.cpp
+ * This is the implementation file for the web server. Static pages are
+ * sent gzip-compressed straight from flash. Short dynamic replies are
+ * printed into a slot from the response pool in one go and sent from there.
+ * Long ones (the telemetry CSV and the trace) are chunked responses whose
+ * producer lives in a pool slot; each time the network can take more, at most
+ * @c WEB_CHUNK_BYTES of the reply are produced, so a large download is spread
+ * out in small pieces and can't hold the AsyncTCP task for long. No reply
+ * content is built on the heap.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <new>
+#include "web_server.h"
+#include "web_pages.h"
+#include "response_pool.h"
+#include "web_api.h"
+#include "task_config.h"
+#include "wifi_link.h"
+#include "boot_sequence.h"
+#include "core_load.h"
+#include "cpu_stats.h"
+#include "supervisor.h"
+#include "pipeline.h"
+#include "telemetry.h"
+#include "rolling_stats.h"
+#include "telemetry_stream.h"
+#include "trace_recorder.h"
+#include "logger.h"
+
+extern PipelineStats pipeline_stats;        ///< Latency of each pipeline stage, from main.cpp
+
+/** @brief   The web server object.
+ *  @details This server is responsible for responding to HTTP requests from
+ *           other computers, replying with useful information.
+*/
+AsyncWebServer web_server (WEB_PORT);
+
+
+/** @brief   Base class for replies which are produced a piece at a time.
+ *  @details A derived class fills the staging buffer with the next piece of
+ *           the reply; this class hands it to the network in whatever sizes
+ *           the network asks for.
+ */
+class ChunkedReport
+{
+    protected:
+        uint8_t staging[WEB_CHUNK_BYTES];   ///< The piece of the reply being sent
+        size_t staged;                      ///< Bytes in @c staging
+        size_t sent;                        ///< Bytes of @c staging already sent
+        bool more;                          ///< @c false once the last piece has been produced
+
+        /** @brief   Produce the next piece of the reply.
+         *  @param   out The buffer into which the piece is written
+         *  @returns @c true if there is more to come, @c false if this is the last piece
+        */
+        virtual bool fill (BufferPrint& out) = 0;
+
+    public:
+        ChunkedReport (void) : staged (0), sent (0), more (true) { }
+        virtual ~ChunkedReport (void) { }
+
+        /** @brief   Copy the next bytes of the reply for the network.
+         *  @param   buffer Where the bytes are copied
+         *  @param   max_length Most bytes the network can take now
+         *  @returns The number of bytes copied, or zero at the end of the reply
+        */
+        size_t read (uint8_t* buffer, size_t max_length)
+        {
+            TRACE_SCOPE ("http_chunk");
+            while (sent == staged && more)
+            {
+                BufferPrint out (staging, sizeof (staging));
+                more = fill (out);
+                staged = out.length ();
+                sent = 0;
+            }
+            size_t length = staged - sent;
+            if (length > max_length)
+            {
+                length = max_length;
+            }
+            memcpy (buffer, staging + sent, length);
+            sent += length;
+            return length;
+        }
+};
+
+/** @brief   Reply which sends the telemetry ring as CSV.
+ */
+class CsvReport : public ChunkedReport
+{
+    protected:
+        TelemetryCsvCursor cursor;          ///< Position in the ring
+
+        bool fill (BufferPrint& out) override { return telemetry_csv_chunk (cursor, out); }
+
+    public:
+        CsvReport (uint32_t from_ms, uint32_t to_ms, uint16_t points, DownsampleMethod method, TelemetryField field)
+        {
+            telemetry_csv_begin (cursor, from_ms, to_ms, points, method, field);
+        }
+};
+
+/** @brief   Reply which sends the history of one level of the rolling statistics as CSV.
+ */
+class TrendsReport : public ChunkedReport
+{
+    protected:
+        RollingCsvCursor cursor;            ///< Position in the history
+
+        bool fill (BufferPrint& out) override { return rolling_csv_chunk (cursor, out); }
+
+    public:
+        TrendsReport (RollingLevel level) { rolling_csv_begin (cursor, level); }
+};
+
+/** @brief   Reply which sends the trace ring as Chrome trace-event JSON.
+ *  @details Recording is paused until the reply is finished or abandoned.
+ */
+class TraceReport : public ChunkedReport
+{
+    protected:
+        TraceExportCursor cursor;           ///< Position in the trace
+
+        bool fill (BufferPrint& out) override { return trace_export_chunk (cursor, out); }
+
+    public:
+        TraceReport (void) { more = trace_export_begin (cursor); }
+        ~TraceReport (void) { trace_export_end (cursor); }
+        bool started (void) { return more; }    ///< Whether the export began; check before sending
+};
+
+static_assert (sizeof (CsvReport) <= RESPONSE_SLOT_BYTES, "CSV report doesn't fit a reply slot");
+static_assert (sizeof (TraceReport) <= RESPONSE_SLOT_BYTES, "Trace report doesn't fit a reply slot");
+static_assert (sizeof (TrendsReport) <= RESPONSE_SLOT_BYTES, "Trends report doesn't fit a reply slot");
+
+/** @brief   Destroy the chunked report kept in a reply slot.
+ *  @param   slot The slot being released
+ */
+static void destroy_report (ResponseSlot* slot)
+{
+    ((ChunkedReport*)slot->data)->~ChunkedReport ();
+}
+
+/** @brief   Claim a reply slot, or answer 503 if every slot is busy.
+ *  @details The slot is released when the client goes away.
+ *  @param   request The request being answered
+ *  @returns The slot, or @c NULL if the request has already been answered
+ */
+ResponseSlot* claim_slot (AsyncWebServerRequest* request)
+{
+    ResponseSlot* slot = response_acquire ();
+    if (slot == NULL)
+    {
+        request->send (503, "text/plain", "Busy");
+        return NULL;
+    }
+    request->onDisconnect ([slot] () { response_release (slot); });
+    return slot;
+}
+
+/** @brief   Send a reply produced a piece at a time.
+ *  @param   request The request being answered
+ *  @param   type MIME type of the reply
+ *  @param   slot The slot holding the object which produces the reply
+ */
+static void send_chunked (AsyncWebServerRequest* request, const char* type, ResponseSlot* slot)
+{
+    ChunkedReport* report = (ChunkedReport*)slot->data;
+    slot->cleanup = destroy_report;
+    request->send (request->beginChunkedResponse (type,
+        [report] (uint8_t* buffer, size_t max_length, size_t index) -> size_t
+        {
+            return report->read (buffer, max_length);
+        }));
+}
+
+/** @brief   Send a reply which has been rendered into a reply slot.
+ *  @details A reply which didn't fit is answered with an error rather than
+ *           sent cut short; one which exactly fills the slot is sent.
+ *  @param   request The request being answered
+ *  @param   code HTTP status code of the reply
+ *  @param   type MIME type of the reply
+ *  @param   out The printer which rendered the reply into the slot
+ */
+void send_slot (AsyncWebServerRequest* request, int code, const char* type, BufferPrint& out)
+{
+    if (out.overflowed ())
+    {
+        request->send (500, "text/plain", "Report too long");
+        return;
+    }
+    request->send (request->beginResponse_P (code, type, out.data (), out.length ()));
+}
+
+/** @brief   Send a short report, rendered into a reply slot.
+ *  @param   request The request being answered
+ *  @param   type MIME type of the report
+ *  @param   report The function which prints the report
+ */
+void send_report (AsyncWebServerRequest* request, const char* type, void (*report)(Print&))
+{
+    ResponseSlot* slot = claim_slot (request);
+    if (slot == NULL)
+    {
+        return;
+    }
+    BufferPrint out (slot->data, sizeof (slot->data));
+    report (out);
+    send_slot (request, 200, type, out);
+}
+
+/** @brief   Send one of the static files, which are stored gzip-compressed.
+ *  @param   request The request being answered
+ *  @param   page The file to be sent
+ */
+static void send_page (AsyncWebServerRequest* request, const WebPage* page)
+{
+    LOG_DEBUG (MOD_NET, FMT_HTTP_REQUEST, request->client ()->remoteIP ()[0], request->client ()->remoteIP ()[1],
+               request->client ()->remoteIP ()[2], request->client ()->remoteIP ()[3]);
+
+    AsyncWebServerResponse* response = request->beginResponse_P (200, page->type, page->data, page->length);
+    response->addHeader ("Content-Encoding", "gzip");
+    request->send (response);
+}
+
+/** @brief   Print the latency of each pipeline stage, for the web page.
+ *  @param   out The device to which the report is printed
+ */
+static void print_pipeline (Print& out)
+{
+    pipeline_stats.print (out);
+}
+
+/** @brief   Print the stack, heap and reply buffer usage, for the web page.
+ *  @param   out The device to which the report is printed
+ */
+static void print_memory (Print& out)
+{
+    task_report_memory (out);
+    response_pool_print (out);
+}
+
+/** @brief   Callback function that sends the trace ring as Chrome trace-event JSON.
+ *  @details The file can be opened in Perfetto or chrome://tracing. Only one
+ *           export can run at a time; another request gets a 409 reply.
+ *  @param   request The request being answered
+ */
+void handle_Trace (AsyncWebServerRequest* request)
+{
+    if (trace_export_running ())
+    {
+        request->send (409, "text/plain", "Trace export already running");
+        return;
+    }
+    ResponseSlot* slot = claim_slot (request);
+    if (slot == NULL)
+    {
+        return;
+    }
+    // Another export can still begin between the check and here, from the serial command
+    TraceReport* report = new (slot->data) TraceReport ();
+    if (!report->started ())
+    {
+        report->~TraceReport ();
+        request->send (409, "text/plain", "Trace export already running");
+        return;
+    }
+    send_chunked (request, "application/json", slot);
+}
+
+/** @brief   Callback function that sends recorded telemetry as a CSV file.
+ *  @details The window is chosen with the @c from and @c to arguments, in
+ *           milliseconds since boot, or with @c last for the most recent so many
+ *           milliseconds; with none of them, the whole ring is sent. With
+ *           @c points, at most that many records are sent, chosen by
+ *           @c method=lttb (the default) or @c method=minmax from the values of
+ *           @c field, which is @c angle unless another is given; see
+ *           downsample.h. For example, @c /csv?last=20000&points=400&method=minmax
+ *  @param   request The request being answered
+ */
+void handle_CSV (AsyncWebServerRequest* request)
+{
+    uint32_t from_ms = 0;
+    uint32_t to_ms = UINT32_MAX;
+    if (request->hasParam ("last"))
+    {
+        uint32_t now_ms = millis ();
+        uint32_t last_ms = request->getParam ("last")->value ().toInt ();
+        from_ms = last_ms < now_ms ? now_ms - last_ms : 0;
+    }
+    if (request->hasParam ("from"))
+    {
+        from_ms = request->getParam ("from")->value ().toInt ();
+    }
+    if (request->hasParam ("to"))
+    {
+        to_ms = request->getParam ("to")->value ().toInt ();
+    }
+    uint16_t points = 0;
+    DownsampleMethod method = DS_LTTB;
+    TelemetryField field = FIELD_ANGLE;
+    if (request->hasParam ("points"))
+    {
+        points = constrain (request->getParam ("points")->value ().toInt (), 0, (long)TELEMETRY_RING_SIZE);
+    }
+    if (request->hasParam ("method") && request->getParam ("method")->value () == "minmax")
+    {
+        method = DS_MINMAX;
+    }
+    if (request->hasParam ("field") && !downsample_field (request->getParam ("field")->value ().c_str (), field))
+    {
+        request->send (400, "text/plain", "Unknown field");
+        return;
+    }
+
+    ResponseSlot* slot = claim_slot (request);
+    if (slot)
+    {
+        new (slot->data) CsvReport (from_ms, to_ms, points, method, field);
+        send_chunked (request, "text/csv", slot);
+    }
+}
+
+/** @brief   Callback function that sends the history of the rolling statistics as CSV.
+ *  @details The level is chosen with the @c level argument, one of the names
+ *           in @c ROLLING_LEVELS such as @c 1min, which is the default.
+ *  @param   request The request being answered
+ */
+void handle_Trends (AsyncWebServerRequest* request)
+{
+    RollingLevel level = LEVEL_MINUTE;
+    if (request->hasParam ("level") && !rolling_stats_level (request->getParam ("level")->value ().c_str (), level))
+    {
+        request->send (400, "text/plain", "Unknown level");
+        return;
+    }
+
+    ResponseSlot* slot = claim_slot (request);
+    if (slot)
+    {
+        new (slot->data) TrendsReport (level);
+        send_chunked (request, "text/csv", slot);
+    }
+}
+
+/** @brief   Respond to a request for an HTTP page that doesn't exist.
+ *  @details This function produces the Error 404, Page Not Found error. 
+ *  @param   request The request being answered
+ */
+void handle_NotFound (AsyncWebServerRequest* request)
+{
+    request->send (404, "text/plain", "Not found");
+}
+
+/** @brief   Task which starts the web server and then samples CPU use.
+ *  @details The server handles requests by itself once it has been started,
+ *           so this task doesn't poll it. It starts the server as soon as the
+ *           network stack is up, without waiting for an access point, then
+ *           closes a CPU load window once a second.
+ *  @param   p_params Pointer to unused parameters
+ */
+void task_SERVER (void* p_params)
+{
+    boot_stage_begin (BOOT_SERVER);
+    wifi_wait_started ();
+
+    for (size_t index = 0; index < NUM_WEB_PAGES; index++)
+    {
+        const WebPage* page = &web_pages[index];
+        web_server.on (page->path, HTTP_GET, [page] (AsyncWebServerRequest* request) { send_page (request, page); });
+    }
+    web_server.on ("/load", HTTP_GET, [] (AsyncWebServerRequest* request) { send_report (request, "text/plain", core_load_print); });
+    web_server.on ("/latency", HTTP_GET, [] (AsyncWebServerRequest* request) { send_report (request, "text/plain", print_pipeline); });
+    web_server.on ("/memory", HTTP_GET, [] (AsyncWebServerRequest* request) { send_report (request, "text/plain", print_memory); });
+    web_server.on ("/stats", HTTP_GET, [] (AsyncWebServerRequest* request) { send_report (request, "application/json", cpu_stats_json); });
+    web_server.on ("/health", HTTP_GET, [] (AsyncWebServerRequest* request) { send_report (request, "text/plain", supervisor_print); });
+    web_server.on ("/boot", HTTP_GET, [] (AsyncWebServerRequest* request) { send_report (request, "text/plain", boot_print); });
+    web_server.on ("/trace", HTTP_GET, handle_Trace);
+    web_server.on ("/csv", HTTP_GET, handle_CSV);
+    web_server.on ("/trends.csv", HTTP_GET, handle_Trends);
+    stream_attach (web_server);
+    api_attach (web_server);
+    web_server.onNotFound (handle_NotFound);
+
+    // Get the web server running
+    web_server.begin ();
+    LOG_INFO (MOD_NET, FMT_HTTP_STARTED);
+    boot_stage_end (BOOT_SERVER);
+
+    // Requests are handled by the AsyncTCP task, which mustn't compete with control
+    TaskHandle_t tcp_task = xTaskGetHandle ("async_tcp");
+    if (tcp_task && xTaskGetAffinity (tcp_task) != NETWORK_CORE)
+    {
+        LOG_WARN (MOD_NET, FMT_WEB_CORE, (int)xTaskGetAffinity (tcp_task));
+    }
+
+    TickType_t last_wake = xTaskGetTickCount ();
+    for (;;)
+    {
+        vTaskDelayUntil (&last_wake, pdMS_TO_TICKS (STATS_PERIOD_MS));
+        task_woke (TASK_SERVER);
+        core_load_sample ();
+        cpu_stats_sample ();
+    }
+}
@@ -0,0 +1,36 @@
+/** @file web_server.h
+ * This is the header file for the web server. The server is event driven:
+ * requests are handled by the AsyncTCP task as they arrive, so no task has
+ * to wake up and poll for them, and several clients can be served at once.
+ * 
+ * The AsyncTCP task must run on the network core below the priority of the
+ * control tasks. Build with @c -DCONFIG_ASYNC_TCP_RUNNING_CORE=0 and
+ * @c -DCONFIG_ASYNC_TCP_PRIORITY=3 in the build flags; a warning is logged at
+ * start-up if it has been put anywhere else.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _WEB_SERVER_
+#define _WEB_SERVER_
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+#include "buffer_print.h"
+#include "response_pool.h"
+
+const uint16_t WEB_PORT = 80;               ///< TCP port of the web server
+const size_t WEB_CHUNK_BYTES = 512;         ///< Most bytes of a long reply produced per callback
+const uint32_t STATS_PERIOD_MS = 1000;      ///< Time between CPU load samples
+
+extern AsyncWebServer web_server;
+
+ResponseSlot* claim_slot (AsyncWebServerRequest* request);
+void send_slot (AsyncWebServerRequest* request, int code, const char* type, BufferPrint& out);
+void send_report (AsyncWebServerRequest* request, const char* type, void (*report)(Print&));
+void task_SERVER (void* p_params);
+
+#endif
@@ -0,0 +1,134 @@
+/** @file wifi_link.cpp
+ * This is the implementation file for the WiFi link task. WiFi events from
+ * the Arduino core set bits in an event group; the task sleeps on those bits
+ * and, when the link drops, waits an exponentially growing back-off before
+ * trying again so an absent access point costs almost no CPU time.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#include <WiFi.h>
+#include "wifi_link.h"
+#include "task_config.h"
+#include "logger.h"
+#include "boot_sequence.h"
+#include "mycerts.h"
+
+const uint32_t FIRST_BACKOFF_MS = 1000;     ///< Wait before the first retry
+const uint32_t MAX_BACKOFF_MS = 60000;      ///< Longest wait between retries
+const uint32_t CONNECT_TIMEOUT_MS = 15000;  ///< Give up on one attempt after this long
+
+const EventBits_t WIFI_STARTED = 1 << 0;    ///< Set once the WiFi driver and network stack are up
+const EventBits_t WIFI_UP = 1 << 1;         ///< Set while we have an IP address
+const EventBits_t WIFI_DOWN = 1 << 2;       ///< Set when the link drops
+
+static StaticEventGroup_t wifi_events_storage;      ///< Storage for the event group
+static EventGroupHandle_t wifi_events = xEventGroupCreateStatic (&wifi_events_storage);
+
+static uint32_t connect_count = 0;          ///< Times a connection has been made
+static uint32_t attempt_count = 0;          ///< Times a connection has been attempted
+static uint32_t backoff_ms = FIRST_BACKOFF_MS;  ///< Wait before the next retry
+
+
+/** @brief   Callback run by the Arduino core's event task for each WiFi event.
+ *  @param   event Which event happened
+*/
+static void wifi_event (arduino_event_id_t event)
+{
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+    {
+        xEventGroupClearBits (wifi_events, WIFI_DOWN);
+        xEventGroupSetBits (wifi_events, WIFI_UP);
+    }
+    else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED || event == ARDUINO_EVENT_WIFI_STA_LOST_IP)
+    {
+        xEventGroupClearBits (wifi_events, WIFI_UP);
+        xEventGroupSetBits (wifi_events, WIFI_DOWN);
+    }
+}
+
+/** @brief   Return @c true while the ESP32 is connected and has an IP address.
+*/
+bool wifi_connected (void)
+{
+    return (xEventGroupGetBits (wifi_events) & WIFI_UP) != 0;
+}
+
+/** @brief   Wait until the WiFi driver and network stack have been started.
+ *  @details Servers can be started once this returns, whether or not an access
+ *           point has been found yet.
+*/
+void wifi_wait_started (void)
+{
+    xEventGroupWaitBits (wifi_events, WIFI_STARTED, pdFALSE, pdTRUE, portMAX_DELAY);
+}
+
+/** @brief   Print the state of the WiFi link.
+ *  @param   out The device to which the report is printed
+*/
+void wifi_print (Print& out)
+{
+    if (wifi_connected ())
+    {
+        out << "WiFi connected at " << WiFi.localIP () << ", RSSI " << WiFi.RSSI () << " dBm";
+    }
+    else
+    {
+        out << "WiFi not connected, next retry in up to " << backoff_ms << " ms";
+    }
+    out << ", " << connect_count << " connections in " << attempt_count << " attempts" << endl;
+}
+
+/** @brief   Task which connects to the access point and reconnects when the link drops.
+ *  @details This task runs at low priority on the network core. The rest of
+ *           the system starts without waiting for it.
+ *  @param   p_params Pointer to unused parameters
+*/
+void task_WIFI (void* p_params)
+{
+    boot_stage_begin (BOOT_NETWORK);
+    WiFi.onEvent (wifi_event);
+    WiFi.mode (WIFI_STA);
+    WiFi.setAutoReconnect (false);      // This task does the reconnecting, with back-off
+    xEventGroupSetBits (wifi_events, WIFI_STARTED);
+    boot_stage_end (BOOT_NETWORK);
+    boot_stage_begin (BOOT_WIFI);
+
+    while (true)
+    {
+        task_woke (TASK_WIFI);
+        LOG_INFO (MOD_NET, FMT_WIFI_CONNECTING);
+        attempt_count++;
+        xEventGroupClearBits (wifi_events, WIFI_DOWN);
+        WiFi.begin (ssid, password);
+
+        EventBits_t bits = xEventGroupWaitBits (wifi_events, WIFI_UP | WIFI_DOWN, pdFALSE, pdFALSE,
+                                                pdMS_TO_TICKS (CONNECT_TIMEOUT_MS));
+        if (bits & WIFI_UP)
+        {
+            connect_count++;
+            backoff_ms = FIRST_BACKOFF_MS;
+            if (!boot_done (BOOT_WIFI))
+            {
+                boot_stage_end (BOOT_WIFI);
+            }
+            LOG_INFO (MOD_NET, FMT_WIFI_CONNECTED, WiFi.localIP ()[0], WiFi.localIP ()[1],
+                      WiFi.localIP ()[2], WiFi.localIP ()[3]);
+
+            // Sleep until the link drops
+            xEventGroupWaitBits (wifi_events, WIFI_DOWN, pdFALSE, pdTRUE, portMAX_DELAY);
+            LOG_WARN (MOD_NET, FMT_WIFI_LOST);
+        }
+        else
+        {
+            LOG_INFO (MOD_NET, FMT_WIFI_WAITING);
+        }
+
+        WiFi.disconnect ();
+        LOG_INFO (MOD_NET, FMT_WIFI_BACKOFF, backoff_ms);
+        vTaskDelay (pdMS_TO_TICKS (backoff_ms));
+        backoff_ms = backoff_ms * 2 > MAX_BACKOFF_MS ? MAX_BACKOFF_MS : backoff_ms * 2;
+    }
+}
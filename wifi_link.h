@@ -0,0 +1,22 @@
+/** @file wifi_link.h
+ * This is the header file for the WiFi link task, which brings the network
+ * up in the background and keeps reconnecting whenever the link drops, so
+ * nothing else has to wait for an access point.
+ * 
+ * @author agent
+ * @date 2026-Oct-17 
+ * 
+*/
+
+#ifndef _WIFI_LINK_
+#define _WIFI_LINK_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+
+bool wifi_connected (void);
+void wifi_wait_started (void);
+void wifi_print (Print& out);
+void task_WIFI (void* p_params);
+
+#endif